@@ -7,16 +7,42 @@ package main
 #cgo LDFLAGS: -L../.. -lsortbench_core_cgo -lstdc++ -fopenmp -ldl -ltbb -lm
 #include <stdlib.h>
 #include "../../include/sortbench/capi.h"
+
+extern void goSortbenchRow(uintptr_t user, char* row);
+static void sb_go_on_row(void* user, const char* row) { goSortbenchRow((uintptr_t)user, (char*)row); }
+static sb_observer sb_go_observer(uintptr_t h) {
+	sb_observer o = {0};
+	o.user = (void*)h;
+	o.on_row = sb_go_on_row;
+	return o;
+}
 */
 import "C"
 
 import (
+	"context"
 	"encoding/json"
 	"errors"
 	"fmt"
+	"runtime/cgo"
+	"sync"
 	"unsafe"
 )
 
+// One core session for the process: plugins stay loaded and generated inputs
+// are reused across requests (budget: SESSION_DATASET_MAX_BYTES)
+var (
+	sessionOnce sync.Once
+	session     *C.sb_session
+)
+
+func coreSession() *C.sb_session {
+	sessionOnce.Do(func() {
+		session = C.sb_session_new(C.uint64_t(sessionDatasetMaxBytes))
+	})
+	return session
+}
+
 // Indicates whether CGO core is available in this binary
 func cgoAvailable() bool { return true }
 
@@ -68,6 +94,16 @@ func distCode(d string) (int, error) {
         return int(C.SB_DIST_STAGGERED), nil
     case "runs_ht":
         return int(C.SB_DIST_RUNS_HT), nil
+    case "adversarial":
+        return int(C.SB_DIST_ADVERSARIAL), nil
+    case "sorted_tail":
+        return int(C.SB_DIST_SORTED_TAIL), nil
+    case "k_sorted":
+        return int(C.SB_DIST_K_SORTED), nil
+    case "clustered":
+        return int(C.SB_DIST_CLUSTERED), nil
+    case "block_shuffled":
+        return int(C.SB_DIST_BLOCK_SHUFFLED), nil
     }
     return 0, fmt.Errorf("invalid dist")
 }
@@ -113,9 +149,9 @@ func listAlgosCGO(typ string, plugins []string) ([]string, error) {
 	var errOut *C.char
 	var js *C.char
 	if cArr != nil {
-		js = C.sb_list_algos_json(C.int(tcode), cArr, C.int(len(plugins)), &errOut)
+		js = C.sb_session_list_algos_json(coreSession(), C.int(tcode), cArr, C.int(len(plugins)), &errOut)
 	} else {
-		js = C.sb_list_algos_json(C.int(tcode), nil, 0, &errOut)
+		js = C.sb_session_list_algos_json(coreSession(), C.int(tcode), nil, 0, &errOut)
 	}
 	if js == nil {
 		defer func() {
@@ -136,7 +172,11 @@ func listAlgosCGO(typ string, plugins []string) ([]string, error) {
 	return names, nil
 }
 
-func runCGO(req RunRequest) ([]byte, error) {
+// runCGO runs req in the core session. onRow (may be nil) receives each
+// algorithm's row as it finishes, without speedup_vs_baseline. When ctx ends
+// first the core stops at its next check and runCGO returns ctx.Err()
+// together with the rows finished so far.
+func runCGO(ctx context.Context, req RunRequest, onRow func(json.RawMessage)) ([]byte, error) {
 	tcode, err := elemTypeCode(req.Type)
 	if err != nil {
 		return nil, err
@@ -149,6 +189,8 @@ func runCGO(req RunRequest) ([]byte, error) {
 	defer freeAlgos()
 	cPluginsArr, freePlugins := makeCStrArray(req.Plugins)
 	defer freePlugins()
+	cIsolatedArr, freeIsolated := makeCStrArray(req.PluginsIsolated)
+	defer freeIsolated()
 	var cseed C.uint64_t
 	var hasSeed C.int
 	if req.Seed != nil {
@@ -191,14 +233,110 @@ func runCGO(req RunRequest) ([]byte, error) {
     if cPluginsArr != nil {
         cfg.plugin_paths = cPluginsArr
     }
+    if cIsolatedArr != nil {
+        cfg.isolated_plugin_paths = cIsolatedArr
+        cfg.isolated_plugin_len = C.int(len(req.PluginsIsolated))
+    }
     // Override defaults with provided values when >0
     if req.PartialPct > 0 { cfg.partial_shuffle_pct = C.int(req.PartialPct) }
     if req.DupValues > 0 { cfg.dup_values = C.int(req.DupValues) }
     if req.ZipfS > 0 { cfg.zipf_s = C.double(req.ZipfS) }
     if req.RunsAlpha > 0 { cfg.runs_alpha = C.double(req.RunsAlpha) }
     if req.StaggerBlock > 0 { cfg.stagger_block = C.int(req.StaggerBlock) }
+    if req.TailPct > 0 { cfg.tail_pct = C.int(req.TailPct) }
+    if req.DisplaceK > 0 { cfg.displace_k = C.int(req.DisplaceK) }
+    if req.Clusters > 0 { cfg.clusters = C.int(req.Clusters) }
+    if req.ShuffleBlock > 0 { cfg.shuffle_block = C.int(req.ShuffleBlock) }
+    if req.Adversary != "" {
+        ca := C.CString(req.Adversary)
+        defer C.free(unsafe.Pointer(ca))
+        cfg.adversary = ca
+    }
+    if req.Cpus != "" {
+        cc := C.CString(req.Cpus)
+        defer C.free(unsafe.Pointer(cc))
+        cfg.cpus = cc
+    }
+    cfg.spin_up = C.int(boolToInt(req.SpinUp))
+    switch req.Schedule {
+    case "round_robin":
+        cfg.schedule = C.SB_SCHEDULE_ROUND_ROBIN
+    case "shuffled":
+        cfg.schedule = C.SB_SCHEDULE_SHUFFLED
+    default:
+        cfg.schedule = C.SB_SCHEDULE_SEQUENTIAL
+    }
+    switch req.Buffers {
+    case "huge":
+        cfg.buffers = C.SB_BUFFERS_HUGE
+    case "prefault":
+        cfg.buffers = C.SB_BUFFERS_PREFAULT
+    default:
+        cfg.buffers = C.SB_BUFFERS_DEFAULT
+    }
+    switch req.Reset {
+    case "copy":
+        cfg.reset = C.SB_RESET_COPY
+    case "snapshot":
+        cfg.reset = C.SB_RESET_SNAPSHOT
+    case "parallel":
+        cfg.reset = C.SB_RESET_PARALLEL
+    default:
+        cfg.reset = C.SB_RESET_AUTO
+    }
+    switch req.Placement {
+    case "interleave":
+        cfg.placement = C.SB_PLACEMENT_INTERLEAVE
+    case "first_touch":
+        cfg.placement = C.SB_PLACEMENT_FIRST_TOUCH
+    default:
+        cfg.placement = C.SB_PLACEMENT_LOCAL
+    }
+    cfg.isolate = C.int(boolToInt(req.Isolate))
+    cfg.algo_timeout_ms = C.int(req.AlgoTimeoutMs)
+    if datasetCacheDir != "" {
+        cd := C.CString(datasetCacheDir)
+        defer C.free(unsafe.Pointer(cd))
+        cfg.cache_dir = cd
+        cfg.cache_max_bytes = C.uint64_t(datasetCacheMaxBytes)
+    }
+    cfg.analyze = C.int(boolToInt(req.Analyze))
+    if req.Input != "" {
+        ip := C.CString(inputPath(&req))
+        defer C.free(unsafe.Pointer(ip))
+        cfg.input_path = ip
+        cfg.input_offset = C.uint64_t(req.InputOffset)
+        cfg.input_sample = C.int(boolToInt(req.InputSample))
+    }
+	tok := C.sb_cancel_token_new()
+	if tok == nil {
+		return nil, errors.New("out of memory")
+	}
+	cfg.cancel = tok
+	runDone, watchDone := make(chan struct{}), make(chan struct{})
+	go func() {
+		defer close(watchDone)
+		select {
+		case <-ctx.Done():
+			C.sb_cancel(tok)
+		case <-runDone:
+		}
+	}()
+	defer func() {
+		close(runDone)
+		<-watchDone
+		C.sb_cancel_token_free(tok)
+	}()
 	var errOut *C.char
-	out := C.sb_run_json(&cfg, 0, 1, &errOut)
+	var out *C.char
+	if onRow != nil {
+		h := cgo.NewHandle(onRow)
+		defer h.Delete()
+		obs := C.sb_go_observer(C.uintptr_t(h))
+		out = C.sb_session_run_json_observed(coreSession(), &cfg, &obs, 0, 1, &errOut)
+	} else {
+		out = C.sb_session_run_json(coreSession(), &cfg, 0, 1, &errOut)
+	}
 	if out == nil {
 		defer func() {
 			if errOut != nil {
@@ -212,6 +350,9 @@ func runCGO(req RunRequest) ([]byte, error) {
 	}
 	defer C.sb_free(out)
 	s := C.GoString(out)
+	if ctx.Err() != nil {
+		return []byte(s), ctx.Err()
+	}
 	return []byte(s), nil
 }
 
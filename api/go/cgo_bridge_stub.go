@@ -3,6 +3,8 @@
 package main
 
 import (
+    "context"
+    "encoding/json"
     "errors"
 )
 
@@ -12,7 +14,7 @@ func listAlgosCGO(typ string, plugins []string) ([]string, error) {
 }
 
 // runCGO is a stub used when the CGO core is not built.
-func runCGO(req RunRequest) ([]byte, error) {
+func runCGO(ctx context.Context, req RunRequest, onRow func(json.RawMessage)) ([]byte, error) {
     return nil, errors.New("cgo core not enabled; build with -tags sortbench_cgo")
 }
 
@@ -0,0 +1,22 @@
+//go:build cgo && sortbench_cgo
+
+package main
+
+// Row callback for sb_observer. Kept apart from cgo_bridge_cgo.go because a
+// file with //export may only declare C functions in its preamble.
+
+/*
+#include <stdint.h>
+*/
+import "C"
+
+import (
+	"encoding/json"
+	"runtime/cgo"
+)
+
+//export goSortbenchRow
+func goSortbenchRow(user C.uintptr_t, row *C.char) {
+	onRow := cgo.Handle(user).Value().(func(json.RawMessage))
+	onRow(json.RawMessage(C.GoString(row)))
+}
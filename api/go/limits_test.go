@@ -1,9 +1,11 @@
 package main
 
 import (
+    "context"
     "net/http"
     "net/http/httptest"
     "testing"
+    "time"
 )
 
 func TestLimits(t *testing.T) {
@@ -16,3 +18,26 @@ func TestLimits(t *testing.T) {
     if resp.StatusCode != 200 { t.Fatalf("unexpected status: %d", resp.StatusCode) }
 }
 
+
+func TestCPUSetPool(t *testing.T) {
+    defer initCPUSetPool("")
+    initCPUSetPool("0-1; bad ;2")
+    if len(jobCPUSets) != 2 { t.Fatalf("want 2 cpusets, got %v", jobCPUSets) }
+    var a, b RunRequest
+    relA, err := acquireCPUSet(context.Background(), &a)
+    if err != nil { t.Fatal(err) }
+    relB, err := acquireCPUSet(context.Background(), &b)
+    if err != nil { t.Fatal(err) }
+    if a.Cpus == "" || b.Cpus == "" || a.Cpus == b.Cpus { t.Fatalf("cpusets not exclusive: %q %q", a.Cpus, b.Cpus) }
+    // Pool exhausted: a third acquire waits until the context ends
+    ctx, cancel := context.WithTimeout(context.Background(), 20*time.Millisecond)
+    defer cancel()
+    var c RunRequest
+    if _, err := acquireCPUSet(ctx, &c); err == nil { t.Fatal("expected timeout on exhausted pool") }
+    relA(); relB()
+    // Explicit cpus bypass the pool
+    d := RunRequest{Cpus: "3"}
+    rel, _ := acquireCPUSet(context.Background(), &d)
+    rel()
+    if d.Cpus != "3" { t.Fatalf("explicit cpus overwritten: %q", d.Cpus) }
+}
@@ -16,6 +16,7 @@ import (
     "os/exec"
     "os/signal"
     "path/filepath"
+    "regexp"
     "strconv"
     "strings"
     "sync"
@@ -37,6 +38,13 @@ var (
     maxJobs          = 64  // concurrent async jobs cap
     defaultTimeout   = 2 * time.Minute
     workerCount      = 4
+    // Dataset cache shared by all runs (DATASET_CACHE_DIR / _MAX_BYTES)
+    datasetCacheDir      = ""
+    datasetCacheMaxBytes uint64
+    // Directory that request "input" names resolve under (INPUT_DIR); empty = disabled
+    inputDir = ""
+    // In-process (cgo) core: memory budget for generated inputs kept between runs
+    sessionDatasetMaxBytes uint64 = 1 << 30
 )
 
 //go:embed static
@@ -74,6 +82,8 @@ type RunRequest struct {
     Assert    bool     `json:"assert_sorted,omitempty"`
     Baseline  *string  `json:"baseline,omitempty"`
     Plugins   []string `json:"plugins,omitempty"`
+    // Plugins loaded by a sortbench-plugin-host process instead of the core
+    PluginsIsolated []string `json:"plugins_isolated,omitempty"`
     TimeoutMs int      `json:"timeout_ms,omitempty"`
     // Distribution tunables
     PartialPct   int     `json:"partial_shuffle_pct,omitempty"`
@@ -81,6 +91,31 @@ type RunRequest struct {
     ZipfS        float64 `json:"zipf_s,omitempty"`
     RunsAlpha    float64 `json:"runs_alpha,omitempty"`
     StaggerBlock int     `json:"stagger_block,omitempty"`
+    Adversary    string  `json:"adversary,omitempty"` // sort targeted by dist=adversarial
+    TailPct      int     `json:"tail_pct,omitempty"`
+    DisplaceK    int     `json:"displace_k,omitempty"`
+    Clusters     int     `json:"clusters,omitempty"`
+    ShuffleBlock int     `json:"shuffle_block,omitempty"`
+    // CPU placement
+    Cpus   string `json:"cpus,omitempty"`    // e.g. "2-5,8"; empty = inherit (or job pool)
+    SpinUp bool   `json:"spin_up,omitempty"` // spin until clock is stable before timing
+    // Repeat order across algorithms: sequential (default), round_robin, shuffled
+    Schedule string `json:"schedule,omitempty"`
+    // Input/work buffer backing: default, huge (2MB pages), prefault
+    Buffers string `json:"buffers,omitempty"`
+    // Work buffer restore before each run: auto, copy, parallel (streaming), snapshot (memfd copy-on-write)
+    Reset string `json:"reset,omitempty"`
+    // Work buffer NUMA placement: local (default), interleave, first_touch
+    Placement string `json:"placement,omitempty"`
+    // Crash/hang isolation: one forked child per algorithm
+    Isolate       bool `json:"isolate,omitempty"`
+    AlgoTimeoutMs int  `json:"algo_timeout_ms,omitempty"` // implies isolate
+    // Input file under INPUT_DIR instead of the generated dist
+    Input       string `json:"input,omitempty"`
+    InputOffset uint64 `json:"input_offset,omitempty"`
+    InputSample bool   `json:"input_sample,omitempty"`
+    // Input profile (runs, inversions, distinct, entropy) as input_* meta
+    Analyze bool `json:"analyze,omitempty"`
 }
 
 type errorResp struct {
@@ -133,7 +168,7 @@ func sbPath() string {
 
 func types() []string { return []string{"i32", "u32", "i64", "u64", "f32", "f64", "str"} }
 func dists() []string {
-	return []string{"random", "partial", "dups", "reverse", "sorted", "saw", "runs", "gauss", "exp", "zipf", "organpipe", "staggered", "runs_ht"}
+	return []string{"random", "partial", "dups", "reverse", "sorted", "saw", "runs", "gauss", "exp", "zipf", "organpipe", "staggered", "runs_ht", "adversarial", "sorted_tail", "k_sorted", "clustered", "block_shuffled"}
 }
 
 func metaHandler(w http.ResponseWriter, r *http.Request) {
@@ -187,6 +222,7 @@ type LimitsResponse struct {
     TrustXFF      bool    `json:"trust_xff"`
     Mode          string  `json:"mode"` // shell|cgo
     DBEnabled     bool    `json:"db_enabled"`
+    JobCPUSets    []string `json:"job_cpusets,omitempty"`
 }
 
 func limitsHandler(w http.ResponseWriter, r *http.Request) {
@@ -204,6 +240,7 @@ func limitsHandler(w http.ResponseWriter, r *http.Request) {
         TrustXFF: trustXFF,
         Mode: mode,
         DBEnabled: useDB,
+        JobCPUSets: jobCPUSets,
     })
 }
 
@@ -256,22 +293,12 @@ func runHandler(w http.ResponseWriter, r *http.Request) {
 	}
 	ctx, cancel := context.WithTimeout(r.Context(), tout)
 	defer cancel()
-    if os.Getenv("SORTBENCH_CGO") == "1" && cgoAvailable() {
+    if inProcess(&req) {
         // In CGO mode, drop any plugin paths that do not exist to avoid
         // dlopen of invalid paths inside the C++ core.
-        if len(req.Plugins) > 0 {
-            filtered := make([]string, 0, len(req.Plugins))
-            for _, p := range req.Plugins {
-                if p == "" { continue }
-                if fi, err := os.Stat(p); err == nil && !fi.IsDir() {
-                    filtered = append(filtered, p)
-                } else {
-                    slog.Warn("plugin_skip_missing", "path", p)
-                }
-            }
-            req.Plugins = filtered
-        }
-        out, err := runCGO(req)
+        req.Plugins = existingPlugins(req.Plugins)
+        req.PluginsIsolated = existingPlugins(req.PluginsIsolated)
+        out, err := runCGO(ctx, req, nil)
         if err != nil {
             writeJSON(w, 500, errorResp{Error: err.Error()})
             slog.Error("run_failed", "mode", "cgo", "error", err.Error(), "N", req.N, "dist", req.Dist, "type", req.Type, "repeats", req.Repeats, "threads", req.Threads, "duration_ms", time.Since(start).Milliseconds())
@@ -418,6 +445,9 @@ type Job struct {
     Status     JobStatus       `json:"status"`
     Error      string          `json:"error,omitempty"`
     ResultJSON json.RawMessage `json:"result,omitempty"`
+    // Rows finished so far while running (CGO core only); dropped once the
+    // full result, with speedups, is in
+    Partial    []json.RawMessage `json:"partial,omitempty"`
     CreatedAt  time.Time       `json:"created_at"`
     StartedAt  time.Time       `json:"started_at,omitempty"`
     FinishedAt time.Time       `json:"finished_at,omitempty"`
@@ -426,6 +456,37 @@ type Job struct {
     mu         sync.Mutex
 }
 
+// Optional cpuset pool for async jobs (JOB_CPUSETS="0-3;4-7"). Each running
+// job holds one set exclusively so concurrent jobs never share cores.
+var (
+    jobCPUSets []string
+    cpusetPool chan string
+)
+
+func initCPUSetPool(spec string) {
+    jobCPUSets = nil
+    for _, s := range strings.Split(spec, ";") {
+        s = strings.TrimSpace(s)
+        if s != "" && cpuListRe.MatchString(s) { jobCPUSets = append(jobCPUSets, s) }
+    }
+    if len(jobCPUSets) == 0 { cpusetPool = nil; return }
+    cpusetPool = make(chan string, len(jobCPUSets))
+    for _, s := range jobCPUSets { cpusetPool <- s }
+}
+
+// acquireCPUSet pins req to a pooled cpuset unless the caller chose one.
+// The returned release func must always be called.
+func acquireCPUSet(ctx context.Context, req *RunRequest) (func(), error) {
+    if cpusetPool == nil || req.Cpus != "" { return func() {}, nil }
+    select {
+    case s := <-cpusetPool:
+        req.Cpus = s
+        return func() { cpusetPool <- s }, nil
+    case <-ctx.Done():
+        return func() {}, ctx.Err()
+    }
+}
+
 type JobManager struct { m map[string]*Job; mu sync.RWMutex }
 
 var jobs = &JobManager{m: make(map[string]*Job)}
@@ -567,7 +628,10 @@ func workerLoop(ctx context.Context) {
         runCtx, cancel := context.WithTimeout(ctx, defaultTimeout)
         runningMu.Lock(); running[id] = cancel; runningMu.Unlock()
         start := time.Now()
-        out, execErr := execRun(runCtx, rr)
+        release, execErr := acquireCPUSet(runCtx, &rr)
+        var out []byte
+        if execErr == nil { out, execErr = execRun(runCtx, rr) }
+        release()
         dur := time.Since(start).Milliseconds()
         runningMu.Lock(); delete(running, id); runningMu.Unlock()
         workersBusyGauge.Dec()
@@ -575,7 +639,9 @@ func workerLoop(ctx context.Context) {
         if execErr != nil {
             status := "failed"
             if runCtx.Err() != nil { status = "canceled" }
-            _, _ = db.ExecContext(ctx, `UPDATE jobs SET status=$2, error=$3, finished_at=now(), duration_ms=$4 WHERE id=$1`, id, status, execErr.Error(), dur)
+            var partial []byte
+            if len(out) > 0 { partial = out } // rows finished before a cgo run was canceled
+            _, _ = db.ExecContext(ctx, `UPDATE jobs SET status=$2, error=$3, result_json=$5, finished_at=now(), duration_ms=$4 WHERE id=$1`, id, status, execErr.Error(), dur, partial)
             jobsCompleted.WithLabelValues(status).Inc(); continue
         }
         _, _ = db.ExecContext(ctx, `UPDATE jobs SET status='done', result_json=$2, finished_at=now(), duration_ms=$3 WHERE id=$1`, id, out, dur)
@@ -624,10 +690,14 @@ func submitJobHandler(w http.ResponseWriter, r *http.Request) {
         }
         jobsRunningGauge.Inc()
         var out []byte
-        var err error
-		if os.Getenv("SORTBENCH_CGO") == "1" && cgoAvailable() {
-			out, err = runCGO(req)
-		} else {
+        // Wait for an exclusive cpuset when a pool is configured
+        release, err := acquireCPUSet(ctx, &req)
+        defer release()
+		if err == nil && inProcess(&req) {
+			out, err = runCGO(ctx, req, func(row json.RawMessage) {
+				job.mu.Lock(); job.Partial = append(job.Partial, row); job.mu.Unlock()
+			})
+		} else if err == nil {
 			args := buildArgs(&req)
 			cmd := exec.CommandContext(ctx, sbPath(), args...)
 			out, err = cmd.Output()
@@ -642,7 +712,10 @@ func submitJobHandler(w http.ResponseWriter, r *http.Request) {
         defer jobsRunningGauge.Dec()
         if err != nil {
             if ctx.Err() == context.Canceled || ctx.Err() == context.DeadlineExceeded {
-                job.mu.Lock(); job.Status = JobCanceled; job.Error = ctx.Err().Error(); job.mu.Unlock()
+                // The cgo core stops early and returns the rows it finished
+                job.mu.Lock(); job.Status = JobCanceled; job.Error = ctx.Err().Error()
+                if len(out) > 0 { job.ResultJSON = json.RawMessage(out); job.Partial = nil }
+                job.mu.Unlock()
                 jobsCompleted.WithLabelValues("canceled").Inc(); jobsDuration.WithLabelValues("canceled").Observe(float64(job.DurationMs) / 1000.0)
                 slog.Warn("job_canceled", "job_id", id, "duration_ms", job.DurationMs)
             } else {
@@ -652,7 +725,7 @@ func submitJobHandler(w http.ResponseWriter, r *http.Request) {
             }
             return
         }
-        job.mu.Lock(); job.ResultJSON = json.RawMessage(out); job.Status = JobDone; job.mu.Unlock()
+        job.mu.Lock(); job.ResultJSON = json.RawMessage(out); job.Partial = nil; job.Status = JobDone; job.mu.Unlock()
         jobsCompleted.WithLabelValues("done").Inc(); jobsDuration.WithLabelValues("done").Observe(float64(job.DurationMs) / 1000.0)
         slog.Info("job_done", "job_id", id, "duration_ms", job.DurationMs)
     }()
@@ -705,6 +778,7 @@ func getJobHandler(w http.ResponseWriter, r *http.Request) {
             Status     JobStatus       `json:"status"`
             Error      string          `json:"error,omitempty"`
             ResultJSON json.RawMessage `json:"result,omitempty"`
+            Partial    []json.RawMessage `json:"partial,omitempty"`
             CreatedAt  time.Time       `json:"created_at"`
             StartedAt  time.Time       `json:"started_at,omitempty"`
             FinishedAt time.Time       `json:"finished_at,omitempty"`
@@ -714,6 +788,7 @@ func getJobHandler(w http.ResponseWriter, r *http.Request) {
             Status: j.Status,
             Error: j.Error,
             ResultJSON: j.ResultJSON,
+            Partial: append([]json.RawMessage(nil), j.Partial...),
             CreatedAt: j.CreatedAt,
             StartedAt: j.StartedAt,
             FinishedAt: j.FinishedAt,
@@ -784,9 +859,66 @@ func validate(req *RunRequest) error {
 	if !okType {
 		return fmt.Errorf("invalid type")
 	}
+	switch req.Schedule {
+	case "", "sequential", "round_robin", "shuffled":
+	default:
+		return fmt.Errorf("invalid schedule (sequential|round_robin|shuffled)")
+	}
+	switch req.Buffers {
+	case "", "default", "huge", "prefault":
+	default:
+		return fmt.Errorf("invalid buffers (default|huge|prefault)")
+	}
+	switch req.Reset {
+	case "", "auto", "copy", "parallel", "snapshot":
+	default:
+		return fmt.Errorf("invalid reset (auto|copy|parallel|snapshot)")
+	}
+	switch req.Placement {
+	case "", "local", "interleave", "first_touch":
+	default:
+		return fmt.Errorf("invalid placement (local|interleave|first_touch)")
+	}
+	if req.Reset == "snapshot" && req.Placement != "" && req.Placement != "local" {
+		return fmt.Errorf("snapshot reset requires local placement")
+	}
+	if req.AlgoTimeoutMs < 0 {
+		return fmt.Errorf("algo_timeout_ms must be >= 0")
+	}
+	if len(req.PluginsIsolated) > 0 && req.Type == "str" {
+		return fmt.Errorf("plugins_isolated supports numeric types only")
+	}
+	if len(req.PluginsIsolated) > 0 && req.Reset == "snapshot" {
+		return fmt.Errorf("snapshot reset cannot be used with plugins_isolated")
+	}
+	if (req.Isolate || req.AlgoTimeoutMs > 0) && req.Schedule != "" && req.Schedule != "sequential" {
+		return fmt.Errorf("isolate requires the sequential schedule")
+	}
+	if req.Adversary != "" && !algoNameRe.MatchString(req.Adversary) {
+		return fmt.Errorf("invalid adversary")
+	}
+	if req.Cpus != "" && !cpuListRe.MatchString(req.Cpus) {
+		return fmt.Errorf("invalid cpus (expected list like 0-3,8)")
+	}
+	if req.Input != "" {
+		if inputDir == "" {
+			return fmt.Errorf("input files are disabled (INPUT_DIR unset)")
+		}
+		if !filepath.IsLocal(req.Input) {
+			return fmt.Errorf("input must be a relative path inside INPUT_DIR")
+		}
+	} else if req.InputOffset > 0 || req.InputSample {
+		return fmt.Errorf("input_offset/input_sample require input")
+	}
 	return nil
 }
 
+// Server path of a validated request input
+func inputPath(req *RunRequest) string { return filepath.Join(inputDir, req.Input) }
+
+var algoNameRe = regexp.MustCompile(`^[A-Za-z0-9_]+$`)
+var cpuListRe = regexp.MustCompile(`^[0-9]+(-[0-9]+)?(,[0-9]+(-[0-9]+)?)*$`)
+
 func buildArgs(req *RunRequest) []string {
     args := []string{"--N", strconv.FormatInt(req.N, 10), "--dist", req.Dist, "--type", req.Type, "--format", "json"}
     if req.Repeats > 0 {
@@ -804,11 +936,35 @@ func buildArgs(req *RunRequest) []string {
     if req.ZipfS > 0 { args = append(args, "--zipf-s", strconv.FormatFloat(req.ZipfS, 'f', -1, 64)) }
     if req.RunsAlpha > 0 { args = append(args, "--runs-alpha", strconv.FormatFloat(req.RunsAlpha, 'f', -1, 64)) }
     if req.StaggerBlock > 0 { args = append(args, "--stagger-block", strconv.Itoa(req.StaggerBlock)) }
+    if req.Adversary != "" { args = append(args, "--adversary", req.Adversary) }
+    if req.TailPct > 0 { args = append(args, "--tail-pct", strconv.Itoa(req.TailPct)) }
+    if req.DisplaceK > 0 { args = append(args, "--displace-k", strconv.Itoa(req.DisplaceK)) }
+    if req.Clusters > 0 { args = append(args, "--clusters", strconv.Itoa(req.Clusters)) }
+    if req.ShuffleBlock > 0 { args = append(args, "--shuffle-block", strconv.Itoa(req.ShuffleBlock)) }
     if len(req.Algos) > 0 {
         args = append(args, "--algo", strings.Join(req.Algos, ","))
     }
     if req.Threads > 0 {
         args = append(args, "--threads", strconv.Itoa(req.Threads))
+    }
+    if req.Cpus != "" { args = append(args, "--cpus", req.Cpus) }
+    if req.SpinUp { args = append(args, "--spin-up") }
+    if req.Schedule != "" { args = append(args, "--schedule", req.Schedule) }
+    if req.Buffers != "" { args = append(args, "--buffers", req.Buffers) }
+    if req.Reset != "" { args = append(args, "--reset", req.Reset) }
+    if req.Placement != "" { args = append(args, "--placement", req.Placement) }
+    if req.Isolate { args = append(args, "--isolate") }
+    if req.AlgoTimeoutMs > 0 { args = append(args, "--algo-timeout-ms", strconv.Itoa(req.AlgoTimeoutMs)) }
+    if req.Analyze { args = append(args, "--analyze") }
+    if req.Input != "" {
+        args = append(args, "--input", inputPath(req))
+        if req.InputOffset > 0 { args = append(args, "--input-offset", strconv.FormatUint(req.InputOffset, 10)) }
+        if req.InputSample { args = append(args, "--input-sample") }
+    }
+    // Server-side dataset cache (not request-controlled)
+    if datasetCacheDir != "" {
+        args = append(args, "--cache-dir", datasetCacheDir)
+        if datasetCacheMaxBytes > 0 { args = append(args, "--cache-max-bytes", strconv.FormatUint(datasetCacheMaxBytes, 10)) }
     }
 	if req.Assert {
 		args = append(args, "--assert-sorted")
@@ -821,11 +977,41 @@ func buildArgs(req *RunRequest) []string {
 			args = append(args, "--plugin", p)
 		}
 	}
+	for _, p := range req.PluginsIsolated {
+		if p != "" {
+			args = append(args, "--plugin-isolated", p)
+		}
+	}
 	// Always suppress file writes in API mode
 	args = append(args, "--no-file")
 	return args
 }
 
+// inProcess reports whether req runs in the cgo core. Isolated runs fork,
+// which the core refuses while other runs share the process and which is
+// unsafe in a multithreaded Go process anyway, so they always go through the
+// sortbench subprocess and can run alongside cgo runs.
+func inProcess(req *RunRequest) bool {
+    return os.Getenv("SORTBENCH_CGO") == "1" && cgoAvailable() && !req.Isolate && req.AlgoTimeoutMs <= 0
+}
+
+// Plugin paths that name existing files; the others are logged and dropped
+func existingPlugins(paths []string) []string {
+    if len(paths) == 0 {
+        return paths
+    }
+    filtered := make([]string, 0, len(paths))
+    for _, p := range paths {
+        if p == "" { continue }
+        if fi, err := os.Stat(p); err == nil && !fi.IsDir() {
+            filtered = append(filtered, p)
+        } else {
+            slog.Warn("plugin_skip_missing", "path", p)
+        }
+    }
+    return filtered
+}
+
 func healthHandler(w http.ResponseWriter, r *http.Request) {
     w.WriteHeader(200)
     _, _ = w.Write([]byte("ok"))
@@ -853,7 +1039,7 @@ func readyHandler(w http.ResponseWriter, r *http.Request) {
     for _, d := range smallDists {
         req := RunRequest{N: 128, Dist: d, Type: "i32", Repeats: 1, Algos: []string{"std_sort"}, TimeoutMs: 5000}
         if os.Getenv("SORTBENCH_CGO") == "1" {
-            if _, err := runCGO(req); err != nil {
+            if _, err := runCGO(r.Context(), req, nil); err != nil {
                 writeJSON(w, 500, errorResp{Error: "smoke run failed: " + err.Error()})
                 return
             }
@@ -914,7 +1100,7 @@ func requireAPIKey(next http.Handler) http.Handler {
 
 // Execute a run and return JSON bytes
 func execRun(ctx context.Context, req RunRequest) ([]byte, error) {
-    if os.Getenv("SORTBENCH_CGO") == "1" && cgoAvailable() { return runCGO(req) }
+    if inProcess(&req) { return runCGO(ctx, req, nil) }
     args := buildArgs(&req)
     cmd := exec.CommandContext(ctx, sbPath(), args...)
     out, err := cmd.Output()
@@ -991,6 +1177,24 @@ func main() {
         if n, err := strconv.Atoi(v); err == nil && n > 0 { defaultTimeout = time.Duration(n) * time.Millisecond }
     }
     if v := os.Getenv("WORKERS"); v != "" { if n, err := strconv.Atoi(v); err == nil && n > 0 { workerCount = n } }
+    if v := os.Getenv("DATASET_CACHE_DIR"); v != "" {
+        datasetCacheDir = v
+        if m := os.Getenv("DATASET_CACHE_MAX_BYTES"); m != "" {
+            if n, err := strconv.ParseUint(m, 10, 64); err == nil { datasetCacheMaxBytes = n }
+        }
+        slog.Info("dataset_cache", "dir", datasetCacheDir, "max_bytes", datasetCacheMaxBytes)
+    }
+    if v := os.Getenv("SESSION_DATASET_MAX_BYTES"); v != "" {
+        if n, err := strconv.ParseUint(v, 10, 64); err == nil { sessionDatasetMaxBytes = n }
+    }
+    if v := os.Getenv("INPUT_DIR"); v != "" {
+        inputDir = v
+        slog.Info("input_dir", "dir", inputDir)
+    }
+    if v := os.Getenv("JOB_CPUSETS"); v != "" {
+        initCPUSetPool(v)
+        slog.Info("job_cpusets", "sets", strings.Join(jobCPUSets, ";"))
+    }
     loadAPIKeys()
     apiKeysMu.RLock(); keyCount := len(apiKeys); apiKeysMu.RUnlock()
     slog.Info("api_keys_loaded", "count", keyCount)
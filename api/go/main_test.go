@@ -5,6 +5,8 @@ import (
 	"encoding/json"
 	"net/http"
 	"net/http/httptest"
+	"strings"
+	"sync"
 	"testing"
 )
 
@@ -58,7 +60,7 @@ func TestRunSmall(t *testing.T) {
 func TestDistsIncludesNewOnes(t *testing.T) {
     have := map[string]bool{}
     for _, d := range dists() { have[d] = true }
-    want := []string{"organpipe", "staggered", "runs_ht"}
+    want := []string{"organpipe", "staggered", "runs_ht", "adversarial", "sorted_tail", "k_sorted", "clustered", "block_shuffled"}
     for _, w := range want {
         if !have[w] {
             t.Fatalf("missing dist %q in dists()", w)
@@ -74,3 +76,170 @@ func TestValidateAcceptsNewDists(t *testing.T) {
         }
     }
 }
+
+func TestValidateSchedule(t *testing.T) {
+    for _, s := range []string{"", "sequential", "round_robin", "shuffled"} {
+        req := RunRequest{N: 16, Dist: "random", Type: "i32", Schedule: s}
+        if err := validate(&req); err != nil {
+            t.Fatalf("validate rejected schedule %q: %v", s, err)
+        }
+    }
+    req := RunRequest{N: 16, Dist: "random", Type: "i32", Schedule: "bogus"}
+    if err := validate(&req); err == nil {
+        t.Fatal("validate accepted invalid schedule")
+    }
+}
+
+func TestValidateBuffers(t *testing.T) {
+    for _, b := range []string{"", "default", "huge", "prefault"} {
+        req := RunRequest{N: 16, Dist: "random", Type: "i32", Buffers: b}
+        if err := validate(&req); err != nil {
+            t.Fatalf("validate rejected buffers %q: %v", b, err)
+        }
+    }
+    req := RunRequest{N: 16, Dist: "random", Type: "i32", Buffers: "tmpfs"}
+    if err := validate(&req); err == nil {
+        t.Fatal("validate accepted invalid buffers")
+    }
+}
+
+func TestValidateReset(t *testing.T) {
+    req := RunRequest{N: 16, Dist: "random", Type: "i32", Reset: "snapshot"}
+    if err := validate(&req); err != nil {
+        t.Fatalf("validate rejected reset: %v", err)
+    }
+    if args := strings.Join(buildArgs(&req), " "); !strings.Contains(args, "--reset snapshot") {
+        t.Fatalf("args missing --reset: %s", args)
+    }
+    req.Reset = "zero"
+    if err := validate(&req); err == nil {
+        t.Fatal("validate accepted invalid reset")
+    }
+    req = RunRequest{N: 16, Dist: "random", Type: "i32", Reset: "parallel", Placement: "first_touch"}
+    if err := validate(&req); err != nil {
+        t.Fatalf("validate rejected placement: %v", err)
+    }
+    if args := strings.Join(buildArgs(&req), " "); !strings.Contains(args, "--placement first_touch") {
+        t.Fatalf("args missing --placement: %s", args)
+    }
+    req.Reset = "snapshot"
+    if err := validate(&req); err == nil {
+        t.Fatal("validate accepted snapshot with first_touch")
+    }
+}
+
+func TestIsolateArgs(t *testing.T) {
+    req := RunRequest{N: 16, Dist: "random", Type: "i32", AlgoTimeoutMs: 250}
+    if err := validate(&req); err != nil {
+        t.Fatalf("validate: %v", err)
+    }
+    args := strings.Join(buildArgs(&req), " ")
+    if !strings.Contains(args, "--algo-timeout-ms 250") {
+        t.Fatalf("missing --algo-timeout-ms in %q", args)
+    }
+    req.Schedule = "shuffled"
+    if err := validate(&req); err == nil {
+        t.Fatal("validate accepted isolate with shuffled schedule")
+    }
+}
+
+// Isolated requests leave the cgo core and run next to in-process ones
+func TestConcurrentIsolatedRun(t *testing.T) {
+    t.Setenv("SORTBENCH_CGO", "1")
+    isolated := RunRequest{N: 2048, Dist: "random", Type: "i32", Repeats: 2, Algos: []string{"std_sort", "heap_sort"}, Isolate: true}
+    plain := RunRequest{N: 2048, Dist: "random", Type: "i32", Repeats: 2, Algos: []string{"std_sort", "heap_sort"}}
+    if inProcess(&isolated) {
+        t.Fatal("isolated request routed to the in-process core")
+    }
+    mux := http.NewServeMux()
+    mux.HandleFunc("/run", runHandler)
+    srv := httptest.NewServer(mux)
+    defer srv.Close()
+    var wg sync.WaitGroup
+    codes := make([]int, 6)
+    for i := range codes {
+        req := plain
+        if i%2 == 0 { req = isolated }
+        wg.Add(1)
+        go func(i int, req RunRequest) {
+            defer wg.Done()
+            var buf bytes.Buffer
+            _ = json.NewEncoder(&buf).Encode(req)
+            resp, err := http.Post(srv.URL+"/run", "application/json", &buf)
+            if err != nil { return }
+            resp.Body.Close()
+            codes[i] = resp.StatusCode
+        }(i, req)
+    }
+    wg.Wait()
+    for i, c := range codes {
+        if c != 200 {
+            t.Fatalf("request %d (isolated=%v): status %d", i, i%2 == 0, c)
+        }
+    }
+}
+
+func TestPluginsIsolatedArgs(t *testing.T) {
+    req := RunRequest{N: 16, Dist: "random", Type: "u64", PluginsIsolated: []string{"plugins/v3_merge.so"}}
+    if err := validate(&req); err != nil {
+        t.Fatalf("validate: %v", err)
+    }
+    if args := strings.Join(buildArgs(&req), " "); !strings.Contains(args, "--plugin-isolated plugins/v3_merge.so") {
+        t.Fatalf("missing --plugin-isolated in %q", args)
+    }
+    req.Type = "str"
+    if err := validate(&req); err == nil {
+        t.Fatal("validate accepted plugins_isolated with str")
+    }
+}
+
+func TestDatasetCacheArgs(t *testing.T) {
+    defer func() { datasetCacheDir, datasetCacheMaxBytes = "", 0 }()
+    req := RunRequest{N: 16, Dist: "random", Type: "i32"}
+    if strings.Contains(strings.Join(buildArgs(&req), " "), "--cache-dir") {
+        t.Fatal("cache args without DATASET_CACHE_DIR")
+    }
+    datasetCacheDir, datasetCacheMaxBytes = "/var/cache/sb", 1<<30
+    args := strings.Join(buildArgs(&req), " ")
+    if !strings.Contains(args, "--cache-dir /var/cache/sb --cache-max-bytes 1073741824") {
+        t.Fatalf("missing cache args in %q", args)
+    }
+}
+
+func TestInputValidation(t *testing.T) {
+    defer func() { inputDir = "" }()
+    req := RunRequest{N: 16, Dist: "random", Type: "i32", Input: "keys.bin"}
+    if err := validate(&req); err == nil {
+        t.Fatal("input accepted without INPUT_DIR")
+    }
+    inputDir = "/srv/inputs"
+    for _, bad := range []string{"../etc/passwd", "/etc/passwd", "a/../../b"} {
+        r := req
+        r.Input = bad
+        if err := validate(&r); err == nil {
+            t.Fatalf("input %q escapes INPUT_DIR", bad)
+        }
+    }
+    req.InputOffset, req.InputSample = 8, true
+    if err := validate(&req); err != nil {
+        t.Fatal(err)
+    }
+    args := strings.Join(buildArgs(&req), " ")
+    if !strings.Contains(args, "--input /srv/inputs/keys.bin --input-offset 8 --input-sample") {
+        t.Fatalf("missing input args in %q", args)
+    }
+}
+
+func TestAdversaryArgs(t *testing.T) {
+    req := RunRequest{N: 16, Dist: "adversarial", Type: "i32", Adversary: "std_sort"}
+    if err := validate(&req); err != nil {
+        t.Fatal(err)
+    }
+    if !strings.Contains(strings.Join(buildArgs(&req), " "), "--adversary std_sort") {
+        t.Fatal("missing --adversary")
+    }
+    req.Adversary = "std_sort; rm -rf /"
+    if err := validate(&req); err == nil {
+        t.Fatal("adversary name not validated")
+    }
+}
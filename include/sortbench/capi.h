@@ -32,8 +32,51 @@ enum sb_dist {
   SB_DIST_ORGANPIPE = 10,
   SB_DIST_STAGGERED = 11,
   SB_DIST_RUNS_HT = 12,
+  SB_DIST_ADVERSARIAL = 13,
+  SB_DIST_SORTED_TAIL = 14,
+  SB_DIST_K_SORTED = 15,
+  SB_DIST_CLUSTERED = 16,
+  SB_DIST_BLOCK_SHUFFLED = 17,
 };
 
+enum sb_schedule {
+  SB_SCHEDULE_SEQUENTIAL = 0,
+  SB_SCHEDULE_ROUND_ROBIN = 1,
+  SB_SCHEDULE_SHUFFLED = 2,
+};
+
+enum sb_verify_mode {
+  SB_VERIFY_AUTO = 0,
+  SB_VERIFY_REFERENCE = 1,
+  SB_VERIFY_FINGERPRINT = 2,
+};
+
+enum sb_reset {
+  SB_RESET_AUTO = 0,
+  SB_RESET_COPY = 1,
+  SB_RESET_SNAPSHOT = 2,
+  SB_RESET_PARALLEL = 3,
+};
+
+enum sb_placement {
+  SB_PLACEMENT_LOCAL = 0,
+  SB_PLACEMENT_INTERLEAVE = 1,
+  SB_PLACEMENT_FIRST_TOUCH = 2,
+};
+
+enum sb_buffers {
+  SB_BUFFERS_DEFAULT = 0,
+  SB_BUFFERS_HUGE = 1,
+  SB_BUFFERS_PREFAULT = 2,
+};
+
+// Cancellation token for a run in flight (see CoreConfig::cancel).
+// sb_cancel may be called from any thread; the token must outlive the run.
+typedef struct sb_cancel_token sb_cancel_token;
+sb_cancel_token* sb_cancel_token_new(void);
+void sb_cancel(sb_cancel_token* t);
+void sb_cancel_token_free(sb_cancel_token* t);
+
 typedef struct sb_core_config {
   uint64_t N;
   int dist;            // sb_dist
@@ -56,15 +99,95 @@ typedef struct sb_core_config {
   int stagger_block;
   const char** plugin_paths;
   int plugin_len;
+  // CPU placement (NULL/empty = inherit affinity), e.g. "2-5,8"
+  const char* cpus;
+  int spin_up;         // spin until clock frequency is stable before timing
+  int schedule;        // sb_schedule (0 = sequential)
+  int buffers;         // sb_buffers (0 = default heap vectors)
+  int isolate;         // fork one child per algorithm (Linux)
+  int algo_timeout_ms; // per-algorithm budget, implies isolate (0 = none)
+  const char* cache_dir;     // dataset cache directory (NULL/empty = off)
+  uint64_t cache_max_bytes;  // LRU budget for cache_dir (0 = unlimited)
+  // Input file instead of dist (NULL/empty = generate); N = 0 reads it all
+  const char* input_path;
+  uint64_t input_offset;     // records to skip
+  int input_sample;          // sample N records at random instead of the first N
+  const char* adversary;     // sort targeted by SB_DIST_ADVERSARIAL (NULL = quicksort_hybrid)
+  int analyze;               // add the input profile (input_* keys) to meta
+  // Tunables of the production-like distributions (<= 0 = core default)
+  int tail_pct;
+  int displace_k;
+  int clusters;
+  int shuffle_block;
+  int verify_mode;           // sb_verify_mode (0 = auto)
+  int reset;                 // sb_reset (0 = auto)
+  int placement;             // sb_placement (0 = local)
+  // Stops the run early when canceled (NULL = not cancelable). The result
+  // keeps the finished rows; the others have status "canceled".
+  sb_cancel_token* cancel;
+  // Plugins run by a sortbench-plugin-host process (numeric types only)
+  const char** isolated_plugin_paths;
+  int isolated_plugin_len;
 } sb_core_config;
 
 // Returns malloc-allocated JSON string on success; caller must free via sb_free.
 // On error, returns NULL and sets *err_out (also needs sb_free).
 char* sb_run_json(const sb_core_config* cfg, int include_speedup, int pretty, char** err_out);
 
+// Progress callbacks (see sortbench::Observer). Any of them may be NULL; they
+// run on the calling thread and their string arguments are only valid for
+// the duration of the call. on_row gets one result row as a JSON object
+// (the JSONL row format, without speedup_vs_baseline).
+typedef struct sb_observer {
+  void* user;
+  void (*on_start)(void* user, const char* const* algos, int algos_len);
+  void (*on_input)(void* user, uint64_t n, double input_ms);
+  void (*on_repeat)(void* user, const char* algo, int repeat, double ms);
+  void (*on_row)(void* user, const char* row_json);
+} sb_observer;
+
+// sb_run_json reporting progress to obs (NULL = none)
+char* sb_run_json_observed(const sb_core_config* cfg, const sb_observer* obs, int include_speedup, int pretty, char** err_out);
+
 // Returns JSON array string of algorithm names. Caller frees via sb_free.
 char* sb_list_algos_json(int elem_type, const char* const* plugins, int plugins_len, char** err_out);
 
+// Persistent session: plugins stay loaded, registries are built once and
+// generated inputs are reused across runs (see sortbench::Session).
+// The session is thread-safe. Free with sb_session_free.
+typedef struct sb_session sb_session;
+sb_session* sb_session_new(uint64_t dataset_max_bytes);
+void sb_session_free(sb_session* s);
+char* sb_session_run_json(sb_session* s, const sb_core_config* cfg, int include_speedup, int pretty, char** err_out);
+char* sb_session_run_json_observed(sb_session* s, const sb_core_config* cfg, const sb_observer* obs, int include_speedup, int pretty, char** err_out);
+char* sb_session_list_algos_json(sb_session* s, int elem_type, const char* const* plugins, int plugins_len, char** err_out);
+
+enum sb_invalidate {
+  SB_INVALIDATE_DATASETS = 1,
+  SB_INVALIDATE_PLUGINS = 2,
+  SB_INVALIDATE_ALL = 3,
+};
+void sb_session_invalidate(sb_session* s, int what); // sb_invalidate bits
+
+// Plugin build cache (see sortbench::build_plugin)
+enum sb_isa {
+  SB_ISA_BASELINE = 1, // x86-64
+  SB_ISA_AVX2 = 2,     // x86-64-v3
+  SB_ISA_AVX512 = 4,   // x86-64-v4
+};
+typedef struct sb_plugin_build {
+  const char* source;    // plugin .cpp
+  const char* cache_dir; // created when missing
+  const char* cxx;       // NULL/empty = the compiler the core was built with
+  const char* cxxflags;  // NULL/empty = the core's flags
+  const char* ldflags;   // NULL/empty = the core's link flags
+  int variants;          // sb_isa bits; 0 = this CPU's level only
+} sb_plugin_build;
+// Builds (or reuses) the variants and returns
+// {"path","isa","variants":[{"isa","path","cached"}]}, where path is the
+// variant to load on this CPU. Caller frees via sb_free.
+char* sb_build_plugin_json(const sb_plugin_build* b, char** err_out);
+
 void sb_free(char* p);
 
 #ifdef __cplusplus
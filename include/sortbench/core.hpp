@@ -4,12 +4,15 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <regex>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace sortbench {
@@ -29,8 +32,17 @@ enum class Dist : int {
   organpipe = 10,
   staggered = 11,
   runs_ht = 12,
+  adversarial = 13, // McIlroy killer input for CoreConfig::adversary
+  sorted_tail = 14,
+  k_sorted = 15,
+  clustered = 16,
+  block_shuffled = 17,
 };
 
+// Version of the seed -> input data mapping, recorded as meta.generator.
+// Bumped whenever the generated data for a given (seed, N, dist) changes.
+inline constexpr int kGeneratorVersion = 4;
+
 // Output-friendly distribution names
 std::string_view dist_name(Dist d);
 const std::vector<std::string_view> &all_dist_names();
@@ -39,6 +51,54 @@ const std::vector<std::string_view> &all_dist_names();
 enum class ElemType : int { i32, u32, i64, u64, f32, f64, str };
 std::string_view elem_type_name(ElemType t);
 
+// Order in which timed repeats are executed across the selected algorithms
+enum class Schedule : int {
+  sequential = 0,  // all repeats of A, then all of B, ...
+  round_robin = 1, // one repeat of each algorithm per round
+  shuffled = 2,    // per-round order drawn from a seeded shuffle
+};
+std::string_view schedule_name(Schedule s);
+std::optional<Schedule> parse_schedule(std::string_view s);
+
+// Backing memory for the input/work buffers of numeric element types
+enum class BufferMode : int {
+  standard = 0, // std::vector (name: "default")
+  huge = 1,     // 2MB pages (hugetlbfs, else THP), pre-faulted, NUMA-local
+  prefault = 2, // regular pages, pre-faulted, NUMA-local
+};
+std::string_view buffer_mode_name(BufferMode m);
+std::optional<BufferMode> parse_buffer_mode(std::string_view s);
+
+// NUMA placement of the work buffer's pages (numeric element types)
+enum class Placement : int {
+  local = 0,       // bound to the node of the timing thread
+  interleave = 1,  // round-robin across all online nodes
+  first_touch = 2, // faulted in by the OpenMP workers, each over its share
+};
+std::string_view placement_name(Placement p);
+std::optional<Placement> parse_placement(std::string_view s);
+
+// How --verify checks each algorithm's output
+enum class VerifyMode : int {
+  automatic = 0,   // reference below kVerifyFingerprintMinN elements, else fingerprint
+  reference = 1,   // compare with a std::sort-ed copy (one extra array)
+  fingerprint = 2, // parallel sortedness scan + multiset fingerprint, no copy
+};
+inline constexpr std::size_t kVerifyFingerprintMinN = std::size_t{1} << 24;
+std::string_view verify_mode_name(VerifyMode m);
+std::optional<VerifyMode> parse_verify_mode(std::string_view s);
+
+// How the work buffer is restored from the input before every run
+enum class ResetMode : int {
+  automatic = 0, // copy below kResetAutoMinBytes, else time each and keep the cheapest
+  copy = 1,      // std::copy from the input buffer
+  snapshot = 2,  // fresh pre-faulted copy-on-write view of a memfd (Linux, numeric types)
+  parallel = 3,  // non-temporal stores split across the OpenMP workers (numeric types)
+};
+inline constexpr std::size_t kResetAutoMinBytes = std::size_t{64} << 20;
+std::string_view reset_mode_name(ResetMode m);
+std::optional<ResetMode> parse_reset_mode(std::string_view s);
+
 struct CoreConfig {
   std::size_t N = 100000;
   Dist dist = Dist::random;
@@ -54,14 +114,48 @@ struct CoreConfig {
   int partial_shuffle_pct = 10;          // for Dist::partial
   int dup_values = 100;                  // for Dist::dups/zipf
   bool verify = false;                   // verify vs std::sort
+  VerifyMode verify_mode = VerifyMode::automatic;
   bool assert_sorted = false;            // assert each run sorted
   int threads = 0;                       // OMP/TBB max threads (0 = default)
   std::vector<std::string> plugin_paths; // (phase 2) optional .so to load
+  // Plugins loaded by a sortbench-plugin-host process (numeric types only)
+  std::vector<std::string> isolated_plugin_paths;
   std::optional<std::string> baseline;   // compute speedups vs baseline algo
   // Extra distribution params
   double zipf_s = 1.2;        // Zipf skew parameter
   double runs_alpha = 1.5;    // heavy-tail alpha for runs_ht
   int stagger_block = 32;     // block size for 'staggered'
+  std::string adversary = "quicksort_hybrid"; // sort targeted by 'adversarial'
+  int tail_pct = 10;          // random tail share for 'sorted_tail'
+  int displace_k = 16;        // max displacement for 'k_sorted'
+  int clusters = 8;           // centres for 'clustered'
+  int shuffle_block = 4096;   // block size for 'block_shuffled'
+  // CPU placement / clock stability
+  std::vector<int> cpus;      // pin timing + worker threads (empty = inherit)
+  bool spin_up = false;       // spin until clock frequency is stable first
+  Schedule schedule = Schedule::sequential; // repeat interleaving
+  BufferMode buffers = BufferMode::standard; // input/work buffer backing
+  ResetMode reset = ResetMode::automatic;    // work buffer restore per run
+  Placement placement = Placement::local;    // work buffer NUMA placement
+  // Crash/hang isolation (Linux): one forked child per algorithm
+  bool isolate = false;       // run each algorithm in its own child process
+  int algo_timeout_ms = 0;    // per-algorithm budget, implies isolate (0 = none)
+  // On-disk cache of generated inputs (numeric types only)
+  std::string cache_dir;              // empty = disabled
+  std::uint64_t cache_max_bytes = 0;  // LRU budget for cache_dir (0 = unlimited)
+  // Input from a file instead of `dist`: raw little-endian arrays for numeric
+  // types, one record per line for str. N = 0 takes every record.
+  std::string input_path;             // empty = generate
+  std::size_t input_offset = 0;       // skip this many records first
+  bool input_sample = false;          // N records sampled at random, not the first N
+  // Profile the input (runs, sorted prefix/suffix, distinct values, inversion
+  // ratio, entropy) into meta as input_* keys
+  bool analyze = false;
+  // Cooperative cancellation (owned by the caller, may be set from any
+  // thread): checked inside the generator, between algorithms and between
+  // repeats; an isolated child is killed. The run then returns early with
+  // RunResult::canceled set.
+  const std::atomic<bool> *cancel = nullptr;
 };
 
 struct TimingStats {
@@ -78,6 +172,26 @@ struct ResultRow {
   std::string dist; // stable string name
   TimingStats stats;
   double speedup_vs_baseline = 1.0;
+  // Memory accounting inside the timed region (worst case over repeats)
+  std::uint64_t peak_extra_bytes = 0; // operator new high-water mark
+  std::uint64_t alloc_count = 0;      // operator new calls
+  std::uint64_t minor_faults = 0;     // process minor page faults
+  double reset_ms = 0.0;              // median untimed input restore before a run
+  // v3 plugins: harness-provided scratch (outside the timings and the
+  // counts above) and declared capabilities, e.g. "stable,parallel"
+  std::uint64_t scratch_bytes = 0;
+  std::string caps;
+  // Built-ins compiled per instruction-set level: the level that ran
+  // ("baseline", "avx2", "avx512"); empty for the others
+  std::string isa;
+  // Phase timings (ms) and counters the plugin reported through its sink,
+  // median over the timed repeats, in first-reported order
+  std::vector<std::pair<std::string, double>> phase_ms;
+  std::vector<std::pair<std::string, double>> counters;
+  // "ok"; isolated runs: "timeout", "crashed" or "failed" (verify/assert);
+  // "canceled" when the run was stopped before this algorithm finished
+  std::string status = "ok";
+  std::string error;                  // detail for non-ok rows
 };
 
 struct RunResult {
@@ -88,12 +202,37 @@ struct RunResult {
   std::optional<std::uint64_t> seed;
   std::optional<std::string> baseline;
   std::vector<ResultRow> rows; // 1 per algorithm
+  // Run environment (cpuset, governor, ...) as ordered key/value pairs
+  std::vector<std::pair<std::string, std::string>> meta;
+  // Stopped through CoreConfig::cancel: rows of unfinished algorithms are
+  // "canceled" and carry no timings
+  bool canceled = false;
+};
+
+// Progress of a run as it happens. Every hook defaults to a no-op and is
+// called on the thread running the benchmark, in this order: on_start, then
+// on_input, then on_repeat/on_row as algorithms run. Isolated runs report an
+// algorithm's repeats when its child exits. An exception thrown from a hook
+// aborts the run.
+class Observer {
+public:
+  virtual ~Observer() = default;
+  // Selected algorithms, in the order of the result rows
+  virtual void on_start(const std::vector<std::string> &) {}
+  // Input generated (or loaded) and set up, after `input_ms`: the run's
+  // type, N, dist and meta, no rows yet
+  virtual void on_input(const RunResult &, double /*input_ms*/) {}
+  // One timed repeat (0-based) of one algorithm
+  virtual void on_repeat(const std::string &, int /*repeat*/, double /*ms*/) {}
+  // An algorithm has finished. speedup_vs_baseline is only filled in the
+  // returned result, once the baseline is known.
+  virtual void on_row(const ResultRow &) {}
 };
 
 // Execute a single benchmark run for the given config.
 // Returns timing stats per algorithm. Throws std::runtime_error on invalid
 // input and uses exceptions for fatal errors.
-RunResult run_benchmark(const CoreConfig &cfg);
+RunResult run_benchmark(const CoreConfig &cfg, Observer *obs = nullptr);
 
 // Return available algorithm names for a given element type.
 // Overload without plugin paths returns built-in (and header-available) algos only.
@@ -101,8 +240,87 @@ std::vector<std::string> list_algorithms(ElemType t);
 
 // Return algorithms including any provided plugin shared objects for discovery.
 // Loads plugins transiently, collects names for the specified type, then closes them.
+// Plugins in isolated_plugin_paths are listed by a plugin host process.
 std::vector<std::string> list_algorithms(
-    ElemType t, const std::vector<std::string>& plugin_paths);
+    ElemType t, const std::vector<std::string>& plugin_paths,
+    const std::vector<std::string>& isolated_plugin_paths = {});
+
+namespace detail { struct SessionState; }
+
+// Long-lived state for many runs (API servers, sweeps of small N): plugins
+// stay loaded, per-type registries are built once per plugin set, and
+// generated inputs are kept in memory (LRU, `dataset_max_bytes`) and reused
+// by later runs with the same generator parameters. File inputs are always
+// re-read. The caches are thread-safe; a run holds on to its registry and
+// input, so invalidating never pulls them out from under it.
+class Session {
+public:
+  explicit Session(std::uint64_t dataset_max_bytes = std::uint64_t{1} << 30);
+  ~Session();
+  Session(const Session &) = delete;
+  Session &operator=(const Session &) = delete;
+
+  // Same as run_benchmark, plus meta.session_dataset ("hit" or "miss")
+  RunResult run(const CoreConfig &cfg, Observer *obs = nullptr);
+  std::vector<std::string> list_algorithms(
+      ElemType t, const std::vector<std::string> &plugin_paths = {},
+      const std::vector<std::string> &isolated_plugin_paths = {});
+
+  // Drop kept inputs, e.g. after changing the generator
+  void invalidate_datasets();
+  // Unload plugins and forget registries so rebuilt .so files are picked up
+  void invalidate_plugins();
+
+private:
+  std::unique_ptr<detail::SessionState> state_;
+};
+
+// Instruction set levels a plugin can be built for (the x86-64 psABI levels)
+enum class IsaLevel : int {
+  baseline = 0, // x86-64 (SSE2); the compiler default on other targets
+  avx2 = 1,     // x86-64-v3: AVX2, FMA, BMI2
+  avx512 = 2,   // x86-64-v4: AVX-512 F/BW/CD/DQ/VL
+};
+std::string_view isa_level_name(IsaLevel l);
+std::optional<IsaLevel> parse_isa_level(std::string_view s);
+// Highest level the running CPU (and OS) supports
+IsaLevel host_isa_level();
+
+// Plugin build cache: a source is compiled once per hash of its contents
+// (with the quoted #includes it pulls in), the compiler version, the flags
+// and the ISA level, and reused from cache_dir afterwards.
+struct PluginBuildOptions {
+  std::string source;             // plugin .cpp
+  std::string cache_dir;          // created when missing
+  std::string cxx;                // empty = the compiler the core was built with
+  std::string cxxflags;           // empty = the core's flags; -march/-mtune are set per level
+  std::string ldflags;            // empty = the core's link flags
+  std::vector<IsaLevel> variants; // empty = host_isa_level() only
+};
+struct PluginVariant {
+  IsaLevel isa = IsaLevel::baseline;
+  std::string path;
+  bool cached = false; // reused; the compiler did not run
+};
+struct PluginBuild {
+  std::string path; // highest built level this CPU runs
+  IsaLevel isa = IsaLevel::baseline;
+  std::vector<PluginVariant> variants;
+};
+// Throws std::runtime_error when the compiler fails or no variant runs here
+PluginBuild build_plugin(const PluginBuildOptions &opt);
+// The member of path's variant family (<base>-{baseline,avx2,avx512}.so in
+// its directory, where path is <base>.so or one of them) this CPU runs best;
+// path itself when there is no family. Plugin loaders call this, so a library
+// built elsewhere or copied between machines loads the right variant.
+// Throws std::runtime_error when the family has no level this CPU supports.
+std::string resolve_plugin_variant(const std::string &path);
+
+// Parse a CPU list such as "0-3,8,10-11" (sorted, deduplicated).
+// Throws std::runtime_error on malformed input.
+std::vector<int> parse_cpu_list(std::string_view s);
+// Inverse of parse_cpu_list: compact range form ("0-3,8")
+std::string format_cpu_list(const std::vector<int>& cpus);
 
 // Supported element types and distributions (metadata helpers)
 std::vector<ElemType> supported_types();
@@ -1,6 +1,7 @@
-// Dual-Pivot QuickSort variant as a sortbench v2 plugin
-// Provides implementations for i32/u32/i64/u64/f32/f64.
-// Name: "minmax_quicksort"
+// Dual-Pivot QuickSort variant as a sortbench v3 plugin (v2 kept for older
+// harnesses). Provides implementations for i32/u32/i64/u64/f32/f64 and
+// reports its partitions, base cases and recursion depth as counters.
+// Name: "dualpivot_quicksort"
 
 #include "../sortbench_plugin.h"
 
@@ -10,12 +11,21 @@
 
 namespace {
 
+using Index = std::ptrdiff_t;
+
+// What one sort did, reported through the v3 sink
+struct Counters {
+  double partitions = 0;
+  double base_cases = 0;
+  int max_depth = 0;
+};
+
 // Insertion sort for small ranges
 template <class T>
-inline void insertion_sort(T* a, int n) {
-  for (int i = 1; i < n; ++i) {
+inline void insertion_sort(T* a, Index n) {
+  for (Index i = 1; i < n; ++i) {
     T key = a[i];
-    int j = i - 1;
+    Index j = i - 1;
     while (j >= 0 && a[j] > key) {
       a[j + 1] = a[j];
       --j;
@@ -27,22 +37,25 @@ inline void insertion_sort(T* a, int n) {
 // Dual-pivot quicksort (Yaroslavskiy-style), small tweaks
 // Partitions into < p, between [p..q], and > q
 template <class T>
-inline void dual_pivot_qs(T* a, int left, int right) {
+inline void dual_pivot_qs(T* a, Index left, Index right, Counters& c, int depth) {
+  c.max_depth = std::max(c.max_depth, depth);
   while (left < right) {
-    const int n = right - left + 1;
+    const Index n = right - left + 1;
     if (n <= 24) { // insertion sort cutoff
+      ++c.base_cases;
       insertion_sort(a + left, n);
       return;
     }
+    ++c.partitions;
 
     // Choose pivots: first and last; ensure p <= q
     T p = a[left];
     T q = a[right];
     if (p > q) { std::swap(p, q); std::swap(a[left], a[right]); }
 
-    int lt = left + 1;   // next position for < p
-    int gt = right - 1;  // next position for > q
-    int i  = lt;         // current
+    Index lt = left + 1;   // next position for < p
+    Index gt = right - 1;  // next position for > q
+    Index i  = lt;         // current
 
     while (i <= gt) {
       if (a[i] < p) {
@@ -63,52 +76,52 @@ inline void dual_pivot_qs(T* a, int left, int right) {
     std::swap(a[right], a[gt]);
 
     // Recurse on three partitions; tail-recurse on the largest to limit depth
-    const int left_len   = lt - left;
-    const int middle_len = gt - lt - 1;
-    const int right_len  = right - gt;
+    const Index left_len   = lt - left;
+    const Index middle_len = gt - lt - 1;
+    const Index right_len  = right - gt;
 
     // Order recursive calls from smallest to largest; convert the largest into tail recursion
     if (left_len < middle_len) {
       if (left_len < right_len) {
         // left smallest
-        dual_pivot_qs(a, left, lt - 1);
+        dual_pivot_qs(a, left, lt - 1, c, depth + 1);
         if (middle_len < right_len) {
-          dual_pivot_qs(a, lt + 1, gt - 1);
+          dual_pivot_qs(a, lt + 1, gt - 1, c, depth + 1);
           left = gt + 1; // tail on right
         } else {
-          dual_pivot_qs(a, gt + 1, right);
+          dual_pivot_qs(a, gt + 1, right, c, depth + 1);
           left = lt + 1; right = gt - 1; // tail on middle
         }
       } else {
         // right smallest
-        dual_pivot_qs(a, gt + 1, right);
+        dual_pivot_qs(a, gt + 1, right, c, depth + 1);
         if (left_len < middle_len) {
-          dual_pivot_qs(a, left, lt - 1);
+          dual_pivot_qs(a, left, lt - 1, c, depth + 1);
           left = lt + 1; right = gt - 1; // tail on middle
         } else {
-          dual_pivot_qs(a, lt + 1, gt - 1);
+          dual_pivot_qs(a, lt + 1, gt - 1, c, depth + 1);
           right = lt - 1; // tail on left
         }
       }
     } else {
       if (middle_len < right_len) {
         // middle smallest
-        dual_pivot_qs(a, lt + 1, gt - 1);
+        dual_pivot_qs(a, lt + 1, gt - 1, c, depth + 1);
         if (left_len < right_len) {
-          dual_pivot_qs(a, left, lt - 1);
+          dual_pivot_qs(a, left, lt - 1, c, depth + 1);
           left = gt + 1; // tail on right
         } else {
-          dual_pivot_qs(a, gt + 1, right);
+          dual_pivot_qs(a, gt + 1, right, c, depth + 1);
           right = lt - 1; // tail on left
         }
       } else {
         // right smallest
-        dual_pivot_qs(a, gt + 1, right);
+        dual_pivot_qs(a, gt + 1, right, c, depth + 1);
         if (left_len < middle_len) {
-          dual_pivot_qs(a, left, lt - 1);
+          dual_pivot_qs(a, left, lt - 1, c, depth + 1);
           left = lt + 1; right = gt - 1; // tail on middle
         } else {
-          dual_pivot_qs(a, lt + 1, gt - 1);
+          dual_pivot_qs(a, lt + 1, gt - 1, c, depth + 1);
           right = lt - 1; // tail on left
         }
       }
@@ -117,9 +130,19 @@ inline void dual_pivot_qs(T* a, int left, int right) {
 }
 
 template <class T>
-inline void minmax_quicksort(T* data, int n) {
-  if (n <= 1) return;
-  dual_pivot_qs(data, 0, n - 1);
+inline Counters minmax_quicksort(T* data, Index n) {
+  Counters c;
+  if (n > 1) dual_pivot_qs(data, 0, n - 1, c, 0);
+  return c;
+}
+
+template <class T>
+void run_v3(T* data, std::size_t n, const sortbench_ctx_v3* ctx) {
+  const Counters c = minmax_quicksort<T>(data, static_cast<Index>(n));
+  const sortbench_sink_v3* sink = ctx->sink;
+  sink->counter(sink->self, "partitions", c.partitions);
+  sink->counter(sink->self, "base_cases", c.base_cases);
+  sink->counter(sink->self, "max_depth", c.max_depth);
 }
 
 // Wrappers for each supported type
@@ -134,6 +157,12 @@ static const sortbench_algo_v2 ALGOS[] = {
   {"dualpivot_quicksort", &run_i32, &run_u32, &run_i64, &run_u64, &run_f32, &run_f64},
 };
 
+static const sortbench_algo_v3 ALGOS_V3[] = {
+  {sizeof(sortbench_algo_v3), "dualpivot_quicksort", SORTBENCH_CAP_IN_PLACE, nullptr, nullptr,
+   &run_v3<int>, &run_v3<unsigned int>, &run_v3<long long>,
+   &run_v3<unsigned long long>, &run_v3<float>, &run_v3<double>, nullptr, nullptr},
+};
+
 } // namespace
 
 extern "C" int sortbench_get_algorithms_v2(const sortbench_algo_v2** out_algos, int* out_count) {
@@ -142,3 +171,10 @@ extern "C" int sortbench_get_algorithms_v2(const sortbench_algo_v2** out_algos,
   *out_count = (int)(sizeof(ALGOS) / sizeof(ALGOS[0]));
   return 1;
 }
+
+extern "C" int sortbench_get_algorithms_v3(const sortbench_algo_v3** out_algos, std::size_t* out_count) {
+  if (!out_algos || !out_count) return 0;
+  *out_algos = ALGOS_V3;
+  *out_count = sizeof(ALGOS_V3) / sizeof(ALGOS_V3[0]);
+  return 1;
+}
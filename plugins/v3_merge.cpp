@@ -0,0 +1,115 @@
+// Sortbench v3 plugin: a bottom-up merge sort working in the harness-provided
+// scratch buffer (numbers and strings), an in-place std::sort for comparison
+// and an LSD radix sort of key/index pairs.
+// Names: "v3_merge_sort", "v3_std_sort", "v3_kv_radix"
+
+#include "../sortbench_plugin.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+// Found by std::merge through the argument's (global) namespace
+static bool operator<(const sortbench_str_view& a, const sortbench_str_view& b) {
+  const int c = std::memcmp(a.ptr, b.ptr, std::min(a.len, b.len));
+  return c < 0 || (c == 0 && a.len < b.len);
+}
+
+namespace {
+
+std::size_t merge_scratch(std::size_t n, std::size_t elem_size, void*) {
+  return n * elem_size;
+}
+
+double ms_since(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Ping-pongs between data and the scratch buffer, copying back at the end.
+// Reports the split between the run and merge phases through ctx->sink.
+template <class T>
+void merge_sort(T* data, std::size_t n, const sortbench_ctx_v3* ctx) {
+  if (n < 2) return;
+  T* tmp = static_cast<T*>(ctx->scratch);
+  if (!tmp || ctx->scratch_bytes < n * sizeof(T)) {
+    std::stable_sort(data, data + n);
+    return;
+  }
+  constexpr std::size_t kRun = 32;
+  auto t0 = std::chrono::steady_clock::now();
+  for (std::size_t lo = 0; lo < n; lo += kRun) { // insertion sort, no allocation
+    const std::size_t hi = std::min(n, lo + kRun);
+    for (std::size_t i = lo + 1; i < hi; ++i) {
+      T key = data[i];
+      std::size_t j = i;
+      for (; j > lo && key < data[j - 1]; --j) data[j] = data[j - 1];
+      data[j] = key;
+    }
+  }
+  const double runs_ms = ms_since(t0);
+  t0 = std::chrono::steady_clock::now();
+  T* src = data;
+  T* dst = tmp;
+  int passes = 0;
+  for (std::size_t width = kRun; width < n; width *= 2, ++passes) {
+    for (std::size_t lo = 0; lo < n; lo += 2 * width) {
+      const std::size_t mid = std::min(n, lo + width);
+      const std::size_t hi = std::min(n, lo + 2 * width);
+      std::merge(src + lo, src + mid, src + mid, src + hi, dst + lo);
+    }
+    std::swap(src, dst);
+  }
+  if (src != data) std::copy(src, src + n, data);
+  const sortbench_sink_v3* sink = ctx->sink;
+  sink->phase_ms(sink->self, "runs", runs_ms);
+  sink->phase_ms(sink->self, "merge", ms_since(t0));
+  sink->counter(sink->self, "merge_passes", passes);
+}
+
+template <class T>
+void std_sort(T* data, std::size_t n, const sortbench_ctx_v3*) {
+  std::sort(data, data + n);
+}
+
+// Byte-wise LSD radix sort by key; skips bytes that are equal everywhere
+void kv_radix(sortbench_kv* data, std::size_t n, const sortbench_ctx_v3* ctx) {
+  auto* tmp = static_cast<sortbench_kv*>(ctx->scratch);
+  if (n < 2 || !tmp || ctx->scratch_bytes < n * sizeof(sortbench_kv)) return;
+  sortbench_kv* src = data;
+  sortbench_kv* dst = tmp;
+  for (int shift = 0; shift < 64; shift += 8) {
+    std::size_t count[257] = {};
+    for (std::size_t i = 0; i < n; ++i) ++count[((src[i].key >> shift) & 0xff) + 1];
+    if (count[((src[0].key >> shift) & 0xff) + 1] == n) continue;
+    for (int b = 0; b < 256; ++b) count[b + 1] += count[b];
+    for (std::size_t i = 0; i < n; ++i) dst[count[(src[i].key >> shift) & 0xff]++] = src[i];
+    std::swap(src, dst);
+  }
+  if (src != data) std::copy(src, src + n, data);
+}
+
+const sortbench_algo_v3 k_algos[] = {
+    {sizeof(sortbench_algo_v3), "v3_merge_sort", SORTBENCH_CAP_STABLE | SORTBENCH_CAP_STRINGS,
+     nullptr, &merge_scratch,
+     &merge_sort<int>, &merge_sort<unsigned int>, &merge_sort<long long>,
+     &merge_sort<unsigned long long>, &merge_sort<float>, &merge_sort<double>,
+     &merge_sort<sortbench_str_view>, nullptr},
+    {sizeof(sortbench_algo_v3), "v3_std_sort", SORTBENCH_CAP_IN_PLACE, nullptr, nullptr,
+     &std_sort<int>, &std_sort<unsigned int>, &std_sort<long long>,
+     &std_sort<unsigned long long>, &std_sort<float>, &std_sort<double>,
+     nullptr, nullptr},
+    {sizeof(sortbench_algo_v3), "v3_kv_radix", SORTBENCH_CAP_STABLE, nullptr, &merge_scratch,
+     nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+     nullptr, &kv_radix},
+};
+
+} // namespace
+
+extern "C" int sortbench_get_algorithms_v3(const sortbench_algo_v3** out_algos, std::size_t* out_count) {
+  if (!out_algos || !out_count) return 0;
+  *out_algos = k_algos;
+  *out_count = sizeof(k_algos) / sizeof(k_algos[0]);
+  return 1;
+}
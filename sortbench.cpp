@@ -1,7 +1,9 @@
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <csignal>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -100,12 +102,18 @@ enum class Dist : int {
   zipf = 9,
   organpipe = 10,
   staggered = 11,
-  runs_ht = 12
+  runs_ht = 12,
+  adversarial = 13,
+  sorted_tail = 14,
+  k_sorted = 15,
+  clustered = 16,
+  block_shuffled = 17
 };
-static constexpr std::array<std::string_view, 13> kDistNames{
+static constexpr std::array<std::string_view, 18> kDistNames{
     "random",    "partial",  "dups",     "reverse",  "sorted",
     "saw",       "runs",     "gauss",    "exp",      "zipf",
-    "organpipe", "staggered","runs_ht"};
+    "organpipe", "staggered","runs_ht",  "adversarial", "sorted_tail",
+    "k_sorted",  "clustered","block_shuffled"};
 
 enum class OutFmt : int { csv = 0, table = 1, json = 2, jsonl = 3 };
 enum class PlotStyle : int { boxes = 0, lines = 1 };
@@ -146,12 +154,16 @@ struct Options {
   int partial_shuffle_pct = 10;   // percent of elements to shuffle in partial
   int dup_values = 100;           // cardinality for duplicates distribution
   bool verify = false;            // verify correctness
+  sortbench::VerifyMode verify_mode = sortbench::VerifyMode::automatic; // --verify-mode
   bool list = false;              // list available algorithms and exit
   std::vector<std::string> plugin_paths;       // shared objects to load
+  std::vector<std::string> isolated_plugin_paths; // --plugin-isolated
   OutFmt format = OutFmt::csv;                 // output format
   bool print_build = false;                    // show compiler/flags used
   std::optional<std::string> build_plugin_src; // path to plugin .cpp
   std::optional<std::string> build_plugin_out; // output .so path
+  std::optional<std::string> plugin_cache;     // --plugin-cache (build cache dir)
+  std::vector<sortbench::IsaLevel> plugin_variants; // --plugin-variants (empty = this CPU)
   std::optional<std::string>
       init_plugin_out;                     // path to write scaffold plugin .cpp
   std::optional<std::string> results_path; // results output path
@@ -182,6 +194,28 @@ struct Options {
   double zipf_s = 1.2;        // Zipf skew parameter
   double runs_alpha = 1.5;    // heavy-tail alpha for runs_ht
   int stagger_block = 32;     // block size for 'staggered'
+  std::string adversary = "quicksort_hybrid"; // --adversary (target of 'adversarial')
+  int tail_pct = 10;          // random tail share for 'sorted_tail'
+  int displace_k = 16;        // max displacement for 'k_sorted'
+  int clusters = 8;           // centres for 'clustered'
+  int shuffle_block = 4096;   // block size for 'block_shuffled'
+  // CPU placement / clock stability
+  std::vector<int> cpus;      // --cpus LIST (empty = inherit affinity)
+  bool spin_up = false;       // --spin-up
+  sortbench::Schedule schedule = sortbench::Schedule::sequential; // --schedule
+  sortbench::BufferMode buffers = sortbench::BufferMode::standard; // --buffers
+  sortbench::ResetMode reset = sortbench::ResetMode::automatic;    // --reset
+  sortbench::Placement placement = sortbench::Placement::local;    // --placement
+  bool isolate = false;       // --isolate
+  int algo_timeout_ms = 0;    // --algo-timeout-ms (implies --isolate)
+  std::string cache_dir;              // --cache-dir
+  std::uint64_t cache_max_bytes = 0;  // --cache-max-bytes
+  // Input file instead of a generated distribution
+  std::string input_path;             // --input
+  std::size_t input_offset = 0;       // --input-offset
+  bool input_sample = false;          // --input-sample
+  bool N_set = false;                 // --N given (else --input reads it all)
+  bool analyze = false;               // --analyze (input profile in meta)
 };
 
 // Utilities
@@ -224,6 +258,16 @@ static std::optional<Dist> parse_dist(std::string s) {
     return Dist::staggered;
   if (s == "runs_ht" || s == "kruns_ht")
     return Dist::runs_ht;
+  if (s == "adversarial" || s == "killer")
+    return Dist::adversarial;
+  if (s == "sorted_tail" || s == "sorted-tail")
+    return Dist::sorted_tail;
+  if (s == "k_sorted" || s == "k-sorted" || s == "nearly_sorted")
+    return Dist::k_sorted;
+  if (s == "clustered")
+    return Dist::clustered;
+  if (s == "block_shuffled" || s == "block-shuffled")
+    return Dist::block_shuffled;
   return std::nullopt;
 }
 
@@ -258,7 +302,7 @@ static std::size_t parse_size_expr(const std::string &s) {
 static void print_usage(const char *argv0) {
   std::cerr << "Usage: " << argv0
             << " [--N size|start-end] [--dist "
-               "random|partial|dups|reverse|sorted|saw|runs|gauss|exp|zipf|organpipe|staggered|runs_ht]"
+               "random|partial|dups|reverse|sorted|saw|runs|gauss|exp|zipf|organpipe|staggered|runs_ht|adversarial|sorted_tail|k_sorted|clustered|block_shuffled]"
                " [--repeat k] [--warmup w] [--algo name[,name...]] [--seed s] "
                "[--no-header] "
                "[--verify]"
@@ -268,8 +312,12 @@ static void print_usage(const char *argv0) {
   std::cerr << "       --dist can be repeated or take multiple values (e.g., "
                "--dist random dups or --dist=random,dups)\n";
   std::cerr << "       --print-build (print compiler/flags used)\n";
-  std::cerr << "       --build-plugin <src.cpp> --out <lib.so> (compile plugin "
-               "with recorded flags)\n";
+  std::cerr << "       --build-plugin <src.cpp> [--out <lib.so>] (compile plugin "
+               "with recorded flags, through the plugin cache)\n";
+  std::cerr << "       --plugin-cache DIR (plugin build cache; default "
+               "~/.cache/sortbench/plugins)\n";
+  std::cerr << "       --plugin-variants auto|all|baseline,avx2,avx512 (ISA "
+               "variants to build; the best one this CPU runs is loaded)\n";
   std::cerr << "       --baseline NAME (compute speedups vs this algo)\n";
   std::cerr << "       --no-file (print to stdout only; no results files)\n";
   std::cerr << "       --plot <out.png|.jpg> [--plot-title T] [--plot-size "
@@ -289,6 +337,44 @@ static void print_usage(const char *argv0) {
   std::cerr << "       --zipf-s S (Zipf skew, default 1.2)\n";
   std::cerr << "       --runs-alpha A (heavy-tail alpha for runs_ht, default 1.5)\n";
   std::cerr << "       --stagger-block B (block size for 'staggered', default 32)\n";
+  std::cerr << "       --adversary NAME (sort that 'adversarial' is built against, "
+               "default quicksort_hybrid)\n";
+  std::cerr << "       --tail-pct P (random tail for 'sorted_tail', default 10)\n";
+  std::cerr << "       --displace-k K (max displacement for 'k_sorted', default 16)\n";
+  std::cerr << "       --clusters C (centres for 'clustered', default 8)\n";
+  std::cerr << "       --shuffle-block B (block size for 'block_shuffled', default 4096)\n";
+  std::cerr << "       --cpus LIST (pin timing/worker threads, e.g. 2-5,8)\n";
+  std::cerr << "       --spin-up (spin until clock frequency is stable before "
+               "timing)\n";
+  std::cerr << "       --schedule sequential|round_robin|shuffled (order of "
+               "repeats across algorithms; shuffled uses --seed)\n";
+  std::cerr << "       --buffers default|huge|prefault (input/work buffer "
+               "backing: 2MB pages or pre-faulted, NUMA-local)\n";
+  std::cerr << "       --reset auto|copy|parallel|snapshot (restore the input "
+               "before each run: copy, parallel streaming copy or memfd "
+               "copy-on-write view)\n";
+  std::cerr << "       --placement local|interleave|first_touch (NUMA placement "
+               "of the work buffer)\n";
+  std::cerr << "       --verify-mode auto|reference|fingerprint (implies --verify; "
+               "fingerprint needs no reference copy)\n";
+  std::cerr << "       --isolate (run each algorithm in a forked child; crashes "
+               "become per-row status)\n";
+  std::cerr << "       --algo-timeout-ms MS (kill an algorithm after MS ms; "
+               "implies --isolate)\n";
+  std::cerr << "       --plugin-isolated lib.so (load the plugin in a "
+               "sortbench-plugin-host process; repeatable)\n";
+  std::cerr << "       --plugin/--plugin-isolated also take a plugin .cpp, "
+               "built through the plugin cache\n";
+  std::cerr << "       --cache-dir DIR (reuse generated inputs from DIR)\n";
+  std::cerr << "       --cache-max-bytes SIZE (LRU budget for --cache-dir, "
+               "e.g. 20g)\n";
+  std::cerr << "       --input PATH (benchmark a file instead of --dist: raw "
+               "little-endian array, or one record per line for str)\n";
+  std::cerr << "       --input-offset K (skip K records of --input)\n";
+  std::cerr << "       --input-sample (take --N records at random instead of "
+               "the first --N)\n";
+  std::cerr << "       --analyze (profile the input: runs, inversions, distinct "
+               "values, entropy)\n";
 }
 
 static Options parse_args(int argc, char **argv) {
@@ -313,6 +399,7 @@ static Options parse_args(int argc, char **argv) {
     };
     if (a == "--N" || a == "-N" || a.rfind("--N=", 0) == 0) {
       std::string v = get_value_inline(a, "--N").value_or(need_value(a));
+      opt.N_set = true;
       // Support range: start-end
       auto dash = v.find('-');
       if (dash == std::string::npos) {
@@ -431,6 +518,13 @@ static Options parse_args(int argc, char **argv) {
         opt.dup_values = 1;
     } else if (a == "--verify") {
       opt.verify = true;
+    } else if (a == "--verify-mode" || a.rfind("--verify-mode=", 0) == 0) {
+      std::string v = get_value_inline(a, "--verify-mode").value_or(need_value(a));
+      auto vm = sortbench::parse_verify_mode(to_lower(std::move(v)));
+      if (!vm)
+        throw std::runtime_error("Invalid --verify-mode (auto|reference|fingerprint)");
+      opt.verify_mode = *vm;
+      opt.verify = true;
     } else if (a == "--list") {
       opt.list = true;
     } else if (a == "--plugin" || a.rfind("--plugin=", 0) == 0) {
@@ -441,6 +535,11 @@ static Options parse_args(int argc, char **argv) {
           throw std::runtime_error("Missing value for --plugin");
         opt.plugin_paths.push_back(std::string(argv[++i]));
       }
+    } else if (a == "--plugin-isolated" || a.rfind("--plugin-isolated=", 0) == 0) {
+      if (auto iv = get_value_inline(a, "--plugin-isolated"))
+        opt.isolated_plugin_paths.push_back(*iv);
+      else
+        opt.isolated_plugin_paths.push_back(need_value(a));
     } else if (a == "--format" || a.rfind("--format=", 0) == 0) {
       std::string v = get_value_inline(a, "--format").value_or(need_value(a));
       v = to_lower(std::move(v));
@@ -463,6 +562,33 @@ static Options parse_args(int argc, char **argv) {
     } else if (a == "--out" || a.rfind("--out=", 0) == 0) {
       opt.build_plugin_out =
           get_value_inline(a, "--out").value_or(need_value(a));
+    } else if (a == "--plugin-cache" || a.rfind("--plugin-cache=", 0) == 0) {
+      if (auto iv = get_value_inline(a, "--plugin-cache"))
+        opt.plugin_cache = *iv;
+      else
+        opt.plugin_cache = need_value(a);
+    } else if (a == "--plugin-variants" ||
+               a.rfind("--plugin-variants=", 0) == 0) {
+      std::string v;
+      if (auto iv = get_value_inline(a, "--plugin-variants"))
+        v = *iv;
+      else
+        v = need_value(a);
+      opt.plugin_variants.clear();
+      if (v == "all") {
+        opt.plugin_variants = {sortbench::IsaLevel::baseline,
+                               sortbench::IsaLevel::avx2,
+                               sortbench::IsaLevel::avx512};
+      } else if (v != "auto") {
+        std::stringstream ss(v);
+        for (std::string tok; std::getline(ss, tok, ',');) {
+          auto l = sortbench::parse_isa_level(to_lower(tok));
+          if (!l)
+            throw std::runtime_error(
+                "Invalid --plugin-variants (auto|all|baseline,avx2,avx512): " + v);
+          opt.plugin_variants.push_back(*l);
+        }
+      }
     } else if (a == "--init-plugin" || a.rfind("--init-plugin=", 0) == 0) {
       if (auto iv = get_value_inline(a, "--init-plugin")) {
         opt.init_plugin_out = *iv;
@@ -536,6 +662,75 @@ static Options parse_args(int argc, char **argv) {
       std::string v = get_value_inline(a, "--stagger-block").value_or(need_value(a));
       opt.stagger_block = std::stoi(v);
       if (opt.stagger_block <= 0) opt.stagger_block = 32;
+    } else if (a == "--tail-pct" || a.rfind("--tail-pct=", 0) == 0) {
+      std::string v = get_value_inline(a, "--tail-pct").value_or(need_value(a));
+      opt.tail_pct = std::clamp(std::stoi(v), 0, 100);
+    } else if (a == "--displace-k" || a.rfind("--displace-k=", 0) == 0) {
+      std::string v = get_value_inline(a, "--displace-k").value_or(need_value(a));
+      opt.displace_k = std::max(0, std::stoi(v));
+    } else if (a == "--clusters" || a.rfind("--clusters=", 0) == 0) {
+      std::string v = get_value_inline(a, "--clusters").value_or(need_value(a));
+      opt.clusters = std::stoi(v);
+      if (opt.clusters <= 0) opt.clusters = 8;
+    } else if (a == "--shuffle-block" || a.rfind("--shuffle-block=", 0) == 0) {
+      std::string v = get_value_inline(a, "--shuffle-block").value_or(need_value(a));
+      opt.shuffle_block = std::stoi(v);
+      if (opt.shuffle_block <= 0) opt.shuffle_block = 4096;
+    } else if (a == "--adversary" || a.rfind("--adversary=", 0) == 0) {
+      opt.adversary = get_value_inline(a, "--adversary").value_or(need_value(a));
+    } else if (a == "--cpus" || a.rfind("--cpus=", 0) == 0) {
+      std::string v = get_value_inline(a, "--cpus").value_or(need_value(a));
+      opt.cpus = sortbench::parse_cpu_list(v);
+    } else if (a == "--spin-up") {
+      opt.spin_up = true;
+    } else if (a == "--schedule" || a.rfind("--schedule=", 0) == 0) {
+      std::string v = get_value_inline(a, "--schedule").value_or(need_value(a));
+      auto sc = sortbench::parse_schedule(to_lower(std::move(v)));
+      if (!sc)
+        throw std::runtime_error(
+            "Invalid --schedule (sequential|round_robin|shuffled)");
+      opt.schedule = *sc;
+    } else if (a == "--buffers" || a.rfind("--buffers=", 0) == 0) {
+      std::string v = get_value_inline(a, "--buffers").value_or(need_value(a));
+      auto bm = sortbench::parse_buffer_mode(to_lower(std::move(v)));
+      if (!bm)
+        throw std::runtime_error("Invalid --buffers (default|huge|prefault)");
+      opt.buffers = *bm;
+    } else if (a == "--reset" || a.rfind("--reset=", 0) == 0) {
+      std::string v = get_value_inline(a, "--reset").value_or(need_value(a));
+      auto rm = sortbench::parse_reset_mode(to_lower(std::move(v)));
+      if (!rm)
+        throw std::runtime_error("Invalid --reset (auto|copy|parallel|snapshot)");
+      opt.reset = *rm;
+    } else if (a == "--placement" || a.rfind("--placement=", 0) == 0) {
+      std::string v = get_value_inline(a, "--placement").value_or(need_value(a));
+      auto pl = sortbench::parse_placement(to_lower(std::move(v)));
+      if (!pl)
+        throw std::runtime_error("Invalid --placement (local|interleave|first_touch)");
+      opt.placement = *pl;
+    } else if (a == "--isolate") {
+      opt.isolate = true;
+    } else if (a == "--algo-timeout-ms" || a.rfind("--algo-timeout-ms=", 0) == 0) {
+      std::string v =
+          get_value_inline(a, "--algo-timeout-ms").value_or(need_value(a));
+      opt.algo_timeout_ms = std::stoi(v);
+      if (opt.algo_timeout_ms < 0)
+        throw std::runtime_error("--algo-timeout-ms must be >= 0");
+    } else if (a == "--cache-dir" || a.rfind("--cache-dir=", 0) == 0) {
+      opt.cache_dir = get_value_inline(a, "--cache-dir").value_or(need_value(a));
+    } else if (a == "--cache-max-bytes" || a.rfind("--cache-max-bytes=", 0) == 0) {
+      std::string v =
+          get_value_inline(a, "--cache-max-bytes").value_or(need_value(a));
+      opt.cache_max_bytes = parse_size_expr(v);
+    } else if (a == "--input" || a.rfind("--input=", 0) == 0) {
+      opt.input_path = get_value_inline(a, "--input").value_or(need_value(a));
+    } else if (a == "--input-offset" || a.rfind("--input-offset=", 0) == 0) {
+      std::string v = get_value_inline(a, "--input-offset").value_or(need_value(a));
+      opt.input_offset = parse_size_expr(v);
+    } else if (a == "--input-sample") {
+      opt.input_sample = true;
+    } else if (a == "--analyze") {
+      opt.analyze = true;
     } else if (a == "--threads" || a.rfind("--threads=", 0) == 0) {
       std::string v = get_value_inline(a, "--threads").value_or(need_value(a));
       opt.threads = std::stoi(v);
@@ -1467,6 +1662,22 @@ static double median(std::vector<double> v) {
   return 0.5 * (a + b);
 }
 
+// Default plugin build cache: $XDG_CACHE_HOME/sortbench/plugins, else
+// ~/.cache/sortbench/plugins, else under the working directory
+static std::string default_plugin_cache() {
+  if (const char *x = std::getenv("XDG_CACHE_HOME"); x && *x)
+    return std::string(x) + "/sortbench/plugins";
+  if (const char *h = std::getenv("HOME"); h && *h)
+    return std::string(h) + "/.cache/sortbench/plugins";
+  return ".sortbench-cache/plugins";
+}
+
+// A plugin given as source rather than as a shared object
+static bool is_plugin_source(const std::string &path) {
+  const std::string ext = std::filesystem::path(path).extension().string();
+  return ext == ".cpp" || ext == ".cc" || ext == ".cxx";
+}
+
 static bool has_ext(const std::string &path, const char *ext1,
                     const char *ext2 = nullptr) {
   auto tolow = [](unsigned char c) {
@@ -1588,6 +1799,38 @@ static bool write_plot_dat_file(
   return true;
 }
 
+// Ctrl-C stops the current run; the algorithms that finished are still
+// reported. A second Ctrl-C terminates as usual.
+static std::atomic<bool> g_interrupted{false};
+extern "C" void on_interrupt(int) {
+  g_interrupted.store(true);
+  std::signal(SIGINT, SIG_DFL);
+}
+
+// Prints csv/jsonl rows to stdout as each algorithm finishes, so long runs
+// show results early. Only used without --baseline: speedups need every row.
+class RowStreamer : public sortbench::Observer {
+public:
+  RowStreamer(OutFmt format, bool csv_header)
+      : format_(format), csv_header_(csv_header) {}
+  void on_input(const sortbench::RunResult &r, double) override {
+    head_ = r;
+    if (format_ == OutFmt::csv && csv_header_)
+      std::cout << sortbench::to_csv(head_, true, false) << std::flush;
+  }
+  void on_row(const sortbench::ResultRow &row) override {
+    head_.rows.assign(1, row);
+    std::cout << (format_ == OutFmt::csv ? sortbench::to_csv(head_, false, false)
+                                         : sortbench::to_jsonl(head_, false))
+              << std::flush;
+  }
+
+private:
+  OutFmt format_;
+  bool csv_header_;
+  sortbench::RunResult head_;
+};
+
 template <class T> static int run_for_type(const Options &opt) {
   // Discover-only mode
   if (opt.list) {
@@ -1599,15 +1842,16 @@ template <class T> static int run_for_type(const Options &opt) {
     else if constexpr (std::is_same_v<T, float>) et = sortbench::ElemType::f32;
     else if constexpr (std::is_same_v<T, double>) et = sortbench::ElemType::f64;
     else et = sortbench::ElemType::str;
-    auto names = (opt.plugin_paths.empty()
+    auto names = (opt.plugin_paths.empty() && opt.isolated_plugin_paths.empty()
                       ? sortbench::list_algorithms(et)
-                      : sortbench::list_algorithms(et, opt.plugin_paths));
+                      : sortbench::list_algorithms(et, opt.plugin_paths,
+                                                   opt.isolated_plugin_paths));
     for (const auto &n : names) std::cout << n << "\n";
     return 0;
   }
 
   sortbench::CoreConfig cfg;
-  cfg.N = opt.N;
+  cfg.N = (opt.input_path.empty() || opt.N_set) ? opt.N : 0;
   cfg.dist = static_cast<sortbench::Dist>(static_cast<int>(opt.dist));
   if constexpr (std::is_same_v<T, int>) cfg.type = sortbench::ElemType::i32;
   else if constexpr (std::is_same_v<T, unsigned int>) cfg.type = sortbench::ElemType::u32;
@@ -1626,21 +1870,54 @@ template <class T> static int run_for_type(const Options &opt) {
   cfg.partial_shuffle_pct = opt.partial_shuffle_pct;
   cfg.dup_values = opt.dup_values;
   cfg.verify = opt.verify;
+  cfg.verify_mode = opt.verify_mode;
   cfg.assert_sorted = opt.assert_sorted;
   cfg.threads = opt.threads;
   cfg.plugin_paths = opt.plugin_paths;
+  cfg.isolated_plugin_paths = opt.isolated_plugin_paths;
   cfg.baseline = opt.baseline;
   cfg.zipf_s = opt.zipf_s;
   cfg.runs_alpha = opt.runs_alpha;
   cfg.stagger_block = opt.stagger_block;
+  cfg.adversary = opt.adversary;
+  cfg.tail_pct = opt.tail_pct;
+  cfg.displace_k = opt.displace_k;
+  cfg.clusters = opt.clusters;
+  cfg.shuffle_block = opt.shuffle_block;
+  cfg.cpus = opt.cpus;
+  cfg.spin_up = opt.spin_up;
+  cfg.schedule = opt.schedule;
+  cfg.buffers = opt.buffers;
+  cfg.reset = opt.reset;
+  cfg.placement = opt.placement;
+  cfg.isolate = opt.isolate;
+  cfg.algo_timeout_ms = opt.algo_timeout_ms;
+  cfg.cache_dir = opt.cache_dir;
+  cfg.cache_max_bytes = opt.cache_max_bytes;
+  cfg.input_path = opt.input_path;
+  cfg.input_offset = opt.input_offset;
+  cfg.input_sample = opt.input_sample;
+  cfg.analyze = opt.analyze;
 
+  const bool streamed = !opt.baseline.has_value() &&
+                        (opt.format == OutFmt::csv || opt.format == OutFmt::jsonl);
+  RowStreamer streamer(opt.format, opt.csv_header);
+  cfg.cancel = &g_interrupted;
   sortbench::RunResult r;
+  auto prev_sigint = std::signal(SIGINT, on_interrupt);
   try {
-    r = sortbench::run_benchmark(cfg);
+    r = sortbench::run_benchmark(cfg, streamed ? &streamer : nullptr);
   } catch (const std::exception &e) {
+    std::signal(SIGINT, prev_sigint);
     std::cerr << "Error: " << e.what() << "\n";
     return 2;
   }
+  std::signal(SIGINT, prev_sigint);
+  if (r.canceled)
+    std::cerr << "Interrupted: reporting the algorithms that finished\n";
+  // Run shape as measured (a file input decides N and reports dist "file")
+  const std::size_t run_N = r.N;
+  const std::string run_dist = r.dist;
 
   struct Row {
     std::string algo;
@@ -1656,6 +1933,13 @@ template <class T> static int run_for_type(const Options &opt) {
   std::vector<Row> rows;
   rows.reserve(r.rows.size());
   for (const auto &rr : r.rows) {
+    if (rr.status != "ok") {
+      // Isolated run: report and keep going; the row stays in JSON/JSONL
+      std::cerr << "Warning: " << rr.algo << ' ' << rr.status;
+      if (!rr.error.empty()) std::cerr << " (" << rr.error << ')';
+      std::cerr << "\n";
+      continue;
+    }
     rows.push_back(Row{rr.algo, r.N, r.dist, rr.stats.median_ms, rr.stats.min_ms,
                        rr.stats.max_ms, rr.stats.mean_ms, rr.stats.stddev_ms,
                        1.0});
@@ -1681,6 +1965,20 @@ template <class T> static int run_for_type(const Options &opt) {
     r.speedup =
         (baseline_med > 0.0 ? (baseline_med / std::max(1e-12, r.t)) : 1.0);
 
+  // Environment summary when placement was requested
+  if (!opt.cpus.empty() || opt.spin_up) {
+    std::cerr << "Env:";
+    for (const auto &kv : r.meta) std::cerr << ' ' << kv.first << '=' << kv.second;
+    std::cerr << "\n";
+  }
+  if (opt.analyze) {
+    std::cerr << "Input:";
+    for (const auto &kv : r.meta)
+      if (kv.first.rfind("input_", 0) == 0)
+        std::cerr << ' ' << kv.first.substr(6) << '=' << kv.second;
+    std::cerr << "\n";
+  }
+
   // Winner summary per run
   if (!rows.empty()) {
     const Row *best = &rows[0];
@@ -1694,8 +1992,8 @@ template <class T> static int run_for_type(const Options &opt) {
       }
     }
     if (opt.baseline.has_value()) {
-      std::cerr << "Winner (N=" << opt.N
-                << ", dist=" << kDistNames[static_cast<int>(opt.dist)]
+      std::cerr << "Winner (N=" << run_N
+                << ", dist=" << run_dist
                 << "): algo=" << best->algo << ", median_ms=" << best->t
                 << ", speedup_vs_baseline=" << best->speedup;
       if (baseline_med > 0.0)
@@ -1703,8 +2001,8 @@ template <class T> static int run_for_type(const Options &opt) {
                   << "' median_ms=" << baseline_med << ")";
       std::cerr << "\n";
     } else {
-      std::cerr << "Winner (N=" << opt.N
-                << ", dist=" << kDistNames[static_cast<int>(opt.dist)]
+      std::cerr << "Winner (N=" << run_N
+                << ", dist=" << run_dist
                 << "): algo=" << best->algo << ", median_ms=" << best->t
                 << "\n";
     }
@@ -1712,7 +2010,8 @@ template <class T> static int run_for_type(const Options &opt) {
 
   if (opt.format == OutFmt::csv) {
     std::string csv = sortbench::to_csv(r, opt.csv_header, opt.baseline.has_value());
-    std::cout << csv;
+    if (!streamed)
+      std::cout << csv;
     // Write to results file (unless suppressed)
     if (!opt.no_file) {
       namespace fs = std::filesystem;
@@ -1773,7 +2072,8 @@ template <class T> static int run_for_type(const Options &opt) {
     }
   } else if (opt.format == OutFmt::jsonl) {
     std::string jsonl = sortbench::to_jsonl(r, opt.baseline.has_value());
-    std::cout << jsonl;
+    if (!streamed)
+      std::cout << jsonl;
     // append to file
     if (!opt.no_file) {
       namespace fs = std::filesystem;
@@ -1894,8 +2194,8 @@ template <class T> static int run_for_type(const Options &opt) {
     } else {
       std::string title =
           opt.plot_title.empty()
-              ? (std::string("N=") + std::to_string(opt.N) + ", dist=" +
-                 std::string(kDistNames[static_cast<int>(opt.dist)]) +
+              ? (std::string("N=") + std::to_string(run_N) + ", dist=" +
+                 run_dist +
                  ", type=" + std::string(elem_type_name(opt.type)))
               : opt.plot_title;
       write_gnuplot_and_run(*opt.plot_path, opt.plot_w, opt.plot_h, title,
@@ -1905,7 +2205,7 @@ template <class T> static int run_for_type(const Options &opt) {
   }
 
   // plugin handles are managed inside the core library
-  return 0;
+  return r.canceled ? 130 : 0;
 }
 
 int main(int argc, char **argv) {
@@ -1933,29 +2233,65 @@ int main(int argc, char **argv) {
                 << "LDFLAGS=" << built_ldflags << "\n";
       return 0;
     }
+    // Plugin sources go through the build cache (see build_plugin)
+    auto build_cached = [&](const std::string &src) {
+      sortbench::PluginBuildOptions b;
+      b.source = src;
+      b.cache_dir = opt.plugin_cache ? *opt.plugin_cache : default_plugin_cache();
+      b.cxx = built_cxx;
+      b.cxxflags = built_cxxflags;
+      b.ldflags = built_ldflags;
+      b.variants = opt.plugin_variants;
+      return sortbench::build_plugin(b);
+    };
     if (opt.build_plugin_src.has_value()) {
-      if (!opt.build_plugin_out.has_value()) {
-        throw std::runtime_error("--build-plugin requires --out <lib.so>");
-      }
-      std::string cmd;
-      cmd.reserve(512);
-      cmd.append(built_cxx)
-          .append(" ")
-          .append(built_cxxflags)
-          .append(" -fPIC -shared -o ")
-          .append(*opt.build_plugin_out)
-          .append(" ")
-          .append(*opt.build_plugin_src)
-          .append(" ")
-          .append(built_ldflags);
-      int rc = std::system(cmd.c_str());
-      if (rc != 0) {
-        std::cerr << "Plugin build failed (rc=" << rc << "): " << cmd << "\n";
-        return 2;
+      namespace fs = std::filesystem;
+      const auto built = build_cached(*opt.build_plugin_src);
+      for (const auto &v : built.variants)
+        std::cout << "Variant " << sortbench::isa_level_name(v.isa) << ": "
+                  << v.path << (v.cached ? " (cached)" : " (built)") << "\n";
+      std::string path = built.path;
+      if (opt.build_plugin_out.has_value()) {
+        // Every variant goes next to --out as <stem>-<isa>.so, and --out holds
+        // the lowest one; loaders resolve the family on the CPU they run on
+        // (see resolve_plugin_variant). Copy and rename, so a process that
+        // has the old library mapped keeps it.
+        const fs::path out(*opt.build_plugin_out);
+        if (out.extension() != ".so") {
+          std::cerr << "--out must name a .so file\n";
+          return 2;
+        }
+        auto install = [](const std::string &from, const fs::path &to) {
+          const fs::path tmp = to.string() + ".tmp";
+          fs::copy_file(from, tmp, fs::copy_options::overwrite_existing);
+          fs::rename(tmp, to);
+        };
+        const sortbench::PluginVariant *lowest = nullptr;
+        for (sortbench::IsaLevel l : {sortbench::IsaLevel::baseline, sortbench::IsaLevel::avx2,
+                                      sortbench::IsaLevel::avx512}) {
+          const fs::path dst = out.parent_path() / (out.stem().string() + "-" +
+                                                    std::string(sortbench::isa_level_name(l)) + ".so");
+          const auto v = std::find_if(built.variants.begin(), built.variants.end(),
+                                      [l](const auto &x) { return x.isa == l; });
+          if (v == built.variants.end()) {
+            std::error_code ec;
+            fs::remove(dst, ec); // a level left from an earlier build is stale
+            continue;
+          }
+          install(v->path, dst);
+          if (!lowest) lowest = &*v;
+        }
+        install(lowest->path, out);
+        path = out.string();
       }
-      std::cout << "Built plugin: " << *opt.build_plugin_out << "\n";
+      std::cout << "Built plugin: " << path << " ("
+                << sortbench::isa_level_name(built.isa) << ")\n";
       return 0;
     }
+    for (auto *paths : {&opt.plugin_paths, &opt.isolated_plugin_paths})
+      for (auto &p : *paths)
+        if (is_plugin_source(p))
+          p = build_cached(p).path;
     if (opt.init_plugin_out.has_value()) {
       namespace fs = std::filesystem;
       fs::path outp(*opt.init_plugin_out);
@@ -1980,35 +2316,33 @@ int main(int argc, char **argv) {
         include_line = "#include \"../sortbench_plugin.h\"\n";
       else
         include_line = "#include \"sortbench_plugin.h\"\n";
-      of << "// Generated by sortbench --init-plugin (v2 multi-type scaffold)\n"
-         << "#include <algorithm>\n#include <vector>\n"
+      of << "// Generated by sortbench --init-plugin (v3 scaffold)\n"
+         << "#include <algorithm>\n#include <cstddef>\n"
          << include_line << "\n"
-         << "// Provide one or more type-specific entrypoints.\n"
-         << "// Return algorithms via sortbench_get_algorithms_v2.\n\n"
-         << "static void my_sort_i32(int* data, int n) { std::sort(data, "
-            "data+n); }\n"
-         << "static void my_sort_u32(unsigned int* data, int n) { "
-            "std::sort(data, data+n); }\n"
-         << "static void my_sort_i64(long long* data, int n) { std::sort(data, "
-            "data+n); }\n"
-         << "static void my_sort_u64(unsigned long long* data, int n) { "
-            "std::sort(data, data+n); }\n"
-         << "static void my_sort_f32(float* data, int n) { std::sort(data, "
-            "data+n); }\n"
-         << "static void my_sort_f64(double* data, int n) { std::sort(data, "
-            "data+n); }\n\n"
-         << "static const sortbench_algo_v2 k_algos[] = {\n"
-         << "    {\"my_sort\", &my_sort_i32, &my_sort_u32, &my_sort_i64, "
-            "&my_sort_u64, &my_sort_f32, &my_sort_f64},\n"
+         << "// Provide one or more type-specific entrypoints and return them\n"
+         << "// via sortbench_get_algorithms_v3. ctx carries the thread hint and\n"
+         << "// the scratch requested through scratch_bytes (none here).\n\n"
+         << "template <class T>\n"
+         << "static void my_sort(T* data, size_t n, const sortbench_ctx_v3*) "
+            "{ std::sort(data, data+n); }\n\n"
+         << "static const sortbench_algo_v3 k_algos[] = {\n"
+         << "    {sizeof(sortbench_algo_v3), \"my_sort\", SORTBENCH_CAP_IN_PLACE, "
+            "nullptr, nullptr,\n"
+         << "     &my_sort<int>, &my_sort<unsigned int>, &my_sort<long long>,\n"
+         << "     &my_sort<unsigned long long>, &my_sort<float>, "
+            "&my_sort<double>,\n"
+         << "     nullptr, nullptr}, // run_str, run_kv\n"
          << "};\n\n"
-         << "extern \"C\" int sortbench_get_algorithms_v2(const "
-            "sortbench_algo_v2** out_algos, int* out_count) {\n"
+         << "extern \"C\" int sortbench_get_algorithms_v3(const "
+            "sortbench_algo_v3** out_algos, size_t* out_count) {\n"
          << "    if (!out_algos || !out_count) return 0;\n"
          << "    *out_algos = k_algos;\n"
-         << "    *out_count = (int)(sizeof(k_algos)/sizeof(k_algos[0]));\n"
+         << "    *out_count = sizeof(k_algos)/sizeof(k_algos[0]);\n"
          << "    return 1;\n"
          << "}\n\n"
          << "// Optional: also expose v1 (int-only) for older harnesses.\n"
+         << "static void my_sort_i32(int* data, int n) { std::sort(data, "
+            "data+n); }\n"
          << "static const sortbench_algo_v1 k_algos_v1[] = {\n"
          << "    {\"my_sort\", &my_sort_i32},\n"
          << "};\n"
@@ -2036,6 +2370,10 @@ int main(int argc, char **argv) {
       sweep.push_back(opt.N);
     if (opt.dists.empty())
       opt.dists.push_back(opt.dist);
+    if (!opt.input_path.empty() && opt.dists.size() > 1) {
+      std::cerr << "Error: --input replaces the distribution; pass a single --dist or none\n";
+      return 2;
+    }
     bool first = true;
     int rc = 0;
     // Multiplot across distributions (single image)
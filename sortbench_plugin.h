@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -40,6 +42,90 @@ typedef struct sortbench_algo_v2 {
 // New entry point; preferred when available
 int sortbench_get_algorithms_v2(const sortbench_algo_v2** out_algos, int* out_count);
 
+// Sortbench plugin ABI v3: size_t lengths, a per-run context and declared
+// capabilities. Preferred over v2/v1 when exported.
+
+// Capability flags (sortbench_algo_v3.caps)
+#define SORTBENCH_CAP_STABLE   0x1u // equal keys keep their input order
+#define SORTBENCH_CAP_IN_PLACE 0x2u // needs no scratch proportional to n
+#define SORTBENCH_CAP_PARALLEL 0x4u // uses more than one thread (see ctx->threads)
+#define SORTBENCH_CAP_STRINGS  0x8u // supports string keys (run_str)
+
+// Phase timings and counters reported from inside a call (ctx->sink).
+// Values are summed per name over one call, and result rows carry the median
+// over the timed repeats. The calls run inside the timed region: accumulate
+// locally and report totals once per call rather than per partition. Worker
+// threads of a parallel plugin may report too (the sink locks), but only
+// until the call returns.
+typedef struct sortbench_sink_v3 {
+    void* self;
+    void (*phase_ms)(void* self, const char* name, double ms);  // e.g. "partition"
+    void (*counter)(void* self, const char* name, double value); // e.g. "partitions"
+} sortbench_sink_v3;
+
+// Handed to every call. The scratch buffer is owned by the harness and is
+// allocated and faulted in before timing starts, so it is neither timed nor
+// counted as an allocation of the algorithm; its contents are unspecified on
+// entry. It is at least 16-byte aligned.
+typedef struct sortbench_ctx_v3 {
+    void* scratch;        // NULL when scratch_bytes is 0
+    size_t scratch_bytes; // as requested through sortbench_algo_v3.scratch_bytes
+    int threads;          // thread-count hint for this run (>= 1)
+    void* user;           // sortbench_algo_v3.user, passed back unchanged
+    const sortbench_sink_v3* sink; // never NULL
+} sortbench_ctx_v3;
+
+typedef void (*sortbench_run_i32_v3_fn)(int* data, size_t n, const sortbench_ctx_v3* ctx);
+typedef void (*sortbench_run_u32_v3_fn)(unsigned int* data, size_t n, const sortbench_ctx_v3* ctx);
+typedef void (*sortbench_run_i64_v3_fn)(long long* data, size_t n, const sortbench_ctx_v3* ctx);
+typedef void (*sortbench_run_u64_v3_fn)(unsigned long long* data, size_t n, const sortbench_ctx_v3* ctx);
+typedef void (*sortbench_run_f32_v3_fn)(float* data, size_t n, const sortbench_ctx_v3* ctx);
+typedef void (*sortbench_run_f64_v3_fn)(double* data, size_t n, const sortbench_ctx_v3* ctx);
+
+// Strings are handed over as views into a harness-owned byte arena, built
+// before timing starts. Sort the views; the bytes are read-only.
+typedef struct sortbench_str_view {
+    const char* ptr;
+    size_t len;
+} sortbench_str_view;
+
+// Key/index pairs: sort ascending by key (unsigned compare). index is the
+// element's input position and must move with its key. Numeric inputs are
+// encoded so that unsigned key order is value order.
+typedef struct sortbench_kv {
+    unsigned long long key;
+    unsigned long long index;
+} sortbench_kv;
+
+typedef void (*sortbench_run_str_v3_fn)(sortbench_str_view* data, size_t n, const sortbench_ctx_v3* ctx);
+typedef void (*sortbench_run_kv_v3_fn)(sortbench_kv* data, size_t n, const sortbench_ctx_v3* ctx);
+
+typedef struct sortbench_algo_v3 {
+    // sizeof(sortbench_algo_v3) as compiled by the plugin. Fields may be
+    // appended in later revisions; the loader ignores those past this size
+    // and steps through the array by the first entry's struct_size.
+    size_t struct_size;
+    const char* name;
+    unsigned int caps;    // SORTBENCH_CAP_* bits
+    void* user;           // plugin state, handed back as ctx->user
+    // Scratch bytes wanted for n elements of elem_size bytes (NULL = none)
+    size_t (*scratch_bytes)(size_t n, size_t elem_size, void* user);
+    // Optional entry points for different types (NULL = unsupported)
+    sortbench_run_i32_v3_fn run_i32;
+    sortbench_run_u32_v3_fn run_u32;
+    sortbench_run_i64_v3_fn run_i64;
+    sortbench_run_u64_v3_fn run_u64;
+    sortbench_run_f32_v3_fn run_f32;
+    sortbench_run_f64_v3_fn run_f64;
+    // Revision 2: strings (views, elem_size = sizeof(sortbench_str_view)) and
+    // key/index pairs (elem_size = sizeof(sortbench_kv)). run_kv serves every
+    // numeric --type that has no typed entry point above.
+    sortbench_run_str_v3_fn run_str;
+    sortbench_run_kv_v3_fn run_kv;
+} sortbench_algo_v3;
+
+int sortbench_get_algorithms_v3(const sortbench_algo_v3** out_algos, size_t* out_count);
+
 #ifdef __cplusplus
 }
 #endif
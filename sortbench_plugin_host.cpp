@@ -0,0 +1,25 @@
+// sortbench-plugin-host: runs one plugin on behalf of the core
+// Started by the core for each --plugin-isolated path with its end of a
+// SOCK_SEQPACKET socket as descriptor 3 (see src/sortbench_host.hpp); not
+// meant to be run by hand.
+
+#include "src/sortbench_host.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <string>
+
+int main(int argc, char **argv) {
+  if (argc != 2 || std::strcmp(argv[1], "--help") == 0) {
+    std::fprintf(stderr, "Usage: %s PLUGIN.so  (started by sortbench with fd %d connected)\n",
+                 argv[0], sortbench::host::kSocketFd);
+    return 2;
+  }
+  try {
+    return sortbench::host::serve(sortbench::host::kSocketFd, argv[1]);
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "Error: %s\n", e.what());
+    return 1;
+  }
+}
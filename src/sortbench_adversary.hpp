@@ -0,0 +1,106 @@
+// sortbench core: adversarial inputs for comparison sorts (private)
+// McIlroy, "A Killer Adversary for Quicksort" (1999): sort item indices with
+// a comparator that decides values lazily. Undecided items are "gas" (above
+// every decided value); when two gas items meet, one is frozen to the next
+// value, sparing the one that looks like the pivot. The values the sort saw
+// form an input that sends the same deterministic algorithm down that path.
+
+#pragma once
+
+#include "sortbench_gen.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sortbench::adversary {
+
+// Lazily valued comparisons for one adversary run
+class Oracle {
+public:
+  explicit Oracle(std::size_t n) : val_(n, kGas) {}
+
+  int compare(std::uint32_t x, std::uint32_t y) {
+    ++comparisons_;
+    if (val_[x] == kGas && val_[y] == kGas)
+      val_[x == candidate_ ? x : y] = solid_++;
+    if (val_[x] == kGas)
+      candidate_ = x;
+    else if (val_[y] == kGas)
+      candidate_ = y;
+    return val_[x] < val_[y] ? -1 : (val_[x] > val_[y] ? 1 : 0);
+  }
+  // Freeze what is left; element i of the killer input has rank result[i]
+  std::vector<std::uint32_t> finish() {
+    for (auto &v : val_)
+      if (v == kGas) v = solid_++;
+    return std::move(val_);
+  }
+  std::uint64_t comparisons() const { return comparisons_; }
+
+private:
+  static constexpr std::uint32_t kGas = std::numeric_limits<std::uint32_t>::max();
+  std::vector<std::uint32_t> val_;
+  std::uint32_t solid_ = 0;
+  std::uint32_t candidate_ = 0;
+  std::uint64_t comparisons_ = 0;
+};
+
+inline thread_local Oracle *tl_oracle = nullptr;
+
+// Element type the target sort runs on; every comparison asks the oracle
+struct Item {
+  std::uint32_t id;
+};
+inline bool operator<(Item a, Item b) { return tl_oracle->compare(a.id, b.id) < 0; }
+inline bool operator>(Item a, Item b) { return tl_oracle->compare(a.id, b.id) > 0; }
+inline bool operator<=(Item a, Item b) { return tl_oracle->compare(a.id, b.id) <= 0; }
+inline bool operator>=(Item a, Item b) { return tl_oracle->compare(a.id, b.id) >= 0; }
+
+struct Killer {
+  std::vector<std::uint32_t> ranks; // a permutation of [0, n)
+  std::uint64_t comparisons = 0;    // made by the target while building it
+};
+
+// Run `sort` (single-threaded, comparison-only) once against the oracle
+template <class Sort> Killer build(std::size_t n, Sort &&sort) {
+  if (n >= std::numeric_limits<std::uint32_t>::max())
+    throw std::runtime_error("adversarial input is limited to 2^32-1 elements");
+  Oracle oracle(n);
+  std::vector<Item> items(n);
+  for (std::size_t i = 0; i < n; ++i) items[i].id = static_cast<std::uint32_t>(i);
+  Oracle *prev = std::exchange(tl_oracle, &oracle);
+  try {
+    sort(std::span<Item>(items));
+  } catch (...) {
+    tl_oracle = prev;
+    throw;
+  }
+  tl_oracle = prev;
+  return {oracle.finish(), oracle.comparisons()};
+}
+
+// Ranks as values of T; strings are zero-padded so they compare like numbers
+template <class T> std::vector<T> to_values(const std::vector<std::uint32_t> &ranks) {
+  const std::size_t n = ranks.size();
+  std::vector<T> v(n);
+  if constexpr (std::is_same_v<T, std::string>) {
+    const std::size_t width = std::to_string(n ? n - 1 : 0).size();
+    gen::for_each_index(n, [&](std::size_t i) {
+      std::string s = std::to_string(ranks[i]);
+      v[i] = std::string(width - s.size(), '0') + s;
+    });
+  } else {
+    gen::for_each_index(n, [&](std::size_t i) { v[i] = static_cast<T>(ranks[i]); });
+  }
+  return v;
+}
+
+} // namespace sortbench::adversary
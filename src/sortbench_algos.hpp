@@ -0,0 +1,332 @@
+// sortbench core: built-in sort algorithms (private to the core library)
+// sortbench_kernels.cpp includes this file again once per instruction-set
+// level with SB_ALGOS_NS set, each time inside a `#pragma GCC target`
+// region, so the guard below only covers the default sortbench::algos.
+
+#if defined(SB_ALGOS_NS) || !defined(SORTBENCH_ALGOS_HPP)
+#ifndef SB_ALGOS_NS
+#define SORTBENCH_ALGOS_HPP
+#define SB_ALGOS_NS algos
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sortbench::SB_ALGOS_NS {
+
+template <class Iter> inline void insertion_sort(Iter first, Iter last) {
+  for (Iter i = first + (first == last ? 0 : 1); i < last; ++i) {
+    auto key = *i;
+    Iter j = i;
+    while (j > first && *(j - 1) > key) {
+      *j = *(j - 1);
+      --j;
+    }
+    *j = key;
+  }
+}
+
+template <class T> inline void heap_sort(std::span<T> v) {
+  std::make_heap(v.begin(), v.end());
+  std::sort_heap(v.begin(), v.end());
+}
+
+template <class T> inline void insertion_sort_full(std::span<T> v) {
+  insertion_sort(v.begin(), v.end());
+}
+
+template <class T> inline void selection_sort(std::span<T> v) {
+  const std::size_t n = v.size();
+  for (std::size_t i = 0; i + 1 < n; ++i) {
+    std::size_t min_i = i;
+    for (std::size_t j = i + 1; j < n; ++j) if (v[j] < v[min_i]) min_i = j;
+    if (min_i != i) std::swap(v[i], v[min_i]);
+  }
+}
+
+template <class T> inline void bubble_sort(std::span<T> v) {
+  const std::size_t n = v.size();
+  if (n < 2) return;
+  bool swapped = true;
+  for (std::size_t pass = 0; pass < n - 1 && swapped; ++pass) {
+    swapped = false;
+    for (std::size_t i = 0; i + 1 < n - pass; ++i) {
+      if (v[i + 1] < v[i]) { std::swap(v[i], v[i + 1]); swapped = true; }
+    }
+  }
+}
+
+template <class T> inline void comb_sort(std::span<T> v) {
+  const std::size_t n = v.size();
+  if (n < 2) return;
+  double gap = (double)n;
+  const double shrink = 1.3;
+  bool swapped = true;
+  while (gap > 1.0 || swapped) {
+    gap = std::floor(gap / shrink);
+    if (gap < 1.0) gap = 1.0;
+    std::size_t igap = static_cast<std::size_t>(gap);
+    swapped = false;
+    for (std::size_t i = 0; i + igap < n; ++i) {
+      std::size_t j = i + igap;
+      if (v[j] < v[i]) { std::swap(v[i], v[j]); swapped = true; }
+    }
+  }
+}
+
+template <class T> inline void shell_sort(std::span<T> v) {
+  static const int ciura_base[] = {1, 4, 10, 23, 57, 132, 301, 701};
+  std::vector<int> gaps(ciura_base, ciura_base + (sizeof(ciura_base)/sizeof(int)));
+  while ((long long)gaps.back() * 2.25 < (long long)v.size()) {
+    gaps.push_back(int(gaps.back() * 2.25));
+  }
+  for (int gi = (int)gaps.size() - 1; gi >= 0; --gi) {
+    int gap = gaps[gi]; if (gap <= 0) continue;
+    for (std::size_t i = gap; i < v.size(); ++i) {
+      auto tmp = v[i];
+      std::size_t j = i;
+      while (j >= (std::size_t)gap && tmp < v[j - gap]) {
+        v[j] = v[j - gap];
+        j -= gap;
+      }
+      v[j] = tmp;
+    }
+  }
+}
+
+template <class T> inline void merge_sort_opt(std::span<T> v) {
+  const std::size_t n = v.size();
+  if (n < 2)
+    return;
+  std::vector<T> buf(n);
+  for (std::size_t width = 1; width < n; width <<= 1) {
+    for (std::size_t i = 0; i < n; i += (width << 1)) {
+      std::size_t left = i;
+      std::size_t mid = std::min(i + width, n);
+      std::size_t right = std::min(i + (width << 1), n);
+      if (mid >= right)
+        continue;
+      std::size_t a = left, b = mid, k = left;
+      while (a < mid && b < right) {
+        if (v[a] <= v[b])
+          buf[k++] = v[a++];
+        else
+          buf[k++] = v[b++];
+      }
+      if (a < mid) {
+        std::copy(v.begin() + static_cast<std::ptrdiff_t>(a),
+                  v.begin() + static_cast<std::ptrdiff_t>(mid),
+                  buf.begin() + static_cast<std::ptrdiff_t>(k));
+        k += (mid - a);
+      }
+      if (b < right) {
+        std::copy(v.begin() + static_cast<std::ptrdiff_t>(b),
+                  v.begin() + static_cast<std::ptrdiff_t>(right),
+                  buf.begin() + static_cast<std::ptrdiff_t>(k));
+        k += (right - b);
+      }
+      std::copy(buf.begin() + static_cast<std::ptrdiff_t>(left),
+                buf.begin() + static_cast<std::ptrdiff_t>(right),
+                v.begin() + static_cast<std::ptrdiff_t>(left));
+    }
+  }
+}
+
+template <class Iter> inline void quicksort_hybrid_impl(Iter first, Iter last) {
+  constexpr int INSERTION_THRESHOLD = 64;
+  while (last - first > INSERTION_THRESHOLD) {
+    Iter a = first, b = last - 1, m = first + (last - first) / 2;
+    if (*m < *a)
+      std::iter_swap(m, a);
+    if (*b < *m)
+      std::iter_swap(b, m);
+    if (*m < *a)
+      std::iter_swap(m, a);
+    auto pivot = *m;
+    Iter i = first - 1, j = last;
+    for (;;) {
+      do {
+        ++i;
+      } while (*i < pivot);
+      do {
+        --j;
+      } while (pivot < *j);
+      if (i >= j)
+        break;
+      std::iter_swap(i, j);
+    }
+    if (j - first < last - (j + 1)) {
+      quicksort_hybrid_impl(first, j + 1);
+      first = j + 1;
+    } else {
+      quicksort_hybrid_impl(j + 1, last);
+      last = j + 1;
+    }
+  }
+  insertion_sort(first, last);
+}
+
+template <class T> inline void quicksort_hybrid(std::span<T> v) {
+  if (!v.empty())
+    quicksort_hybrid_impl(v.begin(), v.end());
+}
+
+template <class Iter> inline void quicksort_3way_impl(Iter lo, Iter hi) {
+  while (hi - lo > 64) {
+    Iter i = lo, lt = lo, gt = hi - 1;
+    auto pivot = *(lo + (hi - lo) / 2);
+    while (i <= gt) {
+      if (*i < pivot) { std::iter_swap(lt++, i++); }
+      else if (pivot < *i) { std::iter_swap(i, gt--); }
+      else { ++i; }
+    }
+    auto left_size = lt - lo;
+    auto right_size = hi - (gt + 1);
+    if (left_size < right_size) {
+      if (left_size > 1) quicksort_3way_impl(lo, lt);
+      lo = gt + 1;
+    } else {
+      if (right_size > 1) quicksort_3way_impl(gt + 1, hi);
+      hi = lt;
+    }
+  }
+  insertion_sort(lo, hi);
+}
+
+template <class T> inline void quicksort_3way(std::span<T> v) {
+  if (!v.empty()) quicksort_3way_impl(v.begin(), v.end());
+}
+
+// TimSort (simplified) — copy of CLI version core pieces
+template <class T>
+static inline void binary_insertion_sort(std::span<T> v, std::size_t lo,
+                                         std::size_t hi) {
+  for (std::size_t i = lo + 1; i < hi; ++i) {
+    T x = v[i];
+    std::size_t left = lo, right = i;
+    while (left < right) {
+      std::size_t mid = left + ((right - left) >> 1);
+      if (!(x < v[mid]))
+        left = mid + 1;
+      else
+        right = mid;
+    }
+    for (std::size_t j = i; j > left; --j)
+      v[j] = v[j - 1];
+    v[left] = x;
+  }
+}
+
+template <class T>
+static inline void merge_runs(std::span<T> v, std::vector<T> &tmp,
+                              std::size_t lo, std::size_t mid, std::size_t hi) {
+  std::size_t i = lo, j = mid, k = lo;
+  while (i < mid && j < hi)
+    tmp[k++] = (v[i] <= v[j] ? v[i++] : v[j++]);
+  if (i < mid) {
+    std::copy(v.begin() + static_cast<std::ptrdiff_t>(i),
+              v.begin() + static_cast<std::ptrdiff_t>(mid),
+              tmp.begin() + static_cast<std::ptrdiff_t>(k));
+    k += (mid - i);
+  }
+  if (j < hi) {
+    std::copy(v.begin() + static_cast<std::ptrdiff_t>(j),
+              v.begin() + static_cast<std::ptrdiff_t>(hi),
+              tmp.begin() + static_cast<std::ptrdiff_t>(k));
+    k += (hi - j);
+  }
+  std::copy(tmp.begin() + static_cast<std::ptrdiff_t>(lo),
+            tmp.begin() + static_cast<std::ptrdiff_t>(hi),
+            v.begin() + static_cast<std::ptrdiff_t>(lo));
+}
+
+template <class T> inline void timsort(std::span<T> v) {
+  const std::size_t n = v.size();
+  if (n < 2)
+    return;
+  std::vector<T> tmp(n);
+  auto next_run = [&](std::size_t i) {
+    std::size_t j = i + 1;
+    if (j >= n)
+      return n;
+    if (v[j] < v[i]) {
+      while (j < n && v[j] < v[j - 1])
+        ++j;
+      std::reverse(v.begin() + static_cast<std::ptrdiff_t>(i),
+                   v.begin() + static_cast<std::ptrdiff_t>(j));
+    } else {
+      while (j < n && !(v[j] < v[j - 1]))
+        ++j;
+    }
+    return j;
+  };
+  const std::size_t MINRUN = 32;
+  std::vector<std::pair<std::size_t, std::size_t>> runs;
+  for (std::size_t i = 0; i < n;) {
+    std::size_t j = next_run(i);
+    if (j - i < MINRUN) {
+      std::size_t hi = std::min(n, i + MINRUN);
+      binary_insertion_sort(v, i, hi);
+      j = hi;
+    }
+    runs.emplace_back(i, j);
+    i = j;
+  }
+  while (runs.size() > 1) {
+    std::vector<std::pair<std::size_t, std::size_t>> nr;
+    for (std::size_t i = 0; i + 1 < runs.size(); i += 2) {
+      auto [a, b] = runs[i];
+      auto [c, d] = runs[i + 1];
+      merge_runs(v, tmp, a, b, d);
+      nr.emplace_back(a, d);
+    }
+    if (runs.size() % 2 == 1)
+      nr.push_back(runs.back());
+    runs.swap(nr);
+  }
+}
+
+template <class T> inline void radix_sort_lsd(std::span<T> v) {
+  static_assert(std::is_integral_v<T>, "radix_sort_lsd expects integral type");
+  using U = std::make_unsigned_t<T>;
+  const std::size_t n = v.size();
+  std::vector<T> tmp(n);
+  constexpr int B = 8;
+  constexpr int K = (int)(sizeof(U) * 8 / B);
+  std::array<std::size_t, 256> cnt{};
+  auto pass = [&](int shift, bool signed_fix) {
+    cnt.fill(0);
+    for (std::size_t i = 0; i < n; ++i) {
+      U x = (U)v[i];
+      if (signed_fix)
+        x ^= (U(1) << (sizeof(U) * 8 - 1));
+      unsigned idx = (unsigned)((x >> shift) & 0xFFu);
+      ++cnt[idx];
+    }
+    std::array<std::size_t, 256> pos{};
+    std::size_t run = 0;
+    for (int i = 0; i < 256; ++i)
+      pos[(unsigned)i] = std::exchange(run, run + cnt[(unsigned)i]);
+    for (std::size_t i = 0; i < n; ++i) {
+      U x = (U)v[i];
+      if (signed_fix)
+        x ^= (U(1) << (sizeof(U) * 8 - 1));
+      unsigned idx = (unsigned)((x >> shift) & 0xFFu);
+      tmp[pos[idx]++] = v[i];
+    }
+    std::copy(tmp.begin(), tmp.end(), v.begin());
+  };
+  for (int pass_i = 0; pass_i < K; ++pass_i)
+    pass(pass_i * B, std::is_signed_v<T>);
+}
+
+} // namespace sortbench::SB_ALGOS_NS
+
+#undef SB_ALGOS_NS
+#endif
@@ -0,0 +1,184 @@
+// sortbench core: allocation accounting via replaced operator new/delete
+
+#include "sortbench_alloc.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+#include <malloc.h>
+#include <sys/resource.h>
+#define SB_ALLOC_LINUX 1
+#else
+#define SB_ALLOC_LINUX 0
+#endif
+
+#if !defined(SORTBENCH_NO_ALLOC_HOOKS) && !SB_ALLOC_LINUX
+#define SORTBENCH_NO_ALLOC_HOOKS 1 // needs malloc_usable_size
+#endif
+
+namespace sortbench::alloc {
+
+namespace {
+std::atomic<int> g_armed{0};           // scopes currently armed
+std::atomic<std::uint64_t> g_arms{0};  // scopes ever armed
+std::atomic<std::int64_t> g_cur{0};
+std::atomic<std::int64_t> g_peak{0};
+std::atomic<std::uint64_t> g_count{0};
+
+long minor_faults_now() {
+#if SB_ALLOC_LINUX
+  struct rusage ru {};
+  if (getrusage(RUSAGE_SELF, &ru) == 0) return ru.ru_minflt;
+#endif
+  return 0;
+}
+} // namespace
+
+#if !defined(SORTBENCH_NO_ALLOC_HOOKS)
+namespace {
+inline void note_alloc(void *p) {
+  if (!p || g_armed.load(std::memory_order_relaxed) == 0) return;
+  auto sz = static_cast<std::int64_t>(malloc_usable_size(p));
+  g_count.fetch_add(1, std::memory_order_relaxed);
+  std::int64_t cur = g_cur.fetch_add(sz, std::memory_order_relaxed) + sz;
+  std::int64_t pk = g_peak.load(std::memory_order_relaxed);
+  while (cur > pk &&
+         !g_peak.compare_exchange_weak(pk, cur, std::memory_order_relaxed)) {
+  }
+}
+
+inline void note_free(void *p) {
+  if (!p || g_armed.load(std::memory_order_relaxed) == 0) return;
+  g_cur.fetch_sub(static_cast<std::int64_t>(malloc_usable_size(p)),
+                  std::memory_order_relaxed);
+}
+
+void *raw_alloc(std::size_t n, std::size_t align) {
+  if (n == 0) n = 1;
+  for (;;) {
+    void *p = nullptr;
+    if (align > alignof(std::max_align_t)) {
+      if (posix_memalign(&p, align, n) != 0) p = nullptr;
+    } else {
+      p = std::malloc(n);
+    }
+    if (p) {
+      note_alloc(p);
+      return p;
+    }
+    std::new_handler h = std::get_new_handler();
+    if (!h) return nullptr;
+    h();
+  }
+}
+
+void *throwing_alloc(std::size_t n, std::size_t align) {
+  void *p = raw_alloc(n, align);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+inline void raw_free(void *p) noexcept {
+  note_free(p);
+  std::free(p);
+}
+} // namespace
+#endif
+
+bool hooks_enabled() {
+#if defined(SORTBENCH_NO_ALLOC_HOOKS)
+  return false;
+#else
+  return true;
+#endif
+}
+
+Scope::Scope() {
+  minflt0_ = minor_faults_now();
+  // The first scope in resets the counters; later ones share them
+  if (g_armed.fetch_add(1, std::memory_order_acq_rel) == 0) {
+    g_cur.store(0, std::memory_order_relaxed);
+    g_peak.store(0, std::memory_order_relaxed);
+    g_count.store(0, std::memory_order_relaxed);
+  } else {
+    overlapped_ = true;
+  }
+  arm_ = g_arms.fetch_add(1, std::memory_order_acq_rel) + 1;
+}
+
+Scope::~Scope() {
+  if (!done_) g_armed.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+Stats Scope::finish() {
+  Stats s;
+  s.peak_extra_bytes =
+      static_cast<std::uint64_t>(g_peak.load(std::memory_order_relaxed));
+  s.alloc_count = g_count.load(std::memory_order_relaxed);
+  long d = minor_faults_now() - minflt0_;
+  s.minor_faults = d > 0 ? static_cast<std::uint64_t>(d) : 0;
+  // Anyone who armed after us, up to this read, shared our counters
+  s.overlapped = overlapped_ || g_arms.load(std::memory_order_acquire) != arm_;
+  g_armed.fetch_sub(1, std::memory_order_acq_rel);
+  done_ = true;
+  return s;
+}
+
+} // namespace sortbench::alloc
+
+#if !defined(SORTBENCH_NO_ALLOC_HOOKS)
+using sortbench::alloc::raw_alloc;
+using sortbench::alloc::raw_free;
+using sortbench::alloc::throwing_alloc;
+
+constexpr std::size_t kDefaultAlign = alignof(std::max_align_t);
+
+void *operator new(std::size_t n) { return throwing_alloc(n, kDefaultAlign); }
+void *operator new[](std::size_t n) { return throwing_alloc(n, kDefaultAlign); }
+void *operator new(std::size_t n, const std::nothrow_t &) noexcept {
+  return raw_alloc(n, kDefaultAlign);
+}
+void *operator new[](std::size_t n, const std::nothrow_t &) noexcept {
+  return raw_alloc(n, kDefaultAlign);
+}
+void *operator new(std::size_t n, std::align_val_t a) {
+  return throwing_alloc(n, static_cast<std::size_t>(a));
+}
+void *operator new[](std::size_t n, std::align_val_t a) {
+  return throwing_alloc(n, static_cast<std::size_t>(a));
+}
+void *operator new(std::size_t n, std::align_val_t a,
+                   const std::nothrow_t &) noexcept {
+  return raw_alloc(n, static_cast<std::size_t>(a));
+}
+void *operator new[](std::size_t n, std::align_val_t a,
+                     const std::nothrow_t &) noexcept {
+  return raw_alloc(n, static_cast<std::size_t>(a));
+}
+
+void operator delete(void *p) noexcept { raw_free(p); }
+void operator delete[](void *p) noexcept { raw_free(p); }
+void operator delete(void *p, std::size_t) noexcept { raw_free(p); }
+void operator delete[](void *p, std::size_t) noexcept { raw_free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { raw_free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { raw_free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { raw_free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { raw_free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+  raw_free(p);
+}
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {
+  raw_free(p);
+}
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept {
+  raw_free(p);
+}
+void operator delete[](void *p, std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+  raw_free(p);
+}
+#endif
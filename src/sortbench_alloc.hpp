@@ -0,0 +1,42 @@
+// sortbench core: allocation accounting (private to the core library)
+// Global operator new/delete are replaced in sortbench_alloc.cpp and count
+// only while a Scope is armed, so untimed code pays a single relaxed load.
+// Build with -DSORTBENCH_NO_ALLOC_HOOKS to leave the host's allocator alone
+// (byte/count figures then stay zero; page faults are still reported).
+
+#pragma once
+
+#include <cstdint>
+
+namespace sortbench::alloc {
+
+struct Stats {
+  std::uint64_t peak_extra_bytes = 0; // high-water mark above the start
+  std::uint64_t alloc_count = 0;      // operator new calls
+  std::uint64_t minor_faults = 0;     // getrusage(RUSAGE_SELF) ru_minflt delta
+  // Another scope was armed at the same time (a concurrent run): the
+  // counters are process-wide, so the figures include its activity too
+  bool overlapped = false;
+};
+
+// True when the operator new/delete hooks are compiled in
+bool hooks_enabled();
+
+// Arms the counters for the lifetime of the scope. Scopes may overlap
+// across threads; Stats::overlapped then marks the figures as shared.
+class Scope {
+public:
+  Scope();
+  ~Scope();
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+  Stats finish(); // disarm and return the figures for this scope
+
+private:
+  long minflt0_ = 0;
+  std::uint64_t arm_ = 0;  // g_arms value right after this scope armed
+  bool overlapped_ = false;
+  bool done_ = false;
+};
+
+} // namespace sortbench::alloc
@@ -0,0 +1,135 @@
+// sortbench core: input shape profile (private)
+// One parallel pass over the input for runs, sorted prefix/suffix and a
+// HyperLogLog distinct count; inversions and entropy come from a fixed
+// random sample. Reported as meta so timings can be related to structure.
+
+#pragma once
+
+#include "sortbench_gen.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sortbench::analyze {
+
+constexpr int kHllBits = 14;                        // 16384 registers, ~0.8% error
+constexpr std::size_t kSample = std::size_t{1} << 16; // pairs / values sampled
+
+// Per-chunk partials of the single pass
+struct Pass {
+  std::size_t descents = 0;
+  std::size_t first_descent = SIZE_MAX; // index i with v[i] < v[i-1]
+  std::size_t last_descent = 0;
+  std::vector<std::uint8_t> hll = std::vector<std::uint8_t>(std::size_t{1} << kHllBits);
+};
+
+inline double hll_estimate(const std::vector<std::uint8_t> &reg) {
+  const double m = static_cast<double>(reg.size());
+  double sum = 0.0;
+  std::size_t zeros = 0;
+  for (std::uint8_t r : reg) {
+    sum += std::ldexp(1.0, -r);
+    zeros += r == 0;
+  }
+  double e = (0.7213 / (1.0 + 1.079 / m)) * m * m / sum;
+  if (e <= 2.5 * m && zeros) e = m * std::log(m / static_cast<double>(zeros));
+  return e;
+}
+
+inline std::string fmt(const char *f, double x) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), f, x);
+  return buf;
+}
+
+// input_runs, input_mean_run, input_sorted_prefix, input_sorted_suffix,
+// input_distinct, input_inversion_ratio, input_entropy_bits
+template <class T>
+std::vector<std::pair<std::string, std::string>> profile(std::span<const T> v) {
+  const std::size_t n = v.size();
+  std::vector<std::pair<std::string, std::string>> out;
+  if (n == 0) return out;
+
+  const std::size_t chunks = std::clamp<std::size_t>(n / 65536, 1, 64);
+  std::vector<Pass> part(chunks);
+  gen::for_each_index(
+      chunks,
+      [&](std::size_t c) {
+        Pass &p = part[c];
+        const std::size_t b = n * c / chunks, e = n * (c + 1) / chunks;
+        for (std::size_t i = b; i < e; ++i) {
+          if (i > 0 && v[i] < v[i - 1]) {
+            ++p.descents;
+            p.first_descent = std::min(p.first_descent, i);
+            p.last_descent = i;
+          }
+          const std::uint64_t h = gen::hash_value(v[i]);
+          const std::size_t reg = static_cast<std::size_t>(h >> (64 - kHllBits));
+          const auto rank = static_cast<std::uint8_t>(
+              std::countl_zero((h << kHllBits) | (std::uint64_t{1} << (kHllBits - 1))) + 1);
+          p.hll[reg] = std::max(p.hll[reg], rank);
+        }
+      },
+      2);
+  Pass all;
+  for (const Pass &p : part) {
+    all.descents += p.descents;
+    if (p.descents) {
+      all.first_descent = std::min(all.first_descent, p.first_descent);
+      all.last_descent = std::max(all.last_descent, p.last_descent);
+    }
+    for (std::size_t r = 0; r < all.hll.size(); ++r) all.hll[r] = std::max(all.hll[r], p.hll[r]);
+  }
+  const std::size_t runs = all.descents + 1;
+  out.emplace_back("input_runs", std::to_string(runs));
+  out.emplace_back("input_mean_run",
+                   fmt("%.1f", static_cast<double>(n) / static_cast<double>(runs)));
+  out.emplace_back("input_sorted_prefix",
+                   std::to_string(all.descents ? all.first_descent : n));
+  out.emplace_back("input_sorted_suffix",
+                   std::to_string(all.descents ? n - all.last_descent : n));
+  out.emplace_back("input_distinct",
+                   fmt("%.0f", std::min(hll_estimate(all.hll), static_cast<double>(n))));
+
+  // Fixed-seed sample: the fraction of inverted pairs (0 sorted, ~0.5
+  // random, 1 reversed) and the entropy of sampled values (at most 16 bits)
+  const gen::Stream s(0x5EED5A3B1E5ULL, 7);
+  std::size_t inverted = 0;
+  if (n > 1) {
+    for (std::size_t k = 0; k < kSample; ++k) {
+      std::size_t i = static_cast<std::size_t>(s.below(2 * k, n));
+      std::size_t j = static_cast<std::size_t>(s.below(2 * k + 1, n - 1));
+      if (j >= i) ++j;
+      if (j < i) std::swap(i, j);
+      inverted += v[j] < v[i];
+    }
+  }
+  out.emplace_back("input_inversion_ratio",
+                   fmt("%.4f", static_cast<double>(inverted) / static_cast<double>(kSample)));
+  const std::size_t m = std::min(n, kSample);
+  std::vector<T> sample(m);
+  for (std::size_t k = 0; k < m; ++k)
+    sample[k] = v[m == n ? k : static_cast<std::size_t>(s.below(2 * kSample + k, n))];
+  std::sort(sample.begin(), sample.end());
+  double entropy = 0.0;
+  for (std::size_t i = 0; i < m;) {
+    std::size_t j = i + 1;
+    while (j < m && !(sample[i] < sample[j])) ++j;
+    const double p = static_cast<double>(j - i) / static_cast<double>(m);
+    entropy -= p * std::log2(p);
+    i = j;
+  }
+  out.emplace_back("input_entropy_bits", fmt("%.2f", entropy));
+  return out;
+}
+
+} // namespace sortbench::analyze
@@ -0,0 +1,117 @@
+// sortbench core: storage for the input/work buffers (private)
+// BufferMode::standard keeps the plain std::vector behaviour; the other modes,
+// and any placement other than local, put trivially copyable element types in
+// page-backed regions (huge pages, pre-faulted, NUMA-placed). std::string
+// always stays on the heap.
+
+#pragma once
+
+#include "sortbench/core.hpp"
+#include "sortbench_sys.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sortbench::detail {
+
+template <class T> class Buffer {
+public:
+  static constexpr bool kMappable = std::is_trivially_copyable_v<T>;
+
+  Buffer() = default;
+  Buffer(std::size_t n, BufferMode mode, Placement placement = Placement::local) {
+    allocate(n, mode, placement);
+  }
+  // Take ownership of generated data, relocating it if `mode` needs pages
+  Buffer(std::vector<T> &&v, BufferMode mode) {
+    if (!kMappable || mode == BufferMode::standard) {
+      vec_ = std::move(v);
+      n_ = vec_.size();
+      data_ = vec_.data();
+      backing_ = "heap";
+      return;
+    }
+    allocate(v.size(), mode, Placement::local);
+    std::copy(v.begin(), v.end(), data_);
+    std::vector<T>().swap(v);
+  }
+  // Adopt an existing mapping (e.g. a cached dataset or an input file)
+  // holding n elements starting `byte_offset` bytes in
+  Buffer(sys::Region r, std::size_t n, std::size_t byte_offset = 0)
+      : region_(std::move(r)), n_(n) {
+    data_ = reinterpret_cast<T *>(static_cast<char *>(region_.ptr) + byte_offset);
+    backing_ = region_.backing;
+  }
+  ~Buffer() { release(); }
+  Buffer(Buffer &&o) noexcept { *this = std::move(o); }
+  Buffer &operator=(Buffer &&o) noexcept {
+    if (this != &o) {
+      release();
+      vec_ = std::move(o.vec_);
+      region_ = std::exchange(o.region_, sys::Region{});
+      n_ = std::exchange(o.n_, 0);
+      data_ = std::exchange(o.data_, nullptr); // vector moves keep their storage
+      backing_ = std::move(o.backing_);
+      snapshot_ = std::move(o.snapshot_);
+    }
+    return *this;
+  }
+  Buffer(const Buffer &) = delete;
+  Buffer &operator=(const Buffer &) = delete;
+
+  // Copy of the contents in a sealed memfd, mapped read-only: forked
+  // children share it in place, and a snapshot reset maps views of the same
+  // descriptor (heap-only element types rely on fork's copy-on-write instead)
+  Buffer sealed() const
+    requires kMappable
+  {
+    auto snap = std::make_shared<const sys::Snapshot>(data_, n_ * sizeof(T));
+    Buffer b(snap->read_only(), n_);
+    b.snapshot_ = std::move(snap);
+    return b;
+  }
+  // The sealed memfd holding the contents; null unless made by sealed()
+  const sys::Snapshot *snapshot() const { return snapshot_.get(); }
+
+  std::span<T> span() { return {data_, n_}; }
+  std::span<const T> span() const { return {data_, n_}; }
+  std::size_t size() const { return n_; }
+  const std::string &backing() const { return backing_; }
+
+private:
+  void allocate(std::size_t n, BufferMode mode, Placement placement) {
+    n_ = n;
+    if (!kMappable || (mode == BufferMode::standard && placement == Placement::local)) {
+      vec_.resize(n);
+      data_ = vec_.data();
+      backing_ = "heap";
+      return;
+    }
+    region_ = sys::map_region(n * sizeof(T), mode == BufferMode::huge,
+                              /*prefault=*/true, placement);
+    data_ = static_cast<T *>(region_.ptr);
+    backing_ = region_.backing;
+  }
+  void release() {
+    if (region_.ptr) sys::unmap_region(region_);
+    vec_.clear();
+    data_ = nullptr;
+    n_ = 0;
+    snapshot_.reset();
+  }
+
+  std::vector<T> vec_;
+  sys::Region region_;
+  std::size_t n_ = 0;
+  T *data_ = nullptr;
+  std::string backing_;
+  std::shared_ptr<const sys::Snapshot> snapshot_;
+};
+
+} // namespace sortbench::detail
@@ -0,0 +1,308 @@
+// sortbench core: plugin build cache
+// <cache_dir>/<stem>-<hash>-<isa>.so, where the hash covers everything that
+// changes the output: the source and the #includes it reaches through its
+// own directory and the -iquote/-I directories of the flags, the
+// compiler's --version, the flags and the ISA level. A hit never runs the
+// compiler; a miss compiles to a temp file and renames it into place, so
+// concurrent builders never see a partial library.
+
+#include "sortbench/core.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+// Defaults: the toolchain the core itself was built with (see Makefile)
+#ifndef SORTBENCH_CXX
+#define SORTBENCH_CXX "g++"
+#endif
+#ifndef SORTBENCH_CXXFLAGS
+#define SORTBENCH_CXXFLAGS "-O3 -std=c++20"
+#endif
+#ifndef SORTBENCH_LDFLAGS
+#define SORTBENCH_LDFLAGS ""
+#endif
+
+namespace sortbench {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+#if defined(__x86_64__)
+constexpr bool kX86 = true;
+#else
+constexpr bool kX86 = false;
+#endif
+
+void fnv1a(std::uint64_t &h, std::string_view s) {
+  for (unsigned char c : s) {
+    h ^= c;
+    h *= 0x100000001b3ULL;
+  }
+}
+
+std::string read_file(const fs::path &p) {
+  std::ifstream in(p, std::ios::binary);
+  if (!in) throw std::runtime_error("cannot read " + p.string());
+  std::ostringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+// User include directories in compiler flags, in the compiler's search order
+// (system directories and the headers in them are covered by --version)
+struct IncludeDirs {
+  std::vector<fs::path> quote; // -iquote: "..." only
+  std::vector<fs::path> user;  // -I: "..." and <...>
+};
+
+IncludeDirs include_dirs(const std::string &flags) {
+  IncludeDirs dirs;
+  std::istringstream in(flags);
+  for (std::string tok; in >> tok;) {
+    std::vector<fs::path> *list = nullptr;
+    std::string dir;
+    if (tok.rfind("-iquote", 0) == 0) {
+      list = &dirs.quote;
+      dir = tok.substr(7);
+    } else if (tok.rfind("-I", 0) == 0) {
+      list = &dirs.user;
+      dir = tok.substr(2);
+    } else {
+      continue;
+    }
+    if (dir.empty() && !(in >> dir)) break; // "-I dir"
+    list->push_back(dir);
+  }
+  return dirs;
+}
+
+// Folds `file` and, depth first, every #include it reaches into h. Quoted
+// includes are looked up next to the including file, then in the -iquote
+// and -I directories; <...> includes in the -I directories only.
+void hash_sources(std::uint64_t &h, const fs::path &file, const IncludeDirs &dirs,
+                  std::set<fs::path> &seen) {
+  std::error_code ec;
+  const fs::path canon = fs::weakly_canonical(file, ec);
+  if (!seen.insert(ec ? file : canon).second) return;
+  const std::string text = read_file(file);
+  fnv1a(h, "\nfile ");
+  fnv1a(h, std::to_string(text.size()));
+  fnv1a(h, "\n");
+  fnv1a(h, text);
+  std::istringstream lines(text);
+  for (std::string line; std::getline(lines, line);) {
+    std::size_t i = line.find_first_not_of(" \t");
+    if (i == std::string::npos || line[i] != '#') continue;
+    i = line.find_first_not_of(" \t", i + 1);
+    if (i == std::string::npos || line.compare(i, 7, "include") != 0) continue;
+    const std::size_t open = line.find_first_of("\"<", i + 7);
+    if (open == std::string::npos) continue;
+    const bool quoted = line[open] == '"';
+    const std::size_t close = line.find(quoted ? '"' : '>', open + 1);
+    if (close == std::string::npos) continue;
+    const fs::path inc = line.substr(open + 1, close - open - 1);
+    std::vector<fs::path> candidates;
+    if (inc.is_absolute()) {
+      candidates.push_back(inc);
+    } else {
+      if (quoted) {
+        candidates.push_back(file.parent_path() / inc);
+        for (const auto &d : dirs.quote) candidates.push_back(d / inc);
+      }
+      for (const auto &d : dirs.user) candidates.push_back(d / inc);
+    }
+    for (const auto &c : candidates)
+      if (fs::is_regular_file(c, ec)) {
+        hash_sources(h, c, dirs, seen);
+        break;
+      }
+  }
+}
+
+// `cxx --version`, once per compiler and process
+std::string compiler_version(const std::string &cxx) {
+  static std::mutex mu;
+  static std::map<std::string, std::string> known;
+  std::lock_guard<std::mutex> lock(mu);
+  if (auto it = known.find(cxx); it != known.end()) return it->second;
+  std::string out;
+  if (FILE *p = popen((cxx + " --version 2>/dev/null").c_str(), "r")) {
+    std::array<char, 256> buf;
+    for (std::size_t n; (n = std::fread(buf.data(), 1, buf.size(), p)) > 0;) out.append(buf.data(), n);
+    if (pclose(p) != 0) out.clear();
+  }
+  if (out.empty()) throw std::runtime_error("cannot run compiler '" + cxx + "'");
+  return known.emplace(cxx, out).first->second;
+}
+
+// `flags` without any -march/-mtune, plus the level's own
+std::string flags_for(const std::string &flags, IsaLevel isa) {
+  std::istringstream in(flags);
+  std::string out;
+  for (std::string tok; in >> tok;)
+    if (tok.rfind("-march=", 0) != 0 && tok.rfind("-mtune=", 0) != 0) out += tok + " ";
+  if (kX86) {
+    static constexpr const char *kMarch[] = {"-march=x86-64", "-march=x86-64-v3",
+                                             "-march=x86-64-v4"};
+    out += kMarch[static_cast<int>(isa)];
+  }
+  return out;
+}
+
+std::string shell_quote(const std::string &s) {
+  std::string q = "'";
+  for (char c : s) {
+    if (c == '\'') q += "'\\''";
+    else q += c;
+  }
+  q += '\'';
+  return q;
+}
+
+} // namespace
+
+std::string_view isa_level_name(IsaLevel l) {
+  switch (l) {
+  case IsaLevel::baseline: return "baseline";
+  case IsaLevel::avx2: return "avx2";
+  case IsaLevel::avx512: return "avx512";
+  }
+  return "baseline";
+}
+
+std::optional<IsaLevel> parse_isa_level(std::string_view s) {
+  for (IsaLevel l : {IsaLevel::baseline, IsaLevel::avx2, IsaLevel::avx512})
+    if (s == isa_level_name(l)) return l;
+  return std::nullopt;
+}
+
+IsaLevel host_isa_level() {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  __builtin_cpu_init();
+  const bool v3 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+                  __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+  const bool v4 = v3 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                  __builtin_cpu_supports("avx512cd") && __builtin_cpu_supports("avx512dq") &&
+                  __builtin_cpu_supports("avx512vl");
+  return v4 ? IsaLevel::avx512 : v3 ? IsaLevel::avx2 : IsaLevel::baseline;
+#else
+  return IsaLevel::baseline;
+#endif
+}
+
+std::string resolve_plugin_variant(const std::string &path) {
+  const fs::path p(path);
+  if (p.extension() != ".so") return path;
+  std::string base = p.stem().string();
+  for (IsaLevel l : {IsaLevel::baseline, IsaLevel::avx2, IsaLevel::avx512}) {
+    std::string suffix = "-";
+    suffix += isa_level_name(l);
+    if (base.size() > suffix.size() && base.ends_with(suffix)) {
+      base.resize(base.size() - suffix.size());
+      break;
+    }
+  }
+  const IsaLevel host = host_isa_level();
+  std::error_code ec;
+  bool family = false;
+  std::string best;
+  for (IsaLevel l : {IsaLevel::baseline, IsaLevel::avx2, IsaLevel::avx512}) {
+    const fs::path v = p.parent_path() / (base + "-" + std::string(isa_level_name(l)) + ".so");
+    if (!fs::is_regular_file(v, ec)) continue;
+    family = true;
+    if (l <= host) best = v.string();
+  }
+  if (!family) return path;
+  if (best.empty())
+    throw std::runtime_error("no variant of " + path + " runs on this CPU (" +
+                             std::string(isa_level_name(host)) + ")");
+  return best;
+}
+
+PluginBuild build_plugin(const PluginBuildOptions &opt) {
+  if (opt.source.empty()) throw std::runtime_error("plugin source is required");
+  if (opt.cache_dir.empty()) throw std::runtime_error("plugin cache directory is required");
+  const std::string cxx = opt.cxx.empty() ? SORTBENCH_CXX : opt.cxx;
+  const std::string cxxflags = opt.cxxflags.empty() ? SORTBENCH_CXXFLAGS : opt.cxxflags;
+  const std::string ldflags = opt.ldflags.empty() ? SORTBENCH_LDFLAGS : opt.ldflags;
+  std::vector<IsaLevel> levels = opt.variants;
+  if (levels.empty()) levels.push_back(host_isa_level());
+  for (IsaLevel l : levels)
+    if (!kX86 && l != IsaLevel::baseline)
+      throw std::runtime_error(std::string(isa_level_name(l)) + " variants need an x86-64 target");
+
+  // Shared part of the key: sources and compiler
+  std::uint64_t base = 0xcbf29ce484222325ULL;
+  std::set<fs::path> seen;
+  hash_sources(base, opt.source, include_dirs(cxxflags), seen);
+  fnv1a(base, "\ncxx " + cxx + "\n" + compiler_version(cxx) + "\nldflags " + ldflags);
+
+  std::error_code ec;
+  fs::create_directories(opt.cache_dir, ec);
+  if (ec)
+    throw std::runtime_error("cannot create plugin cache " + opt.cache_dir + ": " + ec.message());
+  PluginBuild out;
+  const IsaLevel host = host_isa_level();
+  bool any_runs = false;
+  for (IsaLevel isa : levels) {
+    const std::string flags = flags_for(cxxflags, isa);
+    std::uint64_t h = base;
+    fnv1a(h, "\ncxxflags " + flags);
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(h));
+    const fs::path lib = fs::path(opt.cache_dir) / (fs::path(opt.source).stem().string() + "-" +
+                                                    hex + "-" + std::string(isa_level_name(isa)) + ".so");
+    PluginVariant v{isa, lib.string(), fs::is_regular_file(lib, ec) && fs::file_size(lib, ec) > 0};
+    if (!v.cached) {
+      static std::atomic<unsigned> counter{0};
+      std::string tmp = lib.string() + ".tmp";
+#if defined(__linux__)
+      tmp += '.';
+      tmp += std::to_string(getpid());
+#endif
+      tmp += '.';
+      tmp += std::to_string(counter++);
+      const std::string cmd = cxx + " " + flags + " -fPIC -shared -o " + shell_quote(tmp) + " " +
+                              shell_quote(opt.source) + " " + ldflags;
+      const int rc = std::system(cmd.c_str());
+      if (rc != 0) {
+        fs::remove(tmp, ec);
+        throw std::runtime_error("plugin build failed (rc=" + std::to_string(rc) + "): " + cmd);
+      }
+      fs::rename(tmp, lib, ec);
+      if (ec) {
+        fs::remove(tmp, ec);
+        throw std::runtime_error("cannot store " + lib.string() + ": " + ec.message());
+      }
+    }
+    // The building CPU's pick; loaders resolve the family again where they run
+    if (isa <= host && (!any_runs || isa > out.isa)) {
+      out.path = v.path;
+      out.isa = isa;
+      any_runs = true;
+    }
+    out.variants.push_back(std::move(v));
+  }
+  if (!any_runs)
+    throw std::runtime_error("no variant of " + opt.source + " runs on this CPU (" +
+                             std::string(isa_level_name(host)) + ")");
+  return out;
+}
+
+} // namespace sortbench
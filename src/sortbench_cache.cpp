@@ -0,0 +1,210 @@
+// sortbench core: on-disk dataset cache
+
+#include "sortbench_cache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace sortbench::cache {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'B', 'D', 'A', 'T', 'A', '1', '\n'};
+constexpr std::size_t kHeaderBytes = 4096; // payload stays page aligned for mmap
+
+// Fixed part of the header; the key string follows it
+struct Header {
+  char magic[8];
+  std::uint32_t header_bytes;
+  std::uint32_t elem_size;
+  std::uint64_t count;
+  std::uint32_t key_len;
+  std::uint32_t reserved;
+};
+
+std::uint64_t fnv1a(const std::string &s) {
+  std::uint64_t h = 0xcbf29ce484222325ULL;
+  for (unsigned char c : s) {
+    h ^= c;
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+std::string file_name(const CoreConfig &cfg, const std::string &key) {
+  char hash[17];
+  std::snprintf(hash, sizeof(hash), "%016llx",
+                static_cast<unsigned long long>(fnv1a(key)));
+  return std::string(elem_type_name(cfg.type)) + "-" +
+         std::string(dist_name(cfg.dist)) + "-" + std::to_string(cfg.N) + "-" +
+         hash + ".sbd";
+}
+
+std::string fmt_double(double x) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.17g", x);
+  return buf;
+}
+
+void evict(const fs::path &dir, const fs::path &keep, std::uint64_t max_bytes) {
+  struct Entry {
+    fs::path path;
+    std::uint64_t bytes;
+    fs::file_time_type used;
+  };
+  std::vector<Entry> entries;
+  std::uint64_t total = 0;
+  std::error_code ec;
+  for (const auto &de : fs::directory_iterator(dir, ec)) {
+    if (de.path().extension() != ".sbd" || !de.is_regular_file(ec)) continue;
+    Entry e{de.path(), static_cast<std::uint64_t>(de.file_size(ec)),
+            de.last_write_time(ec)};
+    total += e.bytes;
+    entries.push_back(std::move(e));
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &a, const Entry &b) { return a.used < b.used; });
+  for (const auto &e : entries) {
+    if (total <= max_bytes) break;
+    if (e.path == keep) continue;
+    if (fs::remove(e.path, ec)) total -= e.bytes;
+  }
+}
+
+} // namespace
+
+std::string dataset_key(const CoreConfig &cfg, std::uint64_t seed) {
+  std::string k = "gen=" + std::to_string(kGeneratorVersion) +
+                  " type=" + std::string(elem_type_name(cfg.type)) +
+                  " n=" + std::to_string(cfg.N) +
+                  " dist=" + std::string(dist_name(cfg.dist)) +
+                  " seed=" + std::to_string(seed);
+  switch (cfg.dist) {
+  case Dist::partial:
+    k += " partial_pct=" + std::to_string(cfg.partial_shuffle_pct);
+    break;
+  case Dist::dups:
+    k += " dups=" + std::to_string(cfg.dup_values);
+    break;
+  case Dist::zipf:
+    k += " dups=" + std::to_string(cfg.dup_values) + " zipf_s=" + fmt_double(cfg.zipf_s);
+    break;
+  case Dist::runs_ht:
+    k += " runs_alpha=" + fmt_double(cfg.runs_alpha);
+    break;
+  case Dist::staggered:
+    k += " stagger_block=" + std::to_string(cfg.stagger_block);
+    break;
+  case Dist::adversarial:
+    k += " adversary=" + cfg.adversary;
+    break;
+  case Dist::sorted_tail:
+    k += " tail_pct=" + std::to_string(cfg.tail_pct);
+    break;
+  case Dist::k_sorted:
+    k += " displace_k=" + std::to_string(cfg.displace_k);
+    break;
+  case Dist::clustered:
+    k += " clusters=" + std::to_string(cfg.clusters);
+    break;
+  case Dist::block_shuffled:
+    k += " shuffle_block=" + std::to_string(cfg.shuffle_block);
+    break;
+  default:
+    break;
+  }
+  return k;
+}
+
+std::optional<sys::Region> load(const std::string &dir, const std::string &key,
+                                const CoreConfig &cfg, std::size_t elem_size) {
+  if (cfg.N == 0) return std::nullopt;
+  const fs::path path = fs::path(dir) / file_name(cfg, key);
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return std::nullopt;
+  Header h{};
+  in.read(reinterpret_cast<char *>(&h), sizeof(h));
+  if (!in || std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 ||
+      h.header_bytes != kHeaderBytes || h.elem_size != elem_size ||
+      h.count != cfg.N || h.key_len != key.size())
+    return std::nullopt;
+  std::string stored(h.key_len, '\0');
+  in.read(stored.data(), static_cast<std::streamsize>(stored.size()));
+  if (!in || stored != key) return std::nullopt; // hash collision or stale file
+  in.close();
+  const std::size_t payload = cfg.N * elem_size;
+  std::error_code ec;
+  if (fs::file_size(path, ec) != kHeaderBytes + payload || ec) return std::nullopt;
+  sys::Region r;
+  try {
+    r = sys::map_file(path.string(), kHeaderBytes, payload, /*populate=*/true);
+  } catch (const std::runtime_error &) {
+    return std::nullopt; // evicted by another process since the checks above
+  }
+  r.backing = "cache";
+  fs::last_write_time(path, fs::file_time_type::clock::now(), ec); // LRU touch
+  return r;
+}
+
+void store(const std::string &dir, const std::string &key, const CoreConfig &cfg,
+           const void *data, std::size_t elem_size, std::uint64_t max_bytes) {
+  if (cfg.N == 0) return;
+  const std::size_t payload = cfg.N * elem_size;
+  if (max_bytes && kHeaderBytes + payload > max_bytes) return; // would evict itself
+  fs::create_directories(dir);
+  const fs::path path = fs::path(dir) / file_name(cfg, key);
+  static std::atomic<unsigned> seq{0};
+  fs::path tmp = path;
+#if defined(__linux__)
+  tmp += ".tmp." + std::to_string(getpid()) + "." + std::to_string(seq++);
+#else
+  tmp += ".tmp." + std::to_string(seq++);
+#endif
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("cannot write " + tmp.string());
+    std::vector<char> header(kHeaderBytes, '\0');
+    Header h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.header_bytes = static_cast<std::uint32_t>(kHeaderBytes);
+    h.elem_size = static_cast<std::uint32_t>(elem_size);
+    h.count = cfg.N;
+    h.key_len = static_cast<std::uint32_t>(key.size());
+    std::memcpy(header.data(), &h, sizeof(h));
+    std::memcpy(header.data() + sizeof(h), key.data(),
+                std::min(key.size(), kHeaderBytes - sizeof(h)));
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.write(static_cast<const char *>(data), static_cast<std::streamsize>(payload));
+    out.flush();
+    if (!out) {
+      std::error_code ec;
+      out.close();
+      fs::remove(tmp, ec);
+      throw std::runtime_error("short write to " + tmp.string());
+    }
+  }
+  std::error_code ec;
+  fs::rename(tmp, path, ec);
+  if (ec) {
+    std::error_code rm_ec;
+    fs::remove(tmp, rm_ec);
+    throw std::runtime_error("cannot rename " + tmp.string() + ": " + ec.message());
+  }
+  if (max_bytes) evict(dir, path, max_bytes);
+}
+
+} // namespace sortbench::cache
@@ -0,0 +1,34 @@
+// sortbench core: on-disk dataset cache (private to the core library)
+// Generated inputs of trivially copyable types are dumped to
+// <dir>/<type>-<dist>-<N>-<hash>.sbd and mapped back copy-on-write on later
+// runs. Files are evicted least-recently-used once the directory exceeds the
+// configured size budget.
+
+#pragma once
+
+#include "sortbench/core.hpp"
+#include "sortbench_sys.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace sortbench::cache {
+
+// Canonical description of a generated input: (generator version, type, N,
+// dist, seed, and the dist parameters that actually affect the data).
+std::string dataset_key(const CoreConfig &cfg, std::uint64_t seed);
+
+// Map the cached dataset for `key` (MAP_PRIVATE | MAP_POPULATE) and mark it
+// recently used. nullopt on a miss or a file that does not match.
+std::optional<sys::Region> load(const std::string &dir, const std::string &key,
+                                const CoreConfig &cfg, std::size_t elem_size);
+
+// Write atomically (temp file + rename), then evict the least recently used
+// files until the directory holds at most `max_bytes` (0 = unlimited).
+// Throws std::runtime_error on I/O failure.
+void store(const std::string &dir, const std::string &key, const CoreConfig &cfg,
+           const void *data, std::size_t elem_size, std::uint64_t max_bytes);
+
+} // namespace sortbench::cache
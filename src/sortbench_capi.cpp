@@ -1,10 +1,15 @@
 #include "sortbench/core.hpp"
 #include "sortbench/capi.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <exception>
+#include <new>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -17,31 +22,121 @@ static char* dup_cstr(const std::string& s) {
   return p;
 }
 
+struct sb_cancel_token {
+  std::atomic<bool> flag{false};
+};
+
+extern "C" sb_cancel_token* sb_cancel_token_new(void) {
+  return new (std::nothrow) sb_cancel_token;
+}
+
+extern "C" void sb_cancel(sb_cancel_token* t) {
+  if (t) t->flag.store(true);
+}
+
+extern "C" void sb_cancel_token_free(sb_cancel_token* t) {
+  delete t;
+}
+
+static CoreConfig to_core_config(const sb_core_config* c) {
+  CoreConfig cfg;
+  cfg.N = (std::size_t)c->N;
+  cfg.dist = static_cast<Dist>(c->dist);
+  cfg.type = static_cast<ElemType>(c->elem_type);
+  cfg.repeats = c->repeats;
+  cfg.warmup = c->warmup;
+  if (c->has_seed) cfg.seed = (std::uint64_t)c->seed;
+  cfg.algos.clear();
+  for (int i = 0; i < c->algos_len; ++i) if (c->algos && c->algos[i]) cfg.algos.emplace_back(c->algos[i]);
+  cfg.threads = c->threads;
+  cfg.assert_sorted = (c->assert_sorted != 0);
+  cfg.verify = (c->verify != 0);
+  if (c->has_baseline && c->baseline) cfg.baseline = std::string(c->baseline);
+  cfg.partial_shuffle_pct = c->partial_shuffle_pct;
+  cfg.dup_values = c->dup_values;
+  if (c->zipf_s > 0) cfg.zipf_s = c->zipf_s;
+  if (c->runs_alpha > 0) cfg.runs_alpha = c->runs_alpha;
+  if (c->stagger_block > 0) cfg.stagger_block = c->stagger_block;
+  cfg.plugin_paths.clear();
+  for (int i = 0; i < c->plugin_len; ++i) if (c->plugin_paths && c->plugin_paths[i]) cfg.plugin_paths.emplace_back(c->plugin_paths[i]);
+  for (int i = 0; i < c->isolated_plugin_len; ++i)
+    if (c->isolated_plugin_paths && c->isolated_plugin_paths[i])
+      cfg.isolated_plugin_paths.emplace_back(c->isolated_plugin_paths[i]);
+  if (c->cpus && *c->cpus) cfg.cpus = parse_cpu_list(c->cpus);
+  cfg.spin_up = (c->spin_up != 0);
+  if (c->schedule < 0 || c->schedule > static_cast<int>(Schedule::shuffled))
+    throw std::runtime_error("invalid schedule");
+  cfg.schedule = static_cast<Schedule>(c->schedule);
+  if (c->buffers < 0 || c->buffers > static_cast<int>(BufferMode::prefault))
+    throw std::runtime_error("invalid buffers mode");
+  cfg.buffers = static_cast<BufferMode>(c->buffers);
+  cfg.isolate = (c->isolate != 0);
+  cfg.algo_timeout_ms = c->algo_timeout_ms;
+  if (c->cache_dir && *c->cache_dir) cfg.cache_dir = c->cache_dir;
+  cfg.cache_max_bytes = c->cache_max_bytes;
+  if (c->input_path && *c->input_path) cfg.input_path = c->input_path;
+  cfg.input_offset = static_cast<std::size_t>(c->input_offset);
+  cfg.input_sample = (c->input_sample != 0);
+  if (c->adversary && *c->adversary) cfg.adversary = c->adversary;
+  cfg.analyze = (c->analyze != 0);
+  if (c->tail_pct > 0) cfg.tail_pct = std::min(c->tail_pct, 100);
+  if (c->displace_k > 0) cfg.displace_k = c->displace_k;
+  if (c->clusters > 0) cfg.clusters = c->clusters;
+  if (c->shuffle_block > 0) cfg.shuffle_block = c->shuffle_block;
+  if (c->verify_mode < 0 || c->verify_mode > static_cast<int>(VerifyMode::fingerprint))
+    throw std::runtime_error("invalid verify mode");
+  cfg.verify_mode = static_cast<VerifyMode>(c->verify_mode);
+  if (c->reset < 0 || c->reset > static_cast<int>(ResetMode::parallel))
+    throw std::runtime_error("invalid reset mode");
+  cfg.reset = static_cast<ResetMode>(c->reset);
+  if (c->placement < 0 || c->placement > static_cast<int>(Placement::first_touch))
+    throw std::runtime_error("invalid placement");
+  cfg.placement = static_cast<Placement>(c->placement);
+  if (c->cancel) cfg.cancel = &c->cancel->flag;
+  return cfg;
+}
+
+// Forwards core progress to the C callbacks
+class CObserver : public Observer {
+public:
+  explicit CObserver(const sb_observer& o) : o_(o) {}
+  void on_start(const std::vector<std::string>& names) override {
+    if (!o_.on_start) return;
+    std::vector<const char*> p;
+    p.reserve(names.size());
+    for (const auto& n : names) p.push_back(n.c_str());
+    o_.on_start(o_.user, p.data(), (int)p.size());
+  }
+  void on_input(const RunResult& r, double input_ms) override {
+    head_ = r;
+    if (o_.on_input) o_.on_input(o_.user, (uint64_t)r.N, input_ms);
+  }
+  void on_repeat(const std::string& algo, int repeat, double ms) override {
+    if (o_.on_repeat) o_.on_repeat(o_.user, algo.c_str(), repeat, ms);
+  }
+  void on_row(const ResultRow& row) override {
+    if (!o_.on_row) return;
+    head_.rows.assign(1, row);
+    std::string js = to_jsonl(head_, false);
+    if (!js.empty() && js.back() == '\n') js.pop_back();
+    o_.on_row(o_.user, js.c_str());
+  }
+
+private:
+  sb_observer o_;
+  RunResult head_; // run header from on_input, reused for each row
+};
+
 extern "C" char* sb_run_json(const sb_core_config* c, int include_speedup, int pretty, char** err_out) {
+  return sb_run_json_observed(c, nullptr, include_speedup, pretty, err_out);
+}
+
+extern "C" char* sb_run_json_observed(const sb_core_config* c, const sb_observer* obs, int include_speedup, int pretty, char** err_out) {
   if (err_out) *err_out = nullptr;
   try {
-    CoreConfig cfg;
-    cfg.N = (std::size_t)c->N;
-    cfg.dist = static_cast<Dist>(c->dist);
-    cfg.type = static_cast<ElemType>(c->elem_type);
-    cfg.repeats = c->repeats;
-    cfg.warmup = c->warmup;
-    if (c->has_seed) cfg.seed = (std::uint64_t)c->seed;
-    cfg.algos.clear();
-    for (int i = 0; i < c->algos_len; ++i) if (c->algos && c->algos[i]) cfg.algos.emplace_back(c->algos[i]);
-    cfg.threads = c->threads;
-    cfg.assert_sorted = (c->assert_sorted != 0);
-    cfg.verify = (c->verify != 0);
-    if (c->has_baseline && c->baseline) cfg.baseline = std::string(c->baseline);
-    cfg.partial_shuffle_pct = c->partial_shuffle_pct;
-    cfg.dup_values = c->dup_values;
-    if (c->zipf_s > 0) cfg.zipf_s = c->zipf_s;
-    if (c->runs_alpha > 0) cfg.runs_alpha = c->runs_alpha;
-    if (c->stagger_block > 0) cfg.stagger_block = c->stagger_block;
-    cfg.plugin_paths.clear();
-    for (int i = 0; i < c->plugin_len; ++i) if (c->plugin_paths && c->plugin_paths[i]) cfg.plugin_paths.emplace_back(c->plugin_paths[i]);
-
-    RunResult r = run_benchmark(cfg);
+    std::optional<CObserver> co;
+    if (obs) co.emplace(*obs);
+    RunResult r = run_benchmark(to_core_config(c), co ? &*co : nullptr);
     std::string js = to_json(r, include_speedup != 0, pretty != 0);
     return dup_cstr(js);
   } catch (const std::exception& e) {
@@ -50,35 +145,133 @@ extern "C" char* sb_run_json(const sb_core_config* c, int include_speedup, int p
   }
 }
 
+static std::vector<std::string> plugin_list(const char* const* plugins, int plugins_len) {
+  std::vector<std::string> pp;
+  for (int i = 0; i < plugins_len; ++i) if (plugins && plugins[i]) pp.emplace_back(plugins[i]);
+  return pp;
+}
+
+// simple JSON escape for names and paths
+static void append_json_string(std::string& js, const std::string& s) {
+  js += "\"";
+  for (char c : s) {
+    switch (c) {
+      case '"': js += "\\\""; break;
+      case '\\': js += "\\\\"; break;
+      default: js += c; break;
+    }
+  }
+  js += "\"";
+}
+
+static std::string names_json(const std::vector<std::string>& names) {
+  std::string js = "[";
+  for (std::size_t i = 0; i < names.size(); ++i) {
+    if (i) js += ",";
+    append_json_string(js, names[i]);
+  }
+  js += "]";
+  return js;
+}
+
 extern "C" char* sb_list_algos_json(int elem_type, const char* const* plugins, int plugins_len, char** err_out) {
   if (err_out) *err_out = nullptr;
   try {
     ElemType t = static_cast<ElemType>(elem_type);
-    std::vector<std::string> pp;
-    for (int i = 0; i < plugins_len; ++i) if (plugins && plugins[i]) pp.emplace_back(plugins[i]);
-    std::vector<std::string> names = (pp.empty() ? list_algorithms(t) : list_algorithms(t, pp));
-    std::string js = "[";
-    for (std::size_t i = 0; i < names.size(); ++i) {
-      if (i) js += ",";
-      js += "\"";
-      // simple JSON escape for names
-      for (char c : names[i]) {
-        switch (c) {
-          case '"': js += "\\\""; break;
-          case '\\': js += "\\\\"; break;
-          default: js += c; break;
-        }
-      }
-      js += "\"";
-    }
-    js += "]";
-    return dup_cstr(js);
+    std::vector<std::string> pp = plugin_list(plugins, plugins_len);
+    return dup_cstr(names_json(pp.empty() ? list_algorithms(t) : list_algorithms(t, pp)));
   } catch (const std::exception& e) {
     if (err_out) *err_out = dup_cstr(std::string("error: ") + e.what());
     return nullptr;
   }
 }
 
+struct sb_session {
+  Session session;
+  explicit sb_session(std::uint64_t max_bytes) : session(max_bytes) {}
+};
+
+extern "C" sb_session* sb_session_new(uint64_t dataset_max_bytes) {
+  try {
+    return new sb_session(dataset_max_bytes);
+  } catch (const std::exception&) {
+    return nullptr;
+  }
+}
+
+extern "C" void sb_session_free(sb_session* s) {
+  delete s;
+}
+
+extern "C" char* sb_session_run_json(sb_session* s, const sb_core_config* c, int include_speedup, int pretty, char** err_out) {
+  return sb_session_run_json_observed(s, c, nullptr, include_speedup, pretty, err_out);
+}
+
+extern "C" char* sb_session_run_json_observed(sb_session* s, const sb_core_config* c, const sb_observer* obs, int include_speedup, int pretty, char** err_out) {
+  if (err_out) *err_out = nullptr;
+  try {
+    std::optional<CObserver> co;
+    if (obs) co.emplace(*obs);
+    RunResult r = s->session.run(to_core_config(c), co ? &*co : nullptr);
+    return dup_cstr(to_json(r, include_speedup != 0, pretty != 0));
+  } catch (const std::exception& e) {
+    if (err_out) *err_out = dup_cstr(std::string("error: ") + e.what());
+    return nullptr;
+  }
+}
+
+extern "C" char* sb_session_list_algos_json(sb_session* s, int elem_type, const char* const* plugins, int plugins_len, char** err_out) {
+  if (err_out) *err_out = nullptr;
+  try {
+    ElemType t = static_cast<ElemType>(elem_type);
+    return dup_cstr(names_json(s->session.list_algorithms(t, plugin_list(plugins, plugins_len))));
+  } catch (const std::exception& e) {
+    if (err_out) *err_out = dup_cstr(std::string("error: ") + e.what());
+    return nullptr;
+  }
+}
+
+extern "C" void sb_session_invalidate(sb_session* s, int what) {
+  if (what & SB_INVALIDATE_DATASETS) s->session.invalidate_datasets();
+  if (what & SB_INVALIDATE_PLUGINS) s->session.invalidate_plugins();
+}
+
 extern "C" void sb_free(char* p) {
   if (p) std::free(p);
 }
+
+extern "C" char* sb_build_plugin_json(const sb_plugin_build* b, char** err_out) {
+  if (err_out) *err_out = nullptr;
+  try {
+    if (!b) throw std::invalid_argument("null build options");
+    PluginBuildOptions o;
+    if (b->source) o.source = b->source;
+    if (b->cache_dir) o.cache_dir = b->cache_dir;
+    if (b->cxx) o.cxx = b->cxx;
+    if (b->cxxflags) o.cxxflags = b->cxxflags;
+    if (b->ldflags) o.ldflags = b->ldflags;
+    if (b->variants & SB_ISA_BASELINE) o.variants.push_back(IsaLevel::baseline);
+    if (b->variants & SB_ISA_AVX2) o.variants.push_back(IsaLevel::avx2);
+    if (b->variants & SB_ISA_AVX512) o.variants.push_back(IsaLevel::avx512);
+    const PluginBuild built = build_plugin(o);
+    std::string js = "{\"path\":";
+    append_json_string(js, built.path);
+    js += ",\"isa\":";
+    append_json_string(js, std::string(isa_level_name(built.isa)));
+    js += ",\"variants\":[";
+    for (std::size_t i = 0; i < built.variants.size(); ++i) {
+      const PluginVariant& v = built.variants[i];
+      if (i) js += ",";
+      js += "{\"isa\":";
+      append_json_string(js, std::string(isa_level_name(v.isa)));
+      js += ",\"path\":";
+      append_json_string(js, v.path);
+      js += v.cached ? ",\"cached\":true}" : ",\"cached\":false}";
+    }
+    js += "]}";
+    return dup_cstr(js);
+  } catch (const std::exception& e) {
+    if (err_out) *err_out = dup_cstr(std::string("error: ") + e.what());
+    return nullptr;
+  }
+}
@@ -2,18 +2,40 @@
 // Extracts the non-CLI core to run a single benchmark in-process
 
 #include "sortbench/core.hpp"
+#include "sortbench_adversary.hpp"
+#include "sortbench_algos.hpp"
+#include "sortbench_alloc.hpp"
+#include "sortbench_analyze.hpp"
+#include "sortbench_buffer.hpp"
+#include "sortbench_cache.hpp"
+#include "sortbench_gen.hpp"
+#include "sortbench_host.hpp"
+#include "sortbench_input.hpp"
+#include "sortbench_kernels.hpp"
+#include "sortbench_reset.hpp"
+#include "sortbench_sys.hpp"
+#include "sortbench_verify.hpp"
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <exception>
 #include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <optional>
 #include <random>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <functional>
@@ -25,17 +47,6 @@
 #include <omp.h>
 #endif
 
-#if defined(__has_include)
-#if __has_include(<tbb/global_control.h>)
-#include <tbb/global_control.h>
-#define SB_HAS_TBB 1
-#else
-#define SB_HAS_TBB 0
-#endif
-#else
-#define SB_HAS_TBB 0
-#endif
-
 #if defined(__has_include)
 #if __has_include("pdqsort.h")
 #include "pdqsort.h"
@@ -89,6 +100,8 @@
 #endif
 
 #include <dlfcn.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "../sortbench_plugin.h"
 
 namespace sortbench {
@@ -96,10 +109,11 @@ namespace sortbench {
 using Clock = std::chrono::steady_clock;
 using ms = std::chrono::duration<double, std::milli>;
 
-static constexpr std::array<std::string_view, 13> kDistNames{
+static constexpr std::array<std::string_view, 18> kDistNames{
     "random",    "partial",  "dups",     "reverse",  "sorted",
     "saw",       "runs",     "gauss",    "exp",      "zipf",
-    "organpipe", "staggered","runs_ht"};
+    "organpipe", "staggered","runs_ht",  "adversarial", "sorted_tail",
+    "k_sorted",  "clustered","block_shuffled"};
 
 std::string_view dist_name(Dist d) {
   int i = static_cast<int>(d);
@@ -134,538 +148,440 @@ std::string_view elem_type_name(ElemType t) {
   return "i32";
 }
 
-static inline std::string to_lower(std::string s) {
-  for (char &c : s)
-    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-  return s;
-}
-
-static inline std::uint64_t default_seed() { return 0x9E3779B97F4A7C15ULL; }
-
-// Data generation (subset matching CLI behavior)
-template <class T>
-static std::vector<T> make_data(std::size_t n, Dist dist, std::mt19937_64 &rng,
-                                int partial_pct, int dups_k, const CoreConfig& cfg) {
-  std::vector<T> v;
-  v.resize(n);
-  if constexpr (std::is_same_v<T, std::string>) {
-    // Strings: generate random words; support sorted/reverse by ordering
-    std::uniform_int_distribution<int> len(1, 16);
-    std::uniform_int_distribution<int> ch('a', 'z');
-    for (std::size_t i = 0; i < n; ++i) {
-      int L = len(rng);
-      std::string s;
-      s.resize(static_cast<std::size_t>(L));
-      for (int j = 0; j < L; ++j)
-        s[static_cast<std::size_t>(j)] = static_cast<char>(ch(rng));
-      v[i] = std::move(s);
-    }
-    if (dist == Dist::reverse) {
-      std::sort(v.begin(), v.end());
-      std::reverse(v.begin(), v.end());
-    } else if (dist == Dist::sorted) {
-      std::sort(v.begin(), v.end());
-    }
-    return v;
-  } else {
-
-    if (dist == Dist::reverse) {
-      for (std::size_t i = 0; i < n; ++i)
-        v[i] = static_cast<T>(n - 1 - i);
-      return v;
-    }
-
-    if (dist == Dist::sorted) {
-      for (std::size_t i = 0; i < n; ++i)
-        v[i] = static_cast<T>(i);
-      return v;
-    }
-
-    if (dist == Dist::dups) {
-      int k = std::max(1, dups_k);
-      std::uniform_int_distribution<int> d(0, k - 1);
-      for (std::size_t i = 0; i < n; ++i)
-        v[i] = static_cast<T>(d(rng));
-      return v;
-    }
-
-    if (dist == Dist::saw) {
-      std::size_t period =
-          std::max<std::size_t>(std::min<std::size_t>(n ? n : 1, 1024), 1);
-      for (std::size_t i = 0; i < n; ++i)
-        v[i] = static_cast<T>(i % period);
-      return v;
-    }
-
-    if (dist == Dist::runs) {
-      const std::size_t run_len =
-          std::max<std::size_t>(1, std::min<std::size_t>(n ? n : 1, 2048));
-      if constexpr (std::is_integral_v<T>) {
-        std::uniform_int_distribution<std::make_unsigned_t<T>> d(
-            0, std::numeric_limits<std::make_unsigned_t<T>>::max());
-        for (std::size_t i = 0; i < n; ++i)
-          v[i] = static_cast<T>(d(rng));
-      } else if constexpr (std::is_floating_point_v<T>) {
-        std::uniform_real_distribution<T> d(T(0), T(1));
-        for (std::size_t i = 0; i < n; ++i)
-          v[i] = d(rng);
-      }
-      for (std::size_t i = 0; i < n; i += run_len) {
-        std::size_t r = std::min(run_len, n - i);
-        std::sort(v.begin() + static_cast<std::ptrdiff_t>(i),
-                  v.begin() + static_cast<std::ptrdiff_t>(i + r));
-      }
-      return v;
-    }
-
-    if (dist == Dist::gauss) {
-      if constexpr (std::is_integral_v<T>) {
-        using Lim = std::numeric_limits<T>;
-        std::normal_distribution<double> nd(0.0, 1.0);
-        const double minv = static_cast<double>(Lim::min());
-        const double maxv = static_cast<double>(Lim::max());
-        const double mean = std::is_signed_v<T> ? 0.0 : (maxv / 2.0);
-        const double stddev = (maxv - (std::is_signed_v<T> ? minv : 0.0)) / 8.0;
-        for (std::size_t i = 0; i < n; ++i) {
-          double x = mean + stddev * nd(rng);
-          x = std::clamp(x, minv, maxv);
-          v[i] = static_cast<T>(x);
-        }
-      } else {
-        std::normal_distribution<T> nd(T(0), T(1));
-        for (std::size_t i = 0; i < n; ++i)
-          v[i] = nd(rng);
-      }
-      return v;
-    }
-
-    if (dist == Dist::exp) {
-      std::exponential_distribution<double> ed(1.0);
-      if constexpr (std::is_integral_v<T>) {
-        using Lim = std::numeric_limits<T>;
-        const double maxv = static_cast<double>(Lim::max());
-        for (std::size_t i = 0; i < n; ++i) {
-          double y = (maxv / 8.0) * ed(rng);
-          if (y > maxv)
-            y = maxv;
-          v[i] = static_cast<T>(y);
-        }
-      } else {
-        for (std::size_t i = 0; i < n; ++i)
-          v[i] = static_cast<T>(ed(rng));
-      }
-      return v;
-    }
-
-    // random or partial
-    if constexpr (std::is_integral_v<T>) {
-      std::uniform_int_distribution<std::make_unsigned_t<T>> d(
-          0, std::numeric_limits<std::make_unsigned_t<T>>::max());
-      for (std::size_t i = 0; i < n; ++i)
-        v[i] = static_cast<T>(d(rng));
-    } else if constexpr (std::is_floating_point_v<T>) {
-      std::uniform_real_distribution<T> d(T(0), T(1));
-      for (std::size_t i = 0; i < n; ++i)
-        v[i] = d(rng);
-    }
-    if (dist == Dist::partial) {
-      std::size_t to_shuffle =
-          (n * static_cast<std::size_t>(std::clamp(partial_pct, 0, 100))) / 100;
-      if (to_shuffle > n)
-        to_shuffle = n;
-      std::uniform_int_distribution<std::size_t> d(0, n ? n - 1 : 0);
-      for (std::size_t i = 0; i < to_shuffle; ++i) {
-        std::size_t a = d(rng), b = d(rng);
-        std::swap(v[a], v[b]);
-      }
-    }
-    return v;
+std::string_view schedule_name(Schedule s) {
+  switch (s) {
+  case Schedule::sequential:
+    return "sequential";
+  case Schedule::round_robin:
+    return "round_robin";
+  case Schedule::shuffled:
+    return "shuffled";
   }
+  return "sequential";
 }
 
-// Algorithms
-namespace algos {
-
-template <class Iter> inline void insertion_sort(Iter first, Iter last) {
-  for (Iter i = first + (first == last ? 0 : 1); i < last; ++i) {
-    auto key = *i;
-    Iter j = i;
-    while (j > first && *(j - 1) > key) {
-      *j = *(j - 1);
-      --j;
-    }
-    *j = key;
-  }
-}
-
-template <class T> inline void heap_sort(std::vector<T> &v) {
-  std::make_heap(v.begin(), v.end());
-  std::sort_heap(v.begin(), v.end());
-}
-
-template <class T> inline void insertion_sort_full(std::vector<T> &v) {
-  insertion_sort(v.begin(), v.end());
-}
-
-template <class T> inline void selection_sort(std::vector<T> &v) {
-  const std::size_t n = v.size();
-  for (std::size_t i = 0; i + 1 < n; ++i) {
-    std::size_t min_i = i;
-    for (std::size_t j = i + 1; j < n; ++j) if (v[j] < v[min_i]) min_i = j;
-    if (min_i != i) std::swap(v[i], v[min_i]);
-  }
+std::optional<Schedule> parse_schedule(std::string_view s) {
+  if (s == "sequential" || s == "seq")
+    return Schedule::sequential;
+  if (s == "round_robin" || s == "rr" || s == "interleaved")
+    return Schedule::round_robin;
+  if (s == "shuffled" || s == "random")
+    return Schedule::shuffled;
+  return std::nullopt;
 }
 
-template <class T> inline void bubble_sort(std::vector<T> &v) {
-  const std::size_t n = v.size();
-  if (n < 2) return;
-  bool swapped = true;
-  for (std::size_t pass = 0; pass < n - 1 && swapped; ++pass) {
-    swapped = false;
-    for (std::size_t i = 0; i + 1 < n - pass; ++i) {
-      if (v[i + 1] < v[i]) { std::swap(v[i], v[i + 1]); swapped = true; }
-    }
+std::string_view buffer_mode_name(BufferMode m) {
+  switch (m) {
+  case BufferMode::standard:
+    return "default";
+  case BufferMode::huge:
+    return "huge";
+  case BufferMode::prefault:
+    return "prefault";
   }
+  return "default";
 }
 
-template <class T> inline void comb_sort(std::vector<T> &v) {
-  const std::size_t n = v.size();
-  if (n < 2) return;
-  double gap = (double)n;
-  const double shrink = 1.3;
-  bool swapped = true;
-  while (gap > 1.0 || swapped) {
-    gap = std::floor(gap / shrink);
-    if (gap < 1.0) gap = 1.0;
-    std::size_t igap = static_cast<std::size_t>(gap);
-    swapped = false;
-    for (std::size_t i = 0; i + igap < n; ++i) {
-      std::size_t j = i + igap;
-      if (v[j] < v[i]) { std::swap(v[i], v[j]); swapped = true; }
-    }
-  }
+std::optional<BufferMode> parse_buffer_mode(std::string_view s) {
+  if (s == "default" || s == "standard" || s == "heap")
+    return BufferMode::standard;
+  if (s == "huge" || s == "hugepages")
+    return BufferMode::huge;
+  if (s == "prefault")
+    return BufferMode::prefault;
+  return std::nullopt;
 }
 
-template <class T> inline void shell_sort(std::vector<T> &v) {
-  static const int ciura_base[] = {1, 4, 10, 23, 57, 132, 301, 701};
-  std::vector<int> gaps(ciura_base, ciura_base + (sizeof(ciura_base)/sizeof(int)));
-  while ((long long)gaps.back() * 2.25 < (long long)v.size()) {
-    gaps.push_back(int(gaps.back() * 2.25));
-  }
-  for (int gi = (int)gaps.size() - 1; gi >= 0; --gi) {
-    int gap = gaps[gi]; if (gap <= 0) continue;
-    for (std::size_t i = gap; i < v.size(); ++i) {
-      auto tmp = v[i];
-      std::size_t j = i;
-      while (j >= (std::size_t)gap && tmp < v[j - gap]) {
-        v[j] = v[j - gap];
-        j -= gap;
-      }
-      v[j] = tmp;
-    }
+std::string_view verify_mode_name(VerifyMode m) {
+  switch (m) {
+  case VerifyMode::automatic:
+    return "auto";
+  case VerifyMode::reference:
+    return "reference";
+  case VerifyMode::fingerprint:
+    return "fingerprint";
   }
+  return "auto";
 }
 
-template <class T> inline void merge_sort_opt(std::vector<T> &v) {
-  const std::size_t n = v.size();
-  if (n < 2)
-    return;
-  std::vector<T> buf(n);
-  for (std::size_t width = 1; width < n; width <<= 1) {
-    for (std::size_t i = 0; i < n; i += (width << 1)) {
-      std::size_t left = i;
-      std::size_t mid = std::min(i + width, n);
-      std::size_t right = std::min(i + (width << 1), n);
-      if (mid >= right)
-        continue;
-      std::size_t a = left, b = mid, k = left;
-      while (a < mid && b < right) {
-        if (v[a] <= v[b])
-          buf[k++] = v[a++];
-        else
-          buf[k++] = v[b++];
-      }
-      if (a < mid) {
-        std::copy(v.begin() + static_cast<std::ptrdiff_t>(a),
-                  v.begin() + static_cast<std::ptrdiff_t>(mid),
-                  buf.begin() + static_cast<std::ptrdiff_t>(k));
-        k += (mid - a);
-      }
-      if (b < right) {
-        std::copy(v.begin() + static_cast<std::ptrdiff_t>(b),
-                  v.begin() + static_cast<std::ptrdiff_t>(right),
-                  buf.begin() + static_cast<std::ptrdiff_t>(k));
-        k += (right - b);
-      }
-      std::copy(buf.begin() + static_cast<std::ptrdiff_t>(left),
-                buf.begin() + static_cast<std::ptrdiff_t>(right),
-                v.begin() + static_cast<std::ptrdiff_t>(left));
-    }
-  }
+std::optional<VerifyMode> parse_verify_mode(std::string_view s) {
+  if (s == "auto" || s == "automatic")
+    return VerifyMode::automatic;
+  if (s == "reference" || s == "ref")
+    return VerifyMode::reference;
+  if (s == "fingerprint" || s == "fp")
+    return VerifyMode::fingerprint;
+  return std::nullopt;
 }
 
-template <class Iter> inline void quicksort_hybrid_impl(Iter first, Iter last) {
-  constexpr int INSERTION_THRESHOLD = 64;
-  while (last - first > INSERTION_THRESHOLD) {
-    Iter a = first, b = last - 1, m = first + (last - first) / 2;
-    if (*m < *a)
-      std::iter_swap(m, a);
-    if (*b < *m)
-      std::iter_swap(b, m);
-    if (*m < *a)
-      std::iter_swap(m, a);
-    auto pivot = *m;
-    Iter i = first - 1, j = last;
-    for (;;) {
-      do {
-        ++i;
-      } while (*i < pivot);
-      do {
-        --j;
-      } while (pivot < *j);
-      if (i >= j)
-        break;
-      std::iter_swap(i, j);
-    }
-    if (j - first < last - (j + 1)) {
-      quicksort_hybrid_impl(first, j + 1);
-      first = j + 1;
-    } else {
-      quicksort_hybrid_impl(j + 1, last);
-      last = j + 1;
-    }
+std::string_view reset_mode_name(ResetMode m) {
+  switch (m) {
+  case ResetMode::automatic:
+    return "auto";
+  case ResetMode::copy:
+    return "copy";
+  case ResetMode::snapshot:
+    return "snapshot";
+  case ResetMode::parallel:
+    return "parallel";
   }
-  insertion_sort(first, last);
+  return "auto";
 }
 
-template <class T> inline void quicksort_hybrid(std::vector<T> &v) {
-  if (!v.empty())
-    quicksort_hybrid_impl(v.begin(), v.end());
+std::optional<ResetMode> parse_reset_mode(std::string_view s) {
+  if (s == "auto" || s == "automatic")
+    return ResetMode::automatic;
+  if (s == "copy")
+    return ResetMode::copy;
+  if (s == "snapshot" || s == "cow")
+    return ResetMode::snapshot;
+  if (s == "parallel" || s == "stream")
+    return ResetMode::parallel;
+  return std::nullopt;
 }
 
-template <class Iter> inline void quicksort_3way_impl(Iter lo, Iter hi) {
-  while (hi - lo > 64) {
-    Iter i = lo, lt = lo, gt = hi - 1;
-    auto pivot = *(lo + (hi - lo) / 2);
-    while (i <= gt) {
-      if (*i < pivot) { std::iter_swap(lt++, i++); }
-      else if (pivot < *i) { std::iter_swap(i, gt--); }
-      else { ++i; }
-    }
-    auto left_size = lt - lo;
-    auto right_size = hi - (gt + 1);
-    if (left_size < right_size) {
-      if (left_size > 1) quicksort_3way_impl(lo, lt);
-      lo = gt + 1;
-    } else {
-      if (right_size > 1) quicksort_3way_impl(gt + 1, hi);
-      hi = lt;
-    }
+std::string_view placement_name(Placement p) {
+  switch (p) {
+  case Placement::local:
+    return "local";
+  case Placement::interleave:
+    return "interleave";
+  case Placement::first_touch:
+    return "first_touch";
   }
-  insertion_sort(lo, hi);
+  return "local";
 }
 
-template <class T> inline void quicksort_3way(std::vector<T> &v) {
-  if (!v.empty()) quicksort_3way_impl(v.begin(), v.end());
-}
-
-// TimSort (simplified) — copy of CLI version core pieces
-template <class T>
-static inline void binary_insertion_sort(std::vector<T> &v, std::size_t lo,
-                                         std::size_t hi) {
-  for (std::size_t i = lo + 1; i < hi; ++i) {
-    T x = v[i];
-    std::size_t left = lo, right = i;
-    while (left < right) {
-      std::size_t mid = left + ((right - left) >> 1);
-      if (!(x < v[mid]))
-        left = mid + 1;
-      else
-        right = mid;
-    }
-    for (std::size_t j = i; j > left; --j)
-      v[j] = v[j - 1];
-    v[left] = x;
-  }
+std::optional<Placement> parse_placement(std::string_view s) {
+  if (s == "local")
+    return Placement::local;
+  if (s == "interleave")
+    return Placement::interleave;
+  if (s == "first_touch" || s == "first-touch")
+    return Placement::first_touch;
+  return std::nullopt;
 }
 
-template <class T>
-static inline void merge_runs(std::vector<T> &v, std::vector<T> &tmp,
-                              std::size_t lo, std::size_t mid, std::size_t hi) {
-  std::size_t i = lo, j = mid, k = lo;
-  while (i < mid && j < hi)
-    tmp[k++] = (v[i] <= v[j] ? v[i++] : v[j++]);
-  if (i < mid) {
-    std::copy(v.begin() + static_cast<std::ptrdiff_t>(i),
-              v.begin() + static_cast<std::ptrdiff_t>(mid),
-              tmp.begin() + static_cast<std::ptrdiff_t>(k));
-    k += (mid - i);
-  }
-  if (j < hi) {
-    std::copy(v.begin() + static_cast<std::ptrdiff_t>(j),
-              v.begin() + static_cast<std::ptrdiff_t>(hi),
-              tmp.begin() + static_cast<std::ptrdiff_t>(k));
-    k += (hi - j);
-  }
-  std::copy(tmp.begin() + static_cast<std::ptrdiff_t>(lo),
-            tmp.begin() + static_cast<std::ptrdiff_t>(hi),
-            v.begin() + static_cast<std::ptrdiff_t>(lo));
+static inline std::string to_lower(std::string s) {
+  for (char &c : s)
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  return s;
 }
 
-template <class T> inline void timsort(std::vector<T> &v) {
-  const std::size_t n = v.size();
-  if (n < 2)
-    return;
-  std::vector<T> tmp(n);
-  auto next_run = [&](std::size_t i) {
-    std::size_t j = i + 1;
-    if (j >= n)
-      return n;
-    if (v[j] < v[i]) {
-      while (j < n && v[j] < v[j - 1])
-        ++j;
-      std::reverse(v.begin() + static_cast<std::ptrdiff_t>(i),
-                   v.begin() + static_cast<std::ptrdiff_t>(j));
-    } else {
-      while (j < n && !(v[j] < v[j - 1]))
-        ++j;
-    }
-    return j;
-  };
-  const std::size_t MINRUN = 32;
-  std::vector<std::pair<std::size_t, std::size_t>> runs;
-  for (std::size_t i = 0; i < n;) {
-    std::size_t j = next_run(i);
-    if (j - i < MINRUN) {
-      std::size_t hi = std::min(n, i + MINRUN);
-      binary_insertion_sort(v, i, hi);
-      j = hi;
-    }
-    runs.emplace_back(i, j);
-    i = j;
-  }
-  while (runs.size() > 1) {
-    std::vector<std::pair<std::size_t, std::size_t>> nr;
-    for (std::size_t i = 0; i + 1 < runs.size(); i += 2) {
-      auto [a, b] = runs[i];
-      auto [c, d] = runs[i + 1];
-      merge_runs(v, tmp, a, b, d);
-      nr.emplace_back(a, d);
-    }
-    if (runs.size() % 2 == 1)
-      nr.push_back(runs.back());
-    runs.swap(nr);
-  }
-}
+static inline std::uint64_t default_seed() { return 0x9E3779B97F4A7C15ULL; }
 
-template <class T> inline void radix_sort_lsd(std::vector<T> &v) {
-  static_assert(std::is_integral_v<T>, "radix_sort_lsd expects integral type");
-  using U = std::make_unsigned_t<T>;
-  const std::size_t n = v.size();
-  std::vector<T> tmp(n);
-  constexpr int B = 8;
-  constexpr int K = (int)(sizeof(U) * 8 / B);
-  std::array<std::size_t, 256> cnt{};
-  auto pass = [&](int shift, bool signed_fix) {
-    cnt.fill(0);
-    for (std::size_t i = 0; i < n; ++i) {
-      U x = (U)v[i];
-      if (signed_fix)
-        x ^= (U(1) << (sizeof(U) * 8 - 1));
-      unsigned idx = (unsigned)((x >> shift) & 0xFFu);
-      ++cnt[idx];
-    }
-    std::array<std::size_t, 256> pos{};
-    std::size_t run = 0;
-    for (int i = 0; i < 256; ++i)
-      pos[(unsigned)i] = std::exchange(run, run + cnt[(unsigned)i]);
-    for (std::size_t i = 0; i < n; ++i) {
-      U x = (U)v[i];
-      if (signed_fix)
-        x ^= (U(1) << (sizeof(U) * 8 - 1));
-      unsigned idx = (unsigned)((x >> shift) & 0xFFu);
-      tmp[pos[idx]++] = v[i];
-    }
-    std::copy(tmp.begin(), tmp.end(), v.begin());
-  };
-  for (int pass_i = 0; pass_i < K; ++pass_i)
-    pass(pass_i * B, std::is_signed_v<T>);
-}
+// Registry
 
-} // namespace algos
+// What a run hands a plugin algorithm when binding it (see AlgoT::bind)
+struct BindContext {
+  sortbench_ctx_v3 plugin{}; // scratch, thread hint, sink
+  int work_fd = -1;          // memfd holding the work buffer (hosted algorithms)
+  std::string cpus;          // the run's CPU list (hosted algorithms)
+};
 
-// Registry
 template <class T> struct AlgoT {
   std::string name;
-  std::function<void(std::vector<T> &)> run;
+  std::function<void(std::span<T>)> run;
+  // Untimed marshalling around `run` for plugins that sort another layout
+  std::function<void(std::span<T>)> stage = {};   // before the clock starts
+  std::function<void(std::span<T>)> unstage = {}; // after it stops
+  // Plugins: sets run/stage/unstage for one run's context (scratch, threads)
+  std::function<void(AlgoT &, const BindContext &)> bind = {};
+  // Set when the algorithm is timed elsewhere (a plugin host): replace the
+  // harness clock and allocation counters for the run that just finished
+  std::function<double()> reported_ms = {};
+  std::function<alloc::Stats()> reported_mem = {};
+  bool hosted = false; // runs in a sortbench-plugin-host process
+  // After an isolated child running it was killed: stops work it left
+  // behind elsewhere (restarts its plugin host)
+  std::function<void()> abandon = {};
+  std::function<std::size_t(std::size_t n)> scratch_bytes = {};
+  unsigned caps = 0;    // SORTBENCH_CAP_* bits
+  std::string isa = {}; // built-ins compiled per level: the level in use
 };
 
-template <class T> static std::vector<AlgoT<T>> build_registry_t() {
+// `level` picks the instruction-set level of the numeric built-ins
+template <class T>
+static std::vector<AlgoT<T>> build_registry_t(IsaLevel level = IsaLevel::baseline) {
   std::vector<AlgoT<T>> regs;
-  regs.push_back({"std_sort", [](auto &v) { std::sort(v.begin(), v.end()); }});
+  regs.push_back({"std_sort", [](auto v) { std::sort(v.begin(), v.end()); }});
   regs.push_back({"std_stable_sort",
-                  [](auto &v) { std::stable_sort(v.begin(), v.end()); }});
+                  [](auto v) { std::stable_sort(v.begin(), v.end()); }});
 #if SB_HAS_STD_PAR
-  regs.push_back({"std_sort_par", [](auto &v) {
+  regs.push_back({"std_sort_par", [](auto v) {
                     std::sort(std::execution::par, v.begin(), v.end());
                   }});
-  regs.push_back({"std_sort_par_unseq", [](auto &v) {
+  regs.push_back({"std_sort_par_unseq", [](auto v) {
                     std::sort(std::execution::par_unseq, v.begin(), v.end());
                   }});
 #endif
 #if SB_HAS_GNU_PAR
   regs.push_back({"gnu_parallel_sort",
-                  [](auto &v) { __gnu_parallel::sort(v.begin(), v.end()); }});
+                  [](auto v) { __gnu_parallel::sort(v.begin(), v.end()); }});
 #endif
-  regs.push_back({"heap_sort", [](auto &v) { algos::heap_sort(v); }});
-  regs.push_back({"merge_sort_opt", [](auto &v) { algos::merge_sort_opt(v); }});
-  regs.push_back({"insertion_sort", [](auto &v) { algos::insertion_sort_full(v); }});
-  regs.push_back({"selection_sort", [](auto &v) { algos::selection_sort(v); }});
-  regs.push_back({"bubble_sort", [](auto &v) { algos::bubble_sort(v); }});
-  regs.push_back({"comb_sort", [](auto &v) { algos::comb_sort(v); }});
-  regs.push_back({"shell_sort", [](auto &v) { algos::shell_sort(v); }});
-  regs.push_back({"timsort", [](auto &v) { algos::timsort(v); }});
-  regs.push_back(
-      {"quicksort_hybrid", [](auto &v) { algos::quicksort_hybrid(v); }});
-  regs.push_back({"quicksort_3way", [](auto &v) { algos::quicksort_3way(v); }});
-  if constexpr (std::is_integral_v<T>) {
+  if constexpr (std::is_arithmetic_v<T>) {
+    // Compiled once per instruction-set level (sortbench_kernels.cpp)
+    const auto &set = kernels::get<T>(level);
+    for (const auto &k : set.sorts) {
+      AlgoT<T> a{k.name, k.run};
+      a.isa = std::string(isa_level_name(set.isa));
+      regs.push_back(std::move(a));
+    }
+  } else {
+    (void)level;
+    regs.push_back({"heap_sort", [](auto v) { algos::heap_sort(v); }});
+    regs.push_back({"merge_sort_opt", [](auto v) { algos::merge_sort_opt(v); }});
+    regs.push_back({"insertion_sort", [](auto v) { algos::insertion_sort_full(v); }});
+    regs.push_back({"selection_sort", [](auto v) { algos::selection_sort(v); }});
+    regs.push_back({"bubble_sort", [](auto v) { algos::bubble_sort(v); }});
+    regs.push_back({"comb_sort", [](auto v) { algos::comb_sort(v); }});
+    regs.push_back({"shell_sort", [](auto v) { algos::shell_sort(v); }});
+    regs.push_back({"timsort", [](auto v) { algos::timsort(v); }});
     regs.push_back(
-        {"radix_sort_lsd", [](auto &v) { algos::radix_sort_lsd(v); }});
+        {"quicksort_hybrid", [](auto v) { algos::quicksort_hybrid(v); }});
+    regs.push_back({"quicksort_3way", [](auto v) { algos::quicksort_3way(v); }});
   }
 #if SB_HAS_PDQ
-  regs.push_back({"pdqsort", [](auto &v) { pdqsort(v.begin(), v.end()); }});
+  regs.push_back({"pdqsort", [](auto v) { pdqsort(v.begin(), v.end()); }});
 #endif
   // Custom algorithms (if header available)
 #if SB_HAS_CUSTOM
+  // The shim sorts std::vector in place: each run gets its own vector, filled
+  // and written back by stage/unstage outside the timed region
+  auto via_vector = [](const char *name, auto fn) {
+    AlgoT<T> a{name, nullptr}; // `run` is set by bind for each run
+    a.bind = [fn](AlgoT<T> &self, const BindContext &) {
+      auto tmp = std::make_shared<std::vector<T>>();
+      self.stage = [tmp](std::span<T> v) { tmp->assign(v.begin(), v.end()); };
+      self.run = [fn, tmp](std::span<T>) { fn(*tmp); };
+      self.unstage = [tmp](std::span<T> v) { std::copy(tmp->begin(), tmp->end(), v.begin()); };
+    };
+    return a;
+  };
   if constexpr (std::is_same_v<T, int>) {
-    regs.push_back({"custom", [](auto &v) { custom_algo::sort_int(v); }});
-    regs.push_back({"customv2", [](auto &v) { custom_algo::sort_int_v2(v); }});
+    regs.push_back(via_vector("custom", [](std::vector<int> &v) { custom_algo::sort_int(v); }));
+    regs.push_back(via_vector("customv2", [](std::vector<int> &v) { custom_algo::sort_int_v2(v); }));
   } else if constexpr (std::is_same_v<T, float>) {
-    regs.push_back({"custom", [](auto &v) { custom_algo::sort_float(v); }});
-    regs.push_back({"customv2", [](auto &v) { custom_algo::sort_float_v2(v); }});
+    regs.push_back(via_vector("custom", [](std::vector<float> &v) { custom_algo::sort_float(v); }));
+    regs.push_back(via_vector("customv2", [](std::vector<float> &v) { custom_algo::sort_float_v2(v); }));
   } else {
     // Provide safe fallbacks with same names for other types
-    regs.push_back({"custom", [](auto &v) { std::sort(v.begin(), v.end()); }});
-    regs.push_back({"customv2", [](auto &v) { std::sort(v.begin(), v.end()); }});
+    regs.push_back({"custom", [](auto v) { std::sort(v.begin(), v.end()); }});
+    regs.push_back({"customv2", [](auto v) { std::sort(v.begin(), v.end()); }});
   }
 #endif
   return regs;
 }
 
+// Targets for Dist::adversarial: the deterministic, single-threaded
+// comparison sorts of the registry, run on adversary::Item
+static std::vector<AlgoT<adversary::Item>> adversary_targets() {
+  using I = adversary::Item;
+  std::vector<AlgoT<I>> t;
+  t.push_back({"std_sort", [](std::span<I> v) { std::sort(v.begin(), v.end()); }});
+  t.push_back({"std_stable_sort",
+               [](std::span<I> v) { std::stable_sort(v.begin(), v.end()); }});
+  t.push_back({"heap_sort", [](std::span<I> v) { algos::heap_sort(v); }});
+  t.push_back({"merge_sort_opt", [](std::span<I> v) { algos::merge_sort_opt(v); }});
+  t.push_back({"insertion_sort", [](std::span<I> v) { algos::insertion_sort_full(v); }});
+  t.push_back({"selection_sort", [](std::span<I> v) { algos::selection_sort(v); }});
+  t.push_back({"bubble_sort", [](std::span<I> v) { algos::bubble_sort(v); }});
+  t.push_back({"comb_sort", [](std::span<I> v) { algos::comb_sort(v); }});
+  t.push_back({"shell_sort", [](std::span<I> v) { algos::shell_sort(v); }});
+  t.push_back({"timsort", [](std::span<I> v) { algos::timsort(v); }});
+  t.push_back({"quicksort_hybrid", [](std::span<I> v) { algos::quicksort_hybrid(v); }});
+  t.push_back({"quicksort_3way", [](std::span<I> v) { algos::quicksort_3way(v); }});
+#if SB_HAS_PDQ
+  t.push_back({"pdqsort", [](std::span<I> v) { pdqsort(v.begin(), v.end()); }});
+#endif
+  return t;
+}
+
+// Killer input for `target` at n elements. Building one runs the target
+// under the oracle (quadratic for the sorts it defeats), so the last few are
+// kept for sweeps and repeated API runs.
+static std::shared_ptr<const adversary::Killer> killer_input(const std::string &target,
+                                                             std::size_t n) {
+  static std::mutex mu;
+  static std::vector<std::pair<std::string, std::shared_ptr<const adversary::Killer>>> memo;
+  const std::string key = target + "/" + std::to_string(n);
+  {
+    std::lock_guard<std::mutex> lk(mu);
+    for (const auto &[k, p] : memo)
+      if (k == key) return p;
+  }
+  const auto targets = adversary_targets();
+  auto it = std::find_if(targets.begin(), targets.end(),
+                         [&](const auto &t) { return t.name == target; });
+  if (it == targets.end()) {
+    std::string names;
+    for (const auto &t : targets) names += (names.empty() ? "" : ", ") + t.name;
+    throw std::runtime_error("adversary '" + target +
+                             "' is not a supported target (" + names + ")");
+  }
+  auto killer = std::make_shared<const adversary::Killer>(adversary::build(n, it->run));
+  std::lock_guard<std::mutex> lk(mu);
+  if (memo.size() >= 4) memo.erase(memo.begin());
+  memo.emplace_back(key, killer);
+  return killer;
+}
+
 using PluginHandle = void*;
 using get_algos_v1_fn = int (*)(const sortbench_algo_v1 **, int *);
 using get_algos_v2_fn = int (*)(const sortbench_algo_v2 **, int *);
+using get_algos_v3_fn = int (*)(const sortbench_algo_v3 **, std::size_t *);
+
+// Entry point of a v3 algorithm for T (nullptr when not provided)
+template <class T> static auto v3_entry(const sortbench_algo_v3 &a) {
+  if constexpr (std::is_same_v<T, int>) return a.run_i32;
+  else if constexpr (std::is_same_v<T, unsigned int>) return a.run_u32;
+  else if constexpr (std::is_same_v<T, long long>) return a.run_i64;
+  else if constexpr (std::is_same_v<T, unsigned long long>) return a.run_u64;
+  else if constexpr (std::is_same_v<T, float>) return a.run_f32;
+  else if constexpr (std::is_same_v<T, double>) return a.run_f64;
+  else return static_cast<void (*)(T *, std::size_t, const sortbench_ctx_v3 *)>(nullptr);
+}
+
+// Unsigned key with the same order as the value (sortbench_kv.key)
+template <class T> static std::uint64_t order_key(T v) {
+  if constexpr (std::is_same_v<T, float>) {
+    const auto b = std::bit_cast<std::uint32_t>(v);
+    return (b >> 31) ? ~b : (b | 0x80000000u);
+  } else if constexpr (std::is_same_v<T, double>) {
+    const auto b = std::bit_cast<std::uint64_t>(v);
+    return (b >> 63) ? ~b : (b | (std::uint64_t{1} << 63));
+  } else if constexpr (std::is_signed_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<U>(static_cast<U>(v) ^ (U{1} << (sizeof(T) * 8 - 1)));
+  } else {
+    return v;
+  }
+}
+
+// Per-run marshalling state of a string or key/index plugin entry
+template <class T> struct PluginStage {
+  std::vector<char> bytes;                // strings: the arena
+  std::vector<sortbench_str_view> views;  // strings: one view per element
+  std::vector<sortbench_kv> pairs;        // numeric: (key, input position)
+  std::vector<T> values;                  // numeric: input, for the write-back
+};
+
+// Sets the run/stage/unstage of one v3 algorithm for a run's context
+template <class T>
+static void bind_v3(AlgoT<T> &algo, const sortbench_algo_v3 &a, const sortbench_ctx_v3 &base) {
+  sortbench_ctx_v3 ctx = base;
+  ctx.user = a.user;
+  if (auto run = v3_entry<T>(a)) {
+    algo.run = [run, ctx](std::span<T> v) {
+      if (!v.empty()) run(v.data(), v.size(), &ctx);
+    };
+    return;
+  }
+  auto st = std::make_shared<PluginStage<T>>();
+  if constexpr (std::is_same_v<T, std::string>) {
+    algo.stage = [st](std::span<T> v) {
+      std::size_t total = 0;
+      for (const auto &x : v) total += x.size();
+      st->bytes.resize(total);
+      st->views.resize(v.size());
+      char *p = st->bytes.data();
+      for (std::size_t i = 0; i < v.size(); ++i) {
+        std::copy(v[i].begin(), v[i].end(), p);
+        st->views[i] = {p, v[i].size()};
+        p += v[i].size();
+      }
+    };
+    algo.run = [st, run = a.run_str, ctx](std::span<T> v) {
+      if (!v.empty()) run(st->views.data(), v.size(), &ctx);
+    };
+    algo.unstage = [st](std::span<T> v) {
+      for (std::size_t i = 0; i < v.size(); ++i)
+        v[i].assign(st->views[i].ptr, st->views[i].len);
+    };
+  } else {
+    algo.stage = [st](std::span<T> v) {
+      st->values.assign(v.begin(), v.end());
+      st->pairs.resize(v.size());
+      for (std::size_t i = 0; i < v.size(); ++i)
+        st->pairs[i] = {order_key(v[i]), i};
+    };
+    algo.run = [st, run = a.run_kv, ctx](std::span<T> v) {
+      if (!v.empty()) run(st->pairs.data(), v.size(), &ctx);
+    };
+    // Through the indices, so a lost or duplicated index fails verification
+    algo.unstage = [st](std::span<T> v) {
+      for (std::size_t i = 0; i < v.size(); ++i) {
+        const auto idx = st->pairs[i].index;
+        v[i] = idx < st->values.size() ? st->values[idx] : T{};
+      }
+    };
+  }
+}
+
+// Registers the v3 algorithms of one plugin; false when it has none for T
+template <class T>
+static bool add_plugin_v3(get_algos_v3_fn fn, std::vector<AlgoT<T>> &regs) {
+  const sortbench_algo_v3 *arr = nullptr;
+  std::size_t count = 0;
+  if (!fn(&arr, &count) || !arr) return false;
+  // Fields up to run_f64 are the first revision of the struct
+  constexpr std::size_t kMinSize =
+      offsetof(sortbench_algo_v3, run_f64) + sizeof(sortbench_run_f64_v3_fn);
+  // The array was laid out by the plugin's revision of the struct: step by
+  // its size, not ours. Fields it does not have stay null.
+  const std::size_t stride = count ? arr[0].struct_size : 0;
+  if (stride < kMinSize) return false;
+  const char *base = reinterpret_cast<const char *>(arr);
+  bool any_added = false;
+  for (std::size_t i = 0; i < count; ++i) {
+    sortbench_algo_v3 a{};
+    std::memcpy(&a, base + i * stride, std::min(stride, sizeof(a)));
+    if (!a.name) continue;
+    std::size_t elem_size = sizeof(T);
+    if constexpr (std::is_same_v<T, std::string>) {
+      if (!a.run_str) continue;
+      elem_size = sizeof(sortbench_str_view);
+    } else if (!v3_entry<T>(a)) {
+      if (!a.run_kv) continue;
+      elem_size = sizeof(sortbench_kv);
+    }
+    AlgoT<T> algo{a.name, nullptr}; // `run` is set by bind for each run
+    algo.bind = [a](AlgoT<T> &self, const BindContext &bc) { bind_v3<T>(self, a, bc.plugin); };
+    if (auto sb = a.scratch_bytes)
+      algo.scratch_bytes = [sb, elem_size, user = a.user](std::size_t n) {
+        return sb(n, elem_size, user);
+      };
+    algo.caps = a.caps;
+    regs.push_back(std::move(algo));
+    any_added = true;
+  }
+  return any_added;
+}
 
 template <class T>
 static void load_plugins_t(const std::vector<std::string> &paths,
                            std::vector<AlgoT<T>> &regs,
                            std::vector<PluginHandle> &handles) {
-  for (const auto &p : paths) {
+  for (const auto &path : paths) {
+    std::string p;
+    try {
+      p = resolve_plugin_variant(path);
+    } catch (const std::exception &) {
+      continue; // no variant this CPU runs: skipped like one that fails to load
+    }
     void *h = dlopen(p.c_str(), RTLD_NOW);
     if (!h) {
       continue;
     }
     dlerror();
+    if (auto fn3 = reinterpret_cast<get_algos_v3_fn>(
+            dlsym(h, "sortbench_get_algorithms_v3"));
+        fn3 && !dlerror()) {
+      if (add_plugin_v3<T>(fn3, regs)) handles.push_back(h);
+      else dlclose(h);
+      continue;
+    }
+    dlerror();
     if (auto fn2 = reinterpret_cast<get_algos_v2_fn>(
             dlsym(h, "sortbench_get_algorithms_v2"));
         fn2 && !dlerror()) {
@@ -680,27 +596,27 @@ static void load_plugins_t(const std::vector<std::string> &paths,
         std::string nm = a.name;
         if constexpr (std::is_same_v<T, int>) {
           if (!a.run_i32) continue; auto run = a.run_i32;
-          regs.push_back({nm, [run](std::vector<int> &v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
+          regs.push_back({nm, [run](std::span<int> v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
           any_added = true;
         } else if constexpr (std::is_same_v<T, unsigned int>) {
           if (!a.run_u32) continue; auto run = a.run_u32;
-          regs.push_back({nm, [run](std::vector<unsigned int> &v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
+          regs.push_back({nm, [run](std::span<unsigned int> v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
           any_added = true;
         } else if constexpr (std::is_same_v<T, long long>) {
           if (!a.run_i64) continue; auto run = a.run_i64;
-          regs.push_back({nm, [run](std::vector<long long> &v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
+          regs.push_back({nm, [run](std::span<long long> v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
           any_added = true;
         } else if constexpr (std::is_same_v<T, unsigned long long>) {
           if (!a.run_u64) continue; auto run = a.run_u64;
-          regs.push_back({nm, [run](std::vector<unsigned long long> &v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
+          regs.push_back({nm, [run](std::span<unsigned long long> v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
           any_added = true;
         } else if constexpr (std::is_same_v<T, float>) {
           if (!a.run_f32) continue; auto run = a.run_f32;
-          regs.push_back({nm, [run](std::vector<float> &v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
+          regs.push_back({nm, [run](std::span<float> v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
           any_added = true;
         } else if constexpr (std::is_same_v<T, double>) {
           if (!a.run_f64) continue; auto run = a.run_f64;
-          regs.push_back({nm, [run](std::vector<double> &v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
+          regs.push_back({nm, [run](std::span<double> v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
           any_added = true;
         }
       }
@@ -719,7 +635,7 @@ static void load_plugins_t(const std::vector<std::string> &paths,
       for (int i = 0; i < count; ++i) {
         const auto &a = arr[i];
         if (!a.name || !a.run_int) continue; std::string nm = a.name;
-        regs.push_back({nm, [run=a.run_int](std::vector<int> &v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
+        regs.push_back({nm, [run=a.run_int](std::span<int> v){ if(!v.empty()) run(v.data(), (int)v.size()); }});
         any_added = true;
       }
     }
@@ -727,6 +643,263 @@ static void load_plugins_t(const std::vector<std::string> &paths,
   }
 }
 
+// Declared plugin capabilities as a comma-separated list ("" = none)
+static std::string caps_names(unsigned caps) {
+  static constexpr std::pair<unsigned, const char *> kNames[] = {
+      {SORTBENCH_CAP_STABLE, "stable"},
+      {SORTBENCH_CAP_IN_PLACE, "in_place"},
+      {SORTBENCH_CAP_PARALLEL, "parallel"},
+      {SORTBENCH_CAP_STRINGS, "strings"},
+  };
+  std::string out;
+  for (const auto &[bit, name] : kNames)
+    if (caps & bit) out += (out.empty() ? "" : ",") + std::string(name);
+  return out;
+}
+
+// Phase timings and counters one v3 algorithm reports through ctx->sink.
+// Reports are summed per name into `current`; each timed repeat commits them
+// as one sample, and whatever arrives outside a timed repeat is discarded.
+class PluginMetrics {
+public:
+  PluginMetrics() : sink_{this, &PluginMetrics::on_phase, &PluginMetrics::on_counter} {}
+  PluginMetrics(const PluginMetrics &) = delete;
+  PluginMetrics &operator=(const PluginMetrics &) = delete;
+
+  const sortbench_sink_v3 *sink() const { return &sink_; }
+  void discard() {
+    for (auto &s : series_) s.current = 0.0;
+  }
+  void commit() {
+    for (auto &s : series_) {
+      s.samples.push_back(s.current);
+      s.current = 0.0;
+    }
+    ++commits_;
+  }
+  // Median per name over the committed repeats, phases or counters
+  std::vector<std::pair<std::string, double>> medians(bool phases) const {
+    std::vector<std::pair<std::string, double>> out;
+    for (const auto &s : series_)
+      if (s.phase == phases && commits_ > 0) out.emplace_back(s.name, median_of(s.samples));
+    return out;
+  }
+
+private:
+  struct Series {
+    std::string name;
+    bool phase;
+    double current = 0.0;
+    std::vector<double> samples; // one per committed repeat
+  };
+  static double median_of(std::vector<double> v) {
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(v.size() / 2), v.end());
+    return v[v.size() / 2];
+  }
+  // Reports may come from a parallel plugin's worker threads
+  void add(const char *name, bool phase, double v) {
+    if (!name) return;
+    std::lock_guard<std::mutex> lock(mu_);
+    for (auto &s : series_)
+      if (s.phase == phase && s.name == name) {
+        s.current += v;
+        return;
+      }
+    // First seen in a later repeat: earlier repeats reported nothing
+    series_.push_back({name, phase, v, std::vector<double>(commits_, 0.0)});
+  }
+  static void on_phase(void *self, const char *name, double value) {
+    static_cast<PluginMetrics *>(self)->add(name, true, value);
+  }
+  static void on_counter(void *self, const char *name, double value) {
+    static_cast<PluginMetrics *>(self)->add(name, false, value);
+  }
+
+  sortbench_sink_v3 sink_;
+  std::mutex mu_; // guards series_ against concurrent add()
+  std::vector<Series> series_;
+  std::size_t commits_ = 0;
+};
+
+// Client end of one sortbench-plugin-host process (see sortbench_host.hpp).
+// Calls are serialized. The process starts on first use and again after it
+// died, so a crashing plugin fails only the request that crashed it.
+class PluginHost {
+public:
+  PluginHost(std::string exe, std::string plugin)
+      : exe_(std::move(exe)), plugin_(std::move(plugin)) {}
+  ~PluginHost() { (void)sys::reap(proc_, 1000); }
+  PluginHost(const PluginHost &) = delete;
+  PluginHost &operator=(const PluginHost &) = delete;
+
+  std::vector<host::ListReply::Entry> list(ElemType type) {
+    host::Request req;
+    req.op = host::Op::list;
+    req.type = static_cast<std::int32_t>(type);
+    const auto rep = call<host::ListReply>(req, -1);
+    return {rep.algos, rep.algos + std::min<std::size_t>(rep.count, host::kMaxAlgos)};
+  }
+  // Sorts the n elements at the start of the memfd `work_fd` in place
+  host::SortReply sort(ElemType type, std::uint32_t algo, int work_fd, std::size_t n,
+                       int threads, const std::string &cpus) {
+    host::Request req;
+    req.op = host::Op::sort;
+    req.type = static_cast<std::int32_t>(type);
+    req.algo = algo;
+    req.n = n;
+    req.threads = threads;
+    std::snprintf(req.cpus, sizeof(req.cpus), "%s", cpus.c_str());
+    return call<host::SortReply>(req, work_fd);
+  }
+  // Replaces the process, e.g. one still busy with a request nobody waits
+  // for. Called by the parent, so forked children never start (and orphan)
+  // a host of their own.
+  void restart() {
+    std::lock_guard<std::mutex> lock(mu_);
+    (void)sys::reap(proc_, 0);
+    proc_ = sys::spawn_connected(exe_, {plugin_});
+  }
+
+private:
+  template <class Reply> Reply call(host::Request req, int fd) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (proc_.pid <= 0) proc_ = sys::spawn_connected(exe_, {plugin_});
+    // Forked isolated children share the socket: the pid keeps their
+    // sequence numbers apart, and replies to abandoned requests are dropped
+    req.seq = (static_cast<std::uint64_t>(getpid()) << 32) | ++seq_;
+    Reply rep;
+    long got = sys::send_msg(proc_.sock, &req, sizeof(req), fd) ? 1 : 0;
+    while (got > 0) {
+      got = sys::recv_msg(proc_.sock, &rep, sizeof(rep));
+      if (got == static_cast<long>(sizeof(rep)) && rep.seq == req.seq) break;
+    }
+    if (got <= 0) {
+      std::string how = sys::reap(proc_, 1000);
+      if (how == "exit code 127") how += ", is " + exe_ + " installed?";
+      throw std::runtime_error("plugin host for '" + plugin_ + "' exited" +
+                               (how.empty() ? std::string() : " (" + how + ")"));
+    }
+    if (!rep.ok) throw std::runtime_error(std::string("plugin host: ") + rep.error);
+    return rep;
+  }
+
+  std::string exe_, plugin_;
+  std::mutex mu_;
+  sys::Spawned proc_;
+  std::uint32_t seq_ = 0;
+};
+
+// SORTBENCH_PLUGIN_HOST, else sortbench-plugin-host next to the running
+// executable, else the one on PATH
+static std::string plugin_host_exe() {
+  if (const char *env = std::getenv("SORTBENCH_PLUGIN_HOST"); env && *env) return env;
+  const std::string beside = sys::self_exe_dir() + "/sortbench-plugin-host";
+  if (access(beside.c_str(), X_OK) == 0) return beside;
+  return "sortbench-plugin-host";
+}
+
+// The algorithms a plugin host offers for T. Bound runs hand the host the
+// run's work memfd and take its timing and sink reports as their own.
+template <class T>
+static void add_hosted_t(const std::shared_ptr<PluginHost> &hp, ElemType type,
+                         std::vector<AlgoT<T>> &regs) {
+  const auto entries = hp->list(type);
+  for (std::uint32_t k = 0; k < entries.size(); ++k) {
+    AlgoT<T> algo{entries[k].name, nullptr};
+    algo.caps = entries[k].caps;
+    algo.hosted = true;
+    algo.abandon = [hp] { hp->restart(); };
+    algo.bind = [hp, type, k](AlgoT<T> &self, const BindContext &bc) {
+      auto last_ms = std::make_shared<double>(0.0);
+      auto last_mem = std::make_shared<alloc::Stats>();
+      self.run = [hp, type, k, bc, last_ms, last_mem](std::span<T> v) {
+        const host::SortReply r =
+            hp->sort(type, k, bc.work_fd, v.size(), bc.plugin.threads, bc.cpus);
+        *last_ms = r.ms;
+        last_mem->peak_extra_bytes = r.peak_extra_bytes;
+        last_mem->alloc_count = r.alloc_count;
+        last_mem->minor_faults = r.minor_faults;
+        const sortbench_sink_v3 *sink = bc.plugin.sink;
+        for (std::uint32_t m = 0; m < std::min<std::size_t>(r.metric_count, host::kMaxMetrics); ++m)
+          (r.metrics[m].phase ? sink->phase_ms : sink->counter)(sink->self, r.metrics[m].name,
+                                                               r.metrics[m].value);
+      };
+      self.reported_ms = [last_ms] { return *last_ms; };
+      self.reported_mem = [last_mem] { return *last_mem; };
+    };
+    regs.push_back(std::move(algo));
+  }
+}
+
+// Built-ins plus the plugins of one path list. Holds its own dlopen
+// references, so a run keeps its plugins loaded even if the session that
+// handed it the registry is invalidated meanwhile.
+template <class T> struct Registry {
+  std::vector<AlgoT<T>> algos;
+  std::vector<PluginHandle> handles;
+  std::vector<std::shared_ptr<PluginHost>> hosts; // isolated plugins
+  Registry() = default;
+  Registry(const Registry &) = delete;
+  Registry &operator=(const Registry &) = delete;
+  ~Registry() {
+    algos.clear(); // before the code their closures point into goes away
+    for (void *h : handles)
+      if (h) dlclose(h);
+  }
+};
+
+namespace detail {
+// Registries and generated inputs that outlive one run. A plain
+// run_benchmark call uses a throwaway state that keeps no inputs.
+struct SessionState {
+  struct Dataset {
+    std::shared_ptr<const void> buffer; // const detail::Buffer<T>
+    input::Meta meta;
+    std::uint64_t bytes = 0;
+    std::uint64_t last_use = 0;
+  };
+
+  std::mutex mu; // guards the maps; runs themselves proceed unlocked
+  // Per element type and plugin list; each holds a Registry<T>
+  std::map<std::string, std::shared_ptr<const void>> registries;
+  std::map<std::string, Dataset> datasets;
+  std::uint64_t dataset_bytes = 0;
+  std::uint64_t dataset_max_bytes = 0;
+  std::uint64_t tick = 0;
+};
+} // namespace detail
+
+template <class T>
+static std::shared_ptr<const Registry<T>>
+registry_for(detail::SessionState &state, ElemType type,
+             const std::vector<std::string> &plugin_paths,
+             const std::vector<std::string> &isolated_paths, IsaLevel isa) {
+  std::lock_guard<std::mutex> lock(state.mu);
+  std::string key(elem_type_name(type));
+  key += '\n';
+  key += isa_level_name(isa);
+  for (const auto &p : plugin_paths) key += '\n' + p;
+  for (const auto &p : isolated_paths) key += "\nhost:" + p;
+  if (auto it = state.registries.find(key); it != state.registries.end())
+    return std::static_pointer_cast<const Registry<T>>(it->second);
+  auto regs = std::make_shared<Registry<T>>();
+  regs->algos = build_registry_t<T>(isa);
+  if (!plugin_paths.empty())
+    load_plugins_t<T>(plugin_paths, regs->algos, regs->handles);
+  for (const auto &p : isolated_paths) {
+    // The host sorts a shared memfd in place: trivially copyable types only
+    if constexpr (!detail::Buffer<T>::kMappable) {
+      throw std::runtime_error("isolated plugins support numeric element types only");
+    } else {
+      auto hp = std::make_shared<PluginHost>(plugin_host_exe(), resolve_plugin_variant(p));
+      add_hosted_t<T>(hp, type, regs->algos);
+      regs->hosts.push_back(std::move(hp));
+    }
+  }
+  state.registries.emplace(key, regs);
+  return regs;
+}
+
 static bool name_selected(const std::vector<std::string> &selected,
                           const std::vector<std::regex> &selected_re,
                           const std::string &name) {
@@ -754,21 +927,173 @@ static bool name_excluded(const std::vector<std::string> &excluded,
   return false;
 }
 
+static bool canceled(const CoreConfig &cfg) {
+  return cfg.cancel && cfg.cancel->load(std::memory_order_relaxed);
+}
+
+// Thrown by make_input when the run is canceled during generation, so a
+// partly filled input is never cached
+struct InputCanceled {};
+
 static bool is_default_slow(const std::string &name) {
   std::string ln = to_lower(name);
   return (ln == "bubble_sort" || ln == "insertion_sort" || ln == "selection_sort");
 }
 
+// Benchmark input: read from cfg.input_path, or generated and served from
+// cfg.cache_dir when a matching dump exists. `meta` gets the file identity or
+// the cache state ("hit", "miss" or why the dump could not be stored).
+template <class T>
+static detail::Buffer<T> make_input(const CoreConfig &cfg, std::uint64_t seed,
+                                    input::Meta &meta) {
+  if (!cfg.input_path.empty())
+    return input::load<T>(cfg, seed, meta);
+  meta.emplace_back("generator", std::to_string(kGeneratorVersion));
+  if (cfg.dist == Dist::adversarial)
+    meta.emplace_back("adversary", cfg.adversary);
+  auto generate = [&] {
+    // Numeric generators run at the run's instruction-set level; the output
+    // is the same at every level
+    auto make_data = [&] {
+      if constexpr (std::is_arithmetic_v<T>)
+        return kernels::get<T>(kernels::active_level())
+            .make_data(cfg.N, cfg.dist, seed, cfg.partial_shuffle_pct, cfg.dup_values, cfg);
+      else
+        return gen::make_data<T>(cfg.N, cfg.dist, seed, cfg.partial_shuffle_pct,
+                                 cfg.dup_values, cfg);
+    };
+    std::vector<T> v =
+        cfg.dist == Dist::adversarial
+            ? adversary::to_values<T>(killer_input(cfg.adversary, cfg.N)->ranks)
+            : make_data();
+    if (canceled(cfg)) throw InputCanceled{};
+    return v;
+  };
+  if constexpr (detail::Buffer<T>::kMappable) {
+    if (!cfg.cache_dir.empty()) {
+      const std::string key = cache::dataset_key(cfg, seed);
+      if (auto region = cache::load(cfg.cache_dir, key, cfg, sizeof(T))) {
+        meta.emplace_back("dataset_cache", "hit");
+        detail::Buffer<T> mapped(std::move(*region), cfg.N);
+        if (cfg.buffers == BufferMode::standard) return mapped;
+        detail::Buffer<T> placed(cfg.N, cfg.buffers);
+        std::copy(mapped.span().begin(), mapped.span().end(), placed.span().begin());
+        return placed;
+      }
+      std::vector<T> v = generate();
+      std::string state = "miss";
+      try {
+        cache::store(cfg.cache_dir, key, cfg, v.data(), sizeof(T), cfg.cache_max_bytes);
+      } catch (const std::exception &e) {
+        state = std::string("miss (not stored: ") + e.what() + ")";
+      }
+      meta.emplace_back("dataset_cache", state);
+      return detail::Buffer<T>(std::move(v), cfg.buffers);
+    }
+  }
+  return detail::Buffer<T>(generate(), cfg.buffers);
+}
+
+// Whether a run's input must live in a sealed memfd (Buffer::sealed):
+// isolated children and snapshot resets need one, automatic reset only
+// considers a snapshot when it can have one
+enum class Seal { no, prefer, require };
+
+// `buf` moved into a sealed memfd when `seal` asks for it; the heap copy is
+// freed once the caller drops the original
+template <class T>
+static std::shared_ptr<const detail::Buffer<T>>
+sealed_input(std::shared_ptr<const detail::Buffer<T>> buf, Seal seal) {
+  if constexpr (detail::Buffer<T>::kMappable) {
+    if (seal != Seal::no && !buf->snapshot()) {
+      try {
+        return std::make_shared<const detail::Buffer<T>>(buf->sealed());
+      } catch (const std::exception &) {
+        if (seal == Seal::require) throw;
+      }
+    }
+  }
+  return buf;
+}
+
+// Input for one run: generated inputs are kept in the session (LRU by bytes)
+// and reused by later runs with the same generator parameters and buffers. A
+// sealed input replaces the cached one, so only one copy stays resident.
+template <class T>
+static std::shared_ptr<const detail::Buffer<T>>
+input_for(detail::SessionState &state, const CoreConfig &cfg, std::uint64_t seed,
+          input::Meta &meta, Seal seal) {
+  if (!cfg.input_path.empty() || state.dataset_max_bytes == 0)
+    return sealed_input<T>(std::make_shared<const detail::Buffer<T>>(make_input<T>(cfg, seed, meta)),
+                           seal);
+  const std::string key = cache::dataset_key(cfg, seed) + " buffers=" +
+                          std::string(buffer_mode_name(cfg.buffers));
+  std::shared_ptr<const detail::Buffer<T>> cached;
+  {
+    std::lock_guard<std::mutex> lock(state.mu);
+    if (auto it = state.datasets.find(key); it != state.datasets.end()) {
+      it->second.last_use = ++state.tick;
+      meta = it->second.meta;
+      meta.emplace_back("session_dataset", "hit");
+      cached = std::static_pointer_cast<const detail::Buffer<T>>(it->second.buffer);
+    }
+  }
+  if (cached) {
+    auto buf = sealed_input<T>(cached, seal);
+    if (buf != cached) {
+      std::lock_guard<std::mutex> lock(state.mu);
+      if (auto it = state.datasets.find(key);
+          it != state.datasets.end() && it->second.buffer == cached)
+        it->second.buffer = buf;
+    }
+    return buf;
+  }
+  // Generated unlocked; a concurrent miss on the same key just stores it twice
+  auto buf = sealed_input<T>(
+      std::make_shared<const detail::Buffer<T>>(make_input<T>(cfg, seed, meta)), seal);
+  std::uint64_t bytes = buf->size() * sizeof(T);
+  if constexpr (std::is_same_v<T, std::string>)
+    for (const auto &s : buf->span()) bytes += s.capacity();
+  std::lock_guard<std::mutex> lock(state.mu);
+  if (bytes <= state.dataset_max_bytes && !state.datasets.count(key)) {
+    while (state.dataset_bytes + bytes > state.dataset_max_bytes) {
+      auto lru = std::min_element(state.datasets.begin(), state.datasets.end(),
+                                  [](const auto &a, const auto &b) {
+                                    return a.second.last_use < b.second.last_use;
+                                  });
+      state.dataset_bytes -= lru->second.bytes;
+      state.datasets.erase(lru);
+    }
+    state.datasets.emplace(key, detail::SessionState::Dataset{buf, meta, bytes, ++state.tick});
+    state.dataset_bytes += bytes;
+  }
+  meta.emplace_back("session_dataset", "miss");
+  return buf;
+}
+
 template <class T>
-static double benchmark_once_t(const std::function<void(std::vector<T> &)> &fn,
-                               const std::vector<T> &original,
-                               std::vector<T> &work, bool check_sorted,
-                               const char *algo_name = nullptr) {
-  work.resize(original.size());
-  std::copy(original.begin(), original.end(), work.begin());
+static double benchmark_once_t(const AlgoT<T> &algo,
+                               reset::Engine<T> &reset, std::span<T> work,
+                               bool check_sorted,
+                               const char *algo_name = nullptr,
+                               alloc::Stats *mem = nullptr,
+                               double *reset_ms = nullptr) {
+  const double r = reset();
+  if (reset_ms) *reset_ms = r;
+  if (algo.stage) algo.stage(work);
+  std::optional<alloc::Scope> mem_scope;
+  if (mem) mem_scope.emplace();
   auto t0 = Clock::now();
-  fn(work);
+  algo.run(work);
   auto t1 = Clock::now();
+  if (mem) {
+    *mem = mem_scope->finish();
+    if (algo.reported_mem) *mem = algo.reported_mem();
+  }
+  if (algo.unstage) algo.unstage(work);
+  const double elapsed = algo.reported_ms
+                             ? algo.reported_ms()
+                             : std::chrono::duration_cast<ms>(t1 - t0).count();
   if (check_sorted) {
     if (!std::is_sorted(work.begin(), work.end())) {
       std::string msg = "Assertion failed: output not sorted";
@@ -780,7 +1105,7 @@ static double benchmark_once_t(const std::function<void(std::vector<T> &)> &fn,
       throw std::runtime_error(msg);
     }
   }
-  return std::chrono::duration_cast<ms>(t1 - t0).count();
+  return elapsed;
 }
 
 static double median(std::vector<double> v) {
@@ -797,38 +1122,20 @@ static double median(std::vector<double> v) {
   return 0.5 * (a + b);
 }
 
-template <class T> static RunResult run_for_type_core(const CoreConfig &cfg) {
-  // thread limits
-  if (cfg.threads > 0) {
-#ifdef _OPENMP
-    omp_set_num_threads(cfg.threads);
-#endif
-  }
-#if SB_HAS_TBB
-  std::unique_ptr<tbb::global_control> tbb_ctrl;
-  if (cfg.threads > 0) {
-    tbb_ctrl = std::make_unique<tbb::global_control>(
-        tbb::global_control::max_allowed_parallelism,
-        static_cast<std::size_t>(cfg.threads));
-  }
-#endif
-
-  auto regs = build_registry_t<T>();
-  std::vector<PluginHandle> plugin_handles;
-  if (!cfg.plugin_paths.empty())
-    load_plugins_t<T>(cfg.plugin_paths, regs, plugin_handles);
-  // Phase 1: no plugin loading here (will be added later)
-
-  std::mt19937_64 rng(cfg.seed.value_or(default_seed()));
-  std::vector<T> original = make_data<T>(
-      cfg.N, cfg.dist, rng, cfg.partial_shuffle_pct, cfg.dup_values, cfg);
-  std::vector<T> work;
-
-  if (cfg.verify) {
-    auto ref = original;
-    std::sort(ref.begin(), ref.end());
-    for (const auto &algo : regs) {
-      const bool any_includes = (!cfg.algos.empty() || !cfg.algo_regex.empty());
+// The run itself, inside its ThreadScope (see run_for_type_core)
+template <class T>
+static RunResult run_scoped(const CoreConfig &cfg, detail::SessionState &state,
+                            Observer *obs, const std::vector<int> &cpuset) {
+  const bool isolated = cfg.isolate || cfg.algo_timeout_ms > 0;
+  const IsaLevel isa = kernels::active_level();
+  const auto regs =
+      registry_for<T>(state, cfg.type, cfg.plugin_paths, cfg.isolated_plugin_paths, isa);
+
+  // Selected algorithms, in registry order
+  std::vector<const AlgoT<T> *> selected;
+  {
+    const bool any_includes = (!cfg.algos.empty() || !cfg.algo_regex.empty());
+    for (const auto &algo : regs->algos) {
       if (!name_selected(cfg.algos, cfg.algo_regex, algo.name))
         continue;
       if (name_excluded(cfg.exclude_algos, cfg.exclude_regex, algo.name))
@@ -836,45 +1143,228 @@ template <class T> static RunResult run_for_type_core(const CoreConfig &cfg) {
       // Apply default slow excludes only when no explicit include filters are set
       if (!any_includes && is_default_slow(algo.name))
         continue;
-      work = original;
-      algo.run(work);
-      if (!std::is_sorted(work.begin(), work.end()))
-        throw std::runtime_error(
-            std::string("Verification failed (not sorted): ") + algo.name);
-      if (work != ref)
-        throw std::runtime_error(
-            std::string("Verification mismatch vs std::sort: ") + algo.name);
+      selected.push_back(&algo);
     }
   }
 
-  struct RowTmp {
-    std::string algo;
-    double med;
-    double tmin;
-    double tmax;
-    double mean;
-    double sdev;
+  if (obs) {
+    std::vector<std::string> names;
+    for (const auto *ap : selected) names.push_back(ap->name);
+    obs->on_start(names);
+  }
+
+  // Canceled before the input is ready: every row is "canceled"
+  auto canceled_early = [&] {
+    RunResult out;
+    out.type = cfg.type;
+    out.N = cfg.N;
+    out.dist = cfg.input_path.empty() ? std::string(dist_name(cfg.dist)) : "file";
+    out.repeats = std::max(1, cfg.repeats);
+    out.seed = cfg.seed;
+    out.baseline = cfg.baseline;
+    out.canceled = true;
+    for (const auto *ap : selected) {
+      ResultRow rr;
+      rr.algo = ap->name;
+      rr.N = out.N;
+      rr.dist = out.dist;
+      rr.speedup_vs_baseline = 0.0;
+      rr.status = "canceled";
+      if (obs) obs->on_row(rr);
+      out.rows.push_back(std::move(rr));
+    }
+    return out;
   };
-  std::vector<RowTmp> tmp;
 
-  for (const auto &algo : regs) {
-    const bool any_includes = (!cfg.algos.empty() || !cfg.algo_regex.empty());
-    if (!name_selected(cfg.algos, cfg.algo_regex, algo.name))
-      continue;
-    if (name_excluded(cfg.exclude_algos, cfg.exclude_regex, algo.name))
-      continue;
-    if (!any_includes && is_default_slow(algo.name))
-      continue;
-    for (int w = 0; w < cfg.warmup; ++w) {
-      (void)benchmark_once_t<T>(algo.run, original, work, cfg.assert_sorted,
-                                algo.name.c_str());
+  // Plugin hosts sort the work buffer in place through a shared memfd
+  const bool hosted = std::any_of(selected.begin(), selected.end(),
+                                  [](const AlgoT<T> *ap) { return ap->hosted; });
+  // Isolated children read the sealed input in place and cannot corrupt it;
+  // snapshot resets map views of the same memfd
+  Seal seal = Seal::no;
+  if (isolated || cfg.reset == ResetMode::snapshot)
+    seal = Seal::require;
+  else if (cfg.reset == ResetMode::automatic && cfg.placement == Placement::local && !hosted &&
+           (!cfg.input_path.empty() || cfg.N * sizeof(T) >= kResetAutoMinBytes))
+    seal = Seal::prefer;
+
+  input::Meta input_meta;
+  const auto input_t0 = Clock::now();
+  std::shared_ptr<const detail::Buffer<T>> input;
+  try {
+    input = input_for<T>(state, cfg, cfg.seed.value_or(default_seed()), input_meta, seal);
+  } catch (const InputCanceled &) {
+    return canceled_early();
+  }
+  const double input_ms = std::chrono::duration_cast<ms>(Clock::now() - input_t0).count();
+  int work_fd = -1;
+  detail::Buffer<T> scratch;
+  if constexpr (detail::Buffer<T>::kMappable)
+    if (hosted)
+      scratch = detail::Buffer<T>(sys::map_memfd(input->size() * sizeof(T), &work_fd),
+                                  input->size());
+  if (work_fd < 0) scratch = detail::Buffer<T>(input->size(), cfg.buffers, cfg.placement);
+  const std::unique_ptr<int, void (*)(int *)> work_fd_owner(
+      work_fd >= 0 ? &work_fd : nullptr, [](int *fd) { close(*fd); });
+  const std::span<const T> original = input->span();
+  reset::Engine<T> reset(*input, scratch, cfg.reset, cfg.placement, hosted);
+  std::span<T> work = scratch.span();
+
+  // v3 plugins share one harness-owned scratch area, sized for the largest
+  // request and faulted in here so it stays out of the timings
+  std::vector<std::size_t> plugin_scratch_of(selected.size(), 0);
+  for (std::size_t i = 0; i < selected.size(); ++i)
+    if (selected[i]->scratch_bytes)
+      plugin_scratch_of[i] = selected[i]->scratch_bytes(work.size());
+  detail::Buffer<unsigned char> plugin_scratch;
+  if (const auto most = std::max_element(plugin_scratch_of.begin(), plugin_scratch_of.end());
+      most != plugin_scratch_of.end() && *most > 0)
+    plugin_scratch = detail::Buffer<unsigned char>(*most, cfg.buffers, cfg.placement);
+  int thread_hint = cfg.threads;
+#ifdef _OPENMP
+  if (thread_hint <= 0) thread_hint = omp_get_max_threads();
+#endif
+  thread_hint = std::max(1, thread_hint);
+  std::deque<AlgoT<T>> bound; // selected algorithms with bind, with their context
+  std::vector<std::unique_ptr<PluginMetrics>> metrics(selected.size());
+  for (std::size_t i = 0; i < selected.size(); ++i) {
+    if (!selected[i]->bind) continue;
+    metrics[i] = std::make_unique<PluginMetrics>();
+    sortbench_ctx_v3 ctx{};
+    ctx.scratch_bytes = plugin_scratch_of[i];
+    ctx.scratch = ctx.scratch_bytes ? plugin_scratch.span().data() : nullptr;
+    ctx.threads = thread_hint;
+    ctx.sink = metrics[i]->sink();
+    BindContext bc{ctx, work_fd, format_cpu_list(cfg.cpus)};
+    AlgoT<T> b = *selected[i];
+    b.bind(b, bc);
+    bound.push_back(std::move(b));
+    selected[i] = &bound.back();
+  }
+
+  // Reference mode keeps a sorted copy; fingerprint mode only a multiset hash
+  VerifyMode verify_mode = cfg.verify_mode;
+  if (verify_mode == VerifyMode::automatic)
+    verify_mode = original.size() >= kVerifyFingerprintMinN ? VerifyMode::fingerprint
+                                                            : VerifyMode::reference;
+  std::vector<T> ref;
+  verify::Fingerprint input_fp;
+  if (cfg.verify) {
+    if (verify_mode == VerifyMode::reference) {
+      ref.assign(original.begin(), original.end());
+      std::sort(ref.begin(), ref.end());
+    } else {
+      input_fp = verify::fingerprint<T>(original);
+    }
+  }
+  auto verify_one = [&](const AlgoT<T> &algo) {
+    (void)reset();
+    if (algo.stage) algo.stage(work);
+    algo.run(work);
+    if (algo.unstage) algo.unstage(work);
+    if (!verify::sorted<T>(work))
+      throw std::runtime_error(
+          std::string("Verification failed (not sorted): ") + algo.name);
+    if (verify_mode == VerifyMode::fingerprint) {
+      if (!(verify::fingerprint<T>(work) == input_fp))
+        throw std::runtime_error(
+            std::string("Verification failed (output is not a permutation of the input): ") +
+            algo.name);
+    } else if (!std::equal(work.begin(), work.end(), ref.begin(), ref.end())) {
+      throw std::runtime_error(
+          std::string("Verification mismatch vs std::sort: ") + algo.name);
     }
-    std::vector<double> times;
-    times.reserve(static_cast<std::size_t>(std::max(1, cfg.repeats)));
-    for (int rep = 0; rep < std::max(1, cfg.repeats); ++rep) {
-      times.push_back(benchmark_once_t<T>(
-          algo.run, original, work, cfg.assert_sorted, algo.name.c_str()));
+  };
+  // Isolated runs verify inside each child so a bad algorithm only fails its row
+  if (cfg.verify && !isolated)
+    for (const auto *ap : selected) {
+      if (canceled(cfg)) break;
+      verify_one(*ap);
     }
+
+  RunResult out;
+  out.type = cfg.type;
+  out.N = input->size();
+  out.dist = cfg.input_path.empty() ? std::string(dist_name(cfg.dist)) : "file";
+  out.repeats = std::max(1, cfg.repeats);
+  out.seed = cfg.seed;
+  out.baseline = cfg.baseline;
+  out.meta.emplace_back("cpuset", format_cpu_list(cpuset));
+  out.meta.emplace_back("pinned", cfg.cpus.empty() ? "no" : "yes");
+  out.meta.emplace_back("governor", sys::cpu_governor(cpuset));
+  out.meta.emplace_back("schedule", std::string(schedule_name(cfg.schedule)));
+  out.meta.emplace_back("alloc_hooks", alloc::hooks_enabled() ? "yes" : "no");
+  if constexpr (std::is_arithmetic_v<T>) // built-ins and generator
+    out.meta.emplace_back("isa", std::string(isa_level_name(isa)));
+  for (auto &m : input_meta) out.meta.push_back(std::move(m));
+  if (cfg.analyze)
+    for (auto &m : analyze::profile<T>(original)) out.meta.push_back(std::move(m));
+  if (cfg.verify)
+    out.meta.emplace_back("verify", std::string(verify_mode_name(verify_mode)));
+  out.meta.emplace_back("buffers", std::string(buffer_mode_name(cfg.buffers)));
+  out.meta.emplace_back("buffer_backing", scratch.backing());
+  out.meta.emplace_back("placement", std::string(placement_name(cfg.placement)));
+  out.meta.emplace_back("reset", std::string(reset_mode_name(reset.mode())));
+  if (isolated) {
+    out.meta.emplace_back("isolated", "yes");
+    if (cfg.algo_timeout_ms > 0)
+      out.meta.emplace_back("algo_timeout_ms", std::to_string(cfg.algo_timeout_ms));
+  }
+  if (hosted) out.meta.emplace_back("plugin_host", "yes");
+  // Bring cores up to a steady clock before anything is timed
+  sys::SpinUpResult spun;
+  if (cfg.spin_up) spun = sys::spin_up(cfg.threads);
+  if (cfg.spin_up) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.1f", spun.elapsed_ms);
+    out.meta.emplace_back("spin_up_ms", buf);
+    out.meta.emplace_back("clock_stable", spun.stable ? "yes" : "no");
+  }
+  if (obs) obs->on_input(out, input_ms);
+
+  const int reps = std::max(1, cfg.repeats);
+  std::vector<std::vector<double>> all_times(selected.size());
+  for (auto &t : all_times) t.reserve(static_cast<std::size_t>(reps));
+  // Memory figures are the worst case over the timed repeats
+  std::vector<alloc::Stats> all_mem(selected.size());
+  std::vector<std::vector<double>> all_resets(selected.size());
+  auto run_one = [&](std::size_t i) {
+    const auto &algo = *selected[i];
+    return benchmark_once_t<T>(algo, reset, work, cfg.assert_sorted,
+                               algo.name.c_str());
+  };
+  auto run_timed = [&](std::size_t i) {
+    const auto &algo = *selected[i];
+    alloc::Stats m;
+    double r = 0.0;
+    if (metrics[i]) metrics[i]->discard();
+    double t = benchmark_once_t<T>(algo, reset, work, cfg.assert_sorted,
+                                   algo.name.c_str(), &m, &r);
+    if (metrics[i]) metrics[i]->commit();
+    all_resets[i].push_back(r);
+    auto &acc = all_mem[i];
+    acc.peak_extra_bytes = std::max(acc.peak_extra_bytes, m.peak_extra_bytes);
+    acc.alloc_count = std::max(acc.alloc_count, m.alloc_count);
+    acc.minor_faults = std::max(acc.minor_faults, m.minor_faults);
+    acc.overlapped = acc.overlapped || m.overlapped;
+    all_times[i].push_back(t);
+  };
+  // Not used inside isolated children: their repeats are reported afterwards
+  auto run_observed = [&](std::size_t i) {
+    run_timed(i);
+    if (obs)
+      obs->on_repeat(selected[i]->name, static_cast<int>(all_times[i].size()) - 1,
+                     all_times[i].back());
+  };
+
+  std::vector<std::string> status(selected.size(), "ok");
+  std::vector<std::string> errors(selected.size());
+  // Plugin metrics that isolated children sent back
+  std::vector<std::vector<std::pair<std::string, double>>> plugin_phases(selected.size()),
+      plugin_counters(selected.size());
+
+  auto make_row = [&](std::size_t ai) {
+    const std::vector<double> &times = all_times[ai];
     double med = median(times);
     auto mm = std::minmax_element(times.begin(), times.end());
     double tmin = (mm.first != times.end() ? *mm.first : med);
@@ -893,66 +1383,329 @@ template <class T> static RunResult run_for_type_core(const CoreConfig &cfg) {
       var /= static_cast<double>(times.size());
     }
     double sdev = (times.size() >= 2 ? std::sqrt(var) : 0.0);
-    tmp.push_back(RowTmp{algo.name, med, tmin, tmax, mean, sdev});
+    ResultRow rr;
+    rr.algo = selected[ai]->name;
+    rr.N = out.N;
+    rr.dist = out.dist;
+    rr.stats = TimingStats{med, mean, tmin, tmax, sdev};
+    rr.peak_extra_bytes = all_mem[ai].peak_extra_bytes;
+    rr.alloc_count = all_mem[ai].alloc_count;
+    rr.minor_faults = all_mem[ai].minor_faults;
+    rr.reset_ms = median(all_resets[ai]);
+    rr.scratch_bytes = plugin_scratch_of[ai];
+    rr.caps = caps_names(selected[ai]->caps);
+    rr.isa = selected[ai]->isa;
+    if (!plugin_phases[ai].empty() || !plugin_counters[ai].empty()) {
+      rr.phase_ms = plugin_phases[ai];
+      rr.counters = plugin_counters[ai];
+    } else if (metrics[ai]) {
+      rr.phase_ms = metrics[ai]->medians(true);
+      rr.counters = metrics[ai]->medians(false);
+    }
+    rr.status = status[ai];
+    rr.error = errors[ai];
+    return rr;
+  };
+  auto finish = [&](std::size_t ai) {
+    if (obs) obs->on_row(make_row(ai));
+  };
+
+  if (isolated) {
+    // Verify, warmups and timed repeats of each algorithm run in a forked
+    // child; results come back through a shared page, so a crash or hang
+    // costs only that algorithm's row.
+    struct IsoMetric {
+      char name[48];
+      bool phase;
+      double value;
+    };
+    struct IsoSlot {
+      alloc::Stats mem;
+      double reset_ms;
+      std::uint32_t completed;
+      char error[256];
+      std::uint32_t metric_count;
+      IsoMetric metrics[32];
+    };
+    sys::Region shm = sys::map_shared(sizeof(IsoSlot) +
+                                      static_cast<std::size_t>(reps) * sizeof(double));
+    auto *slot = static_cast<IsoSlot *>(shm.ptr);
+    auto *slot_times =
+        reinterpret_cast<double *>(static_cast<char *>(shm.ptr) + sizeof(IsoSlot));
+    for (std::size_t i = 0; i < selected.size() && !canceled(cfg); ++i) {
+      *slot = IsoSlot{};
+      auto child = sys::run_in_child(
+          [&]() -> int {
+            try {
+              sys::PinScope child_pin(cfg.cpus, cfg.threads); // fresh OMP pool
+              if (cfg.verify) verify_one(*selected[i]);
+              for (int w = 0; w < cfg.warmup; ++w) (void)run_one(i);
+              for (int rep = 0; rep < reps; ++rep) {
+                run_timed(i);
+                slot_times[rep] = all_times[i].back();
+                slot->completed = static_cast<std::uint32_t>(rep + 1);
+              }
+              slot->mem = all_mem[i];
+              slot->reset_ms = median(all_resets[i]);
+              if (metrics[i])
+                for (bool phase : {true, false})
+                  for (const auto &[name, v] : metrics[i]->medians(phase)) {
+                    if (slot->metric_count == std::size(slot->metrics)) break;
+                    auto &m = slot->metrics[slot->metric_count++];
+                    std::snprintf(m.name, sizeof(m.name), "%s", name.c_str());
+                    m.phase = phase;
+                    m.value = v;
+                  }
+              return 0;
+            } catch (const std::exception &e) {
+              std::snprintf(slot->error, sizeof(slot->error), "%s", e.what());
+              return 1;
+            }
+          },
+          cfg.algo_timeout_ms, cfg.cancel);
+      using Kind = sys::ChildResult::Kind;
+      if (child.kind == Kind::exited && child.code == 0) {
+        all_times[i].assign(slot_times, slot_times + slot->completed);
+        all_mem[i] = slot->mem;
+        all_resets[i].assign(1, slot->reset_ms);
+        for (std::uint32_t k = 0; k < slot->metric_count; ++k) {
+          const auto &m = slot->metrics[k];
+          (m.phase ? plugin_phases : plugin_counters)[i].emplace_back(m.name, m.value);
+        }
+      } else if (child.kind == Kind::canceled) {
+        status[i] = "canceled";
+      } else if (child.kind == Kind::timed_out) {
+        status[i] = "timeout";
+        errors[i] = child.detail;
+      } else if (child.kind == Kind::exited && child.code == 1) {
+        status[i] = "failed";
+        errors[i] = slot->error;
+      } else {
+        status[i] = "crashed";
+        errors[i] = child.detail;
+      }
+      if (status[i] != "ok" && selected[i]->abandon) selected[i]->abandon();
+      if (obs)
+        for (std::size_t rep = 0; rep < all_times[i].size(); ++rep)
+          obs->on_repeat(selected[i]->name, static_cast<int>(rep), all_times[i][rep]);
+      finish(i);
+    }
+    sys::unmap_region(shm);
+  } else if (cfg.schedule == Schedule::sequential) {
+    for (std::size_t i = 0; i < selected.size() && !canceled(cfg); ++i) {
+      for (int w = 0; w < cfg.warmup && !canceled(cfg); ++w) (void)run_one(i);
+      for (int rep = 0; rep < reps && !canceled(cfg); ++rep) run_observed(i);
+      if (all_times[i].size() == static_cast<std::size_t>(reps)) finish(i);
+    }
+  } else {
+    // Interleave rounds so drift (thermal, frequency, allocator state) is
+    // spread across all algorithms instead of biasing the later ones.
+    std::vector<std::size_t> order(selected.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::mt19937_64 sched_rng(cfg.seed.value_or(default_seed()) ^
+                              0xD1B54A32D192ED03ULL);
+    auto next_round = [&]() {
+      if (cfg.schedule == Schedule::shuffled)
+        std::shuffle(order.begin(), order.end(), sched_rng);
+    };
+    for (int w = 0; w < cfg.warmup && !canceled(cfg); ++w) {
+      next_round();
+      for (std::size_t i : order)
+        if (!canceled(cfg)) (void)run_one(i);
+    }
+    for (int rep = 0; rep < reps && !canceled(cfg); ++rep) {
+      next_round();
+      for (std::size_t i : order)
+        if (!canceled(cfg)) run_observed(i);
+    }
+    for (std::size_t i = 0; i < selected.size(); ++i)
+      if (all_times[i].size() == static_cast<std::size_t>(reps)) finish(i);
+  }
+
+  // Canceled: algorithms short of their repeats keep no partial timings
+  if (canceled(cfg)) {
+    out.canceled = true;
+    for (std::size_t i = 0; i < selected.size(); ++i) {
+      if (status[i] != "ok" || all_times[i].size() == static_cast<std::size_t>(reps))
+        continue;
+      status[i] = "canceled";
+      all_times[i].clear();
+      all_resets[i].clear();
+      all_mem[i] = alloc::Stats{};
+      finish(i);
+    }
   }
 
+  // Memory accounting is process-wide: flag runs that overlapped another
+  if (std::any_of(all_mem.begin(), all_mem.end(),
+                  [](const alloc::Stats &m) { return m.overlapped; }))
+    out.meta.emplace_back("alloc_overlap", "yes");
+  out.rows.reserve(selected.size());
+  for (std::size_t ai = 0; ai < selected.size(); ++ai) out.rows.push_back(make_row(ai));
+
   // compute baseline speedup
   double baseline_med = 0.0;
   std::string baseline_name;
   if (cfg.baseline.has_value()) {
     baseline_name = to_lower(*cfg.baseline);
-    for (const auto &r : tmp) {
-      if (to_lower(r.algo) == baseline_name) {
-        baseline_med = r.med;
+    for (const auto &r : out.rows) {
+      if (r.status == "ok" && to_lower(r.algo) == baseline_name) {
+        baseline_med = r.stats.median_ms;
         break;
       }
     }
   }
-
-  RunResult out;
-  out.type = cfg.type;
-  out.N = cfg.N;
-  out.dist = std::string(dist_name(cfg.dist));
-  out.repeats = std::max(1, cfg.repeats);
-  out.seed = cfg.seed;
-  out.baseline = cfg.baseline;
-  out.rows.reserve(tmp.size());
-  for (const auto &r : tmp) {
-    ResultRow rr;
-    rr.algo = r.algo;
-    rr.N = cfg.N;
-    rr.dist = out.dist;
-    rr.stats = TimingStats{r.med, r.mean, r.tmin, r.tmax, r.sdev};
+  for (auto &rr : out.rows) {
     rr.speedup_vs_baseline =
-        (baseline_med > 0.0 ? (baseline_med / std::max(1e-12, r.med)) : 1.0);
-    out.rows.push_back(std::move(rr));
+        (baseline_med > 0.0 ? (baseline_med / std::max(1e-12, rr.stats.median_ms)) : 1.0);
+    if (rr.status != "ok") rr.speedup_vs_baseline = 0.0;
+  }
+
+  return out;
+}
+
+// Isolated runs fork, which is only safe while no other thread of the
+// process is at work: a concurrent run's threads (its own, TBB workers, the
+// allocator) may hold locks the child would inherit taken, and deadlock it.
+// TBB workers left by finished runs sleep idle. So an isolated run needs the
+// process to itself, and other runs are refused while it is active.
+class RunSlot {
+public:
+  explicit RunSlot(bool isolated) : isolated_(isolated) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (isolated && active_ > 0)
+      throw std::runtime_error("isolated execution cannot overlap other runs in this process (" +
+                               std::to_string(active_) + " active)");
+    if (isolated_active_)
+      throw std::runtime_error("an isolated run is active in this process");
+    ++active_;
+    isolated_active_ = isolated;
   }
+  ~RunSlot() {
+    std::lock_guard<std::mutex> lock(mu_);
+    --active_;
+    if (isolated_) isolated_active_ = false;
+  }
+  RunSlot(const RunSlot &) = delete;
+  RunSlot &operator=(const RunSlot &) = delete;
+
+private:
+  bool isolated_;
+  static inline std::mutex mu_;
+  static inline int active_ = 0;
+  static inline bool isolated_active_ = false;
+};
 
-  // close plugin handles before return
-  for (void* h : plugin_handles) { if (h) dlclose(h); }
+template <class T>
+static RunResult run_for_type_core(const CoreConfig &cfg, detail::SessionState &state,
+                                   Observer *obs) {
+  // CPU placement: validate against the inherited mask, then pin
+  std::vector<int> allowed = sys::current_affinity();
+  for (int c : cfg.cpus) {
+    if (!allowed.empty() &&
+        !std::binary_search(allowed.begin(), allowed.end(), c))
+      throw std::runtime_error("CPU " + std::to_string(c) +
+                               " not in allowed set " +
+                               format_cpu_list(allowed));
+  }
+  const bool isolated = cfg.isolate || cfg.algo_timeout_ms > 0;
+  if (isolated && cfg.schedule != Schedule::sequential)
+    throw std::runtime_error("isolated execution requires the sequential schedule");
+  if (cfg.algo_timeout_ms < 0)
+    throw std::runtime_error("algo_timeout_ms must be >= 0");
+  std::vector<int> cpuset = cfg.cpus.empty() ? allowed : cfg.cpus;
+  std::sort(cpuset.begin(), cpuset.end());
+  const RunSlot slot(isolated);
+
+  // Thread limits, TBB arena and pinning belong to this run only, so
+  // concurrent runs with other threads/cpus settings do not interfere
+  sys::ThreadScope threads(cfg.cpus, cfg.threads);
+  RunResult out;
+  threads.execute([&] { out = run_scoped<T>(cfg, state, obs, cpuset); });
   return out;
 }
 
-RunResult run_benchmark(const CoreConfig &cfg) {
+static RunResult run_in(const CoreConfig &cfg, detail::SessionState &state,
+                        Observer *obs) {
   switch (cfg.type) {
   case ElemType::i32:
-    return run_for_type_core<int>(cfg);
+    return run_for_type_core<int>(cfg, state, obs);
   case ElemType::u32:
-    return run_for_type_core<unsigned int>(cfg);
+    return run_for_type_core<unsigned int>(cfg, state, obs);
   case ElemType::i64:
-    return run_for_type_core<long long>(cfg);
+    return run_for_type_core<long long>(cfg, state, obs);
   case ElemType::u64:
-    return run_for_type_core<unsigned long long>(cfg);
+    return run_for_type_core<unsigned long long>(cfg, state, obs);
   case ElemType::f32:
-    return run_for_type_core<float>(cfg);
+    return run_for_type_core<float>(cfg, state, obs);
   case ElemType::f64:
-    return run_for_type_core<double>(cfg);
+    return run_for_type_core<double>(cfg, state, obs);
   case ElemType::str:
-    return run_for_type_core<std::string>(cfg);
+    return run_for_type_core<std::string>(cfg, state, obs);
   }
   throw std::runtime_error("invalid element type");
 }
 
+RunResult run_benchmark(const CoreConfig &cfg, Observer *obs) {
+  detail::SessionState state;
+  return run_in(cfg, state, obs);
+}
+
+Session::Session(std::uint64_t dataset_max_bytes)
+    : state_(std::make_unique<detail::SessionState>()) {
+  state_->dataset_max_bytes = dataset_max_bytes;
+}
+
+Session::~Session() = default;
+
+RunResult Session::run(const CoreConfig &cfg, Observer *obs) {
+  return run_in(cfg, *state_, obs);
+}
+
+template <class T>
+static std::vector<std::string> names_of(detail::SessionState &state, ElemType t,
+                                         const std::vector<std::string> &plugin_paths,
+                                         const std::vector<std::string> &isolated_paths) {
+  std::vector<std::string> out;
+  for (const auto &a :
+       registry_for<T>(state, t, plugin_paths, isolated_paths, kernels::active_level())->algos)
+    out.push_back(a.name);
+  return out;
+}
+
+std::vector<std::string> Session::list_algorithms(
+    ElemType t, const std::vector<std::string> &plugin_paths,
+    const std::vector<std::string> &isolated_plugin_paths) {
+  switch (t) {
+  case ElemType::i32:
+    return names_of<int>(*state_, t, plugin_paths, isolated_plugin_paths);
+  case ElemType::u32:
+    return names_of<unsigned int>(*state_, t, plugin_paths, isolated_plugin_paths);
+  case ElemType::i64:
+    return names_of<long long>(*state_, t, plugin_paths, isolated_plugin_paths);
+  case ElemType::u64:
+    return names_of<unsigned long long>(*state_, t, plugin_paths, isolated_plugin_paths);
+  case ElemType::f32:
+    return names_of<float>(*state_, t, plugin_paths, isolated_plugin_paths);
+  case ElemType::f64:
+    return names_of<double>(*state_, t, plugin_paths, isolated_plugin_paths);
+  case ElemType::str:
+    return names_of<std::string>(*state_, t, plugin_paths, isolated_plugin_paths);
+  }
+  return {};
+}
+
+void Session::invalidate_datasets() {
+  std::lock_guard<std::mutex> lock(state_->mu);
+  state_->datasets.clear();
+  state_->dataset_bytes = 0;
+}
+
+void Session::invalidate_plugins() {
+  std::lock_guard<std::mutex> lock(state_->mu);
+  state_->registries.clear(); // in-flight runs keep theirs until they finish
+}
+
 std::vector<std::string> list_algorithms(ElemType t) {
   switch (t) {
   case ElemType::i32: {
@@ -1002,69 +1755,59 @@ std::vector<std::string> list_algorithms(ElemType t) {
 }
 
 std::vector<std::string> list_algorithms(
-    ElemType t, const std::vector<std::string>& plugin_paths) {
-  std::vector<std::string> out;
-  std::vector<PluginHandle> handles;
-  switch (t) {
-  case ElemType::i32: {
-    auto regs = build_registry_t<int>();
-    if (!plugin_paths.empty())
-      load_plugins_t<int>(plugin_paths, regs, handles);
-    for (auto &a : regs)
-      out.push_back(a.name);
-    break;
-  }
-  case ElemType::u32: {
-    auto regs = build_registry_t<unsigned int>();
-    if (!plugin_paths.empty())
-      load_plugins_t<unsigned int>(plugin_paths, regs, handles);
-    for (auto &a : regs)
-      out.push_back(a.name);
-    break;
-  }
-  case ElemType::i64: {
-    auto regs = build_registry_t<long long>();
-    if (!plugin_paths.empty())
-      load_plugins_t<long long>(plugin_paths, regs, handles);
-    for (auto &a : regs)
-      out.push_back(a.name);
-    break;
-  }
-  case ElemType::u64: {
-    auto regs = build_registry_t<unsigned long long>();
-    if (!plugin_paths.empty())
-      load_plugins_t<unsigned long long>(plugin_paths, regs, handles);
-    for (auto &a : regs)
-      out.push_back(a.name);
-    break;
-  }
-  case ElemType::f32: {
-    auto regs = build_registry_t<float>();
-    if (!plugin_paths.empty())
-      load_plugins_t<float>(plugin_paths, regs, handles);
-    for (auto &a : regs)
-      out.push_back(a.name);
-    break;
-  }
-  case ElemType::f64: {
-    auto regs = build_registry_t<double>();
-    if (!plugin_paths.empty())
-      load_plugins_t<double>(plugin_paths, regs, handles);
-    for (auto &a : regs)
-      out.push_back(a.name);
-    break;
-  }
-  case ElemType::str: {
-    auto regs = build_registry_t<std::string>();
-    // No plugin support for string
-    for (auto &a : regs)
-      out.push_back(a.name);
-    break;
+    ElemType t, const std::vector<std::string>& plugin_paths,
+    const std::vector<std::string>& isolated_plugin_paths) {
+  Session session(0); // plugins are closed again on return
+  return session.list_algorithms(t, plugin_paths, isolated_plugin_paths);
+}
+
+std::vector<int> parse_cpu_list(std::string_view s) {
+  std::vector<int> out;
+  auto bad = [&]() {
+    return std::runtime_error("Invalid CPU list: '" + std::string(s) + "'");
+  };
+  auto parse_int = [&](std::string_view t) {
+    if (t.empty() || t.size() > 6) throw bad();
+    int v = 0;
+    for (char c : t) {
+      if (c < '0' || c > '9') throw bad();
+      v = v * 10 + (c - '0');
+    }
+    return v;
+  };
+  std::size_t pos = 0;
+  while (pos <= s.size()) {
+    std::size_t comma = s.find(',', pos);
+    std::string_view tok = s.substr(pos, comma == std::string_view::npos
+                                             ? std::string_view::npos
+                                             : comma - pos);
+    std::size_t dash = tok.find('-');
+    if (dash == std::string_view::npos) {
+      out.push_back(parse_int(tok));
+    } else {
+      int lo = parse_int(tok.substr(0, dash));
+      int hi = parse_int(tok.substr(dash + 1));
+      if (hi < lo) throw bad();
+      for (int c = lo; c <= hi; ++c) out.push_back(c);
+    }
+    if (comma == std::string_view::npos) break;
+    pos = comma + 1;
   }
+  std::sort(out.begin(), out.end());
+  out.erase(std::unique(out.begin(), out.end()), out.end());
+  return out;
+}
+
+std::string format_cpu_list(const std::vector<int> &cpus) {
+  std::string out;
+  for (std::size_t i = 0; i < cpus.size();) {
+    std::size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+    if (!out.empty()) out += ',';
+    out += std::to_string(cpus[i]);
+    if (j > i) out += '-' + std::to_string(cpus[j]);
+    i = j + 1;
   }
-  for (void *h : handles)
-    if (h)
-      dlclose(h);
   return out;
 }
 
@@ -1073,4 +1816,167 @@ std::vector<ElemType> supported_types() {
           ElemType::f32, ElemType::f64, ElemType::str};
 }
 
+namespace host {
+
+// The plugin's algorithms for `type`, loaded on first use
+template <class T>
+static Registry<T> &loaded_for(std::map<std::int32_t, std::shared_ptr<void>> &loaded,
+                               std::int32_t type, const std::string &path) {
+  auto &slot = loaded[type];
+  if (!slot) {
+    auto regs = std::make_shared<Registry<T>>();
+    load_plugins_t<T>({path}, regs->algos, regs->handles);
+    slot = regs;
+  }
+  return *std::static_pointer_cast<Registry<T>>(slot);
+}
+
+template <class F> static void with_numeric_type(std::int32_t type, F &&f) {
+  switch (static_cast<ElemType>(type)) {
+  case ElemType::i32: return f(int{});
+  case ElemType::u32: return f(0u);
+  case ElemType::i64: return f(0LL);
+  case ElemType::u64: return f(0ULL);
+  case ElemType::f32: return f(0.0f);
+  case ElemType::f64: return f(0.0);
+  default: throw std::runtime_error("unsupported element type");
+  }
+}
+
+// The core's work memfd, mapped once and kept while requests name it
+class WorkMap {
+public:
+  WorkMap() = default;
+  WorkMap(const WorkMap &) = delete;
+  WorkMap &operator=(const WorkMap &) = delete;
+  ~WorkMap() { sys::unmap_region(region_); }
+  void *map(int fd, std::size_t bytes) {
+    struct stat st {};
+    if (fstat(fd, &st) != 0) throw std::runtime_error("fstat failed on the work buffer");
+    if (static_cast<std::uint64_t>(st.st_size) < bytes)
+      throw std::runtime_error("work buffer smaller than the requested elements");
+    if (!region_.ptr || st.st_dev != dev_ || st.st_ino != ino_ || region_.bytes < bytes) {
+      sys::unmap_region(region_);
+      region_ = sys::map_fd(fd, static_cast<std::size_t>(st.st_size));
+      dev_ = st.st_dev;
+      ino_ = st.st_ino;
+    }
+    return region_.ptr;
+  }
+
+private:
+  sys::Region region_;
+  dev_t dev_ = 0;
+  ino_t ino_ = 0;
+};
+
+// One call bound the way run_scoped binds an in-process plugin; only the
+// call itself is timed
+template <class T>
+static void sort_one(const AlgoT<T> &entry, std::span<T> v, const Request &req,
+                     SortReply &rep) {
+  sys::ThreadScope threads(req.cpus[0] ? parse_cpu_list(req.cpus) : std::vector<int>{},
+                           req.threads);
+  threads.execute([&] {
+    AlgoT<T> algo = entry;
+    PluginMetrics metrics;
+    detail::Buffer<unsigned char> scratch;
+    BindContext bc;
+    bc.plugin.scratch_bytes = algo.scratch_bytes ? algo.scratch_bytes(v.size()) : 0;
+    if (bc.plugin.scratch_bytes) {
+      scratch = detail::Buffer<unsigned char>(bc.plugin.scratch_bytes, BufferMode::prefault);
+      bc.plugin.scratch = scratch.span().data();
+    }
+    bc.plugin.threads = std::max(1, static_cast<int>(req.threads));
+    bc.plugin.sink = metrics.sink();
+    if (algo.bind) algo.bind(algo, bc);
+    if (algo.stage) algo.stage(v);
+    alloc::Scope mem_scope;
+    const auto t0 = Clock::now();
+    algo.run(v);
+    const auto t1 = Clock::now();
+    const alloc::Stats mem = mem_scope.finish();
+    if (algo.unstage) algo.unstage(v);
+    metrics.commit();
+    rep.ms = std::chrono::duration_cast<ms>(t1 - t0).count();
+    rep.peak_extra_bytes = mem.peak_extra_bytes;
+    rep.alloc_count = mem.alloc_count;
+    rep.minor_faults = mem.minor_faults;
+    for (bool phase : {true, false})
+      for (const auto &[name, value] : metrics.medians(phase)) {
+        if (rep.metric_count == kMaxMetrics) break;
+        auto &m = rep.metrics[rep.metric_count++];
+        std::snprintf(m.name, sizeof(m.name), "%s", name.c_str());
+        m.phase = phase;
+        m.value = value;
+      }
+  });
+}
+
+int serve(int sock, const std::string &path) {
+  // A plugin that does not load fails every request with dlopen's reason
+  void *probe = dlopen(path.c_str(), RTLD_NOW);
+  const std::string load_error = probe ? std::string() : std::string(dlerror());
+  std::map<std::int32_t, std::shared_ptr<void>> loaded; // Registry<T> per type
+  WorkMap work;
+  int code = 0;
+  for (;;) {
+    Request req;
+    int fd = -1;
+    const long got = sys::recv_msg(sock, &req, sizeof(req), &fd);
+    if (got <= 0) break; // the core closed its end
+    const std::unique_ptr<int, void (*)(int *)> fd_owner(fd >= 0 ? &fd : nullptr,
+                                                         [](int *p) { close(*p); });
+    if (got != static_cast<long>(sizeof(req)) || req.version != kVersion) {
+      code = 2; // a different core build; it sees the exit code
+      break;
+    }
+    auto answer = [&](auto &rep, auto &&body) {
+      rep.seq = req.seq;
+      try {
+        if (!load_error.empty()) throw std::runtime_error(load_error);
+        body();
+        rep.ok = 1;
+      } catch (const std::exception &e) {
+        std::snprintf(rep.error, sizeof(rep.error), "%s", e.what());
+      }
+      return sys::send_msg(sock, &rep, sizeof(rep));
+    };
+    bool sent = false;
+    if (req.op == Op::list) {
+      ListReply rep;
+      sent = answer(rep, [&] {
+        with_numeric_type(req.type, [&](auto tag) {
+          using T = decltype(tag);
+          for (const auto &a : loaded_for<T>(loaded, req.type, path).algos) {
+            if (rep.count == kMaxAlgos) break;
+            auto &e = rep.algos[rep.count++];
+            std::snprintf(e.name, sizeof(e.name), "%s", a.name.c_str());
+            e.caps = a.caps;
+          }
+        });
+      });
+    } else {
+      SortReply rep;
+      sent = answer(rep, [&] {
+        if (req.op != Op::sort || fd < 0) throw std::runtime_error("malformed request");
+        with_numeric_type(req.type, [&](auto tag) {
+          using T = decltype(tag);
+          const auto &algos = loaded_for<T>(loaded, req.type, path).algos;
+          if (req.algo >= algos.size()) throw std::runtime_error("no such algorithm");
+          const std::size_t n = static_cast<std::size_t>(req.n);
+          std::span<T> v(static_cast<T *>(work.map(fd, n * sizeof(T))), n);
+          sort_one<T>(algos[req.algo], v, req, rep);
+        });
+      });
+    }
+    if (!sent) break;
+  }
+  loaded.clear();
+  if (probe) dlclose(probe);
+  return code;
+}
+
+} // namespace host
+
 } // namespace sortbench
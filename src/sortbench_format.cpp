@@ -1,6 +1,8 @@
 // Pure formatting helpers for RunResult
 #include "sortbench/core.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <sstream>
 #include <string>
@@ -30,23 +32,94 @@ static inline std::string esc_json(const std::string &s) {
   return o;
 }
 
+// Run-level metadata, repeated on each row so rows stay self-describing
+static void write_meta(std::ostringstream &os, const RunResult &r) {
+  if (r.meta.empty()) return;
+  os << ",\"meta\":{";
+  for (std::size_t i = 0; i < r.meta.size(); ++i) {
+    if (i) os << ',';
+    os << '"' << esc_json(r.meta[i].first) << "\":\""
+       << esc_json(r.meta[i].second) << '"';
+  }
+  os << '}';
+}
+
+// Built-ins compiled per instruction-set level: the level that ran
+static void write_isa(std::ostringstream &os, const ResultRow &row) {
+  if (!row.isa.empty())
+    os << ",\"isa\":\"" << esc_json(row.isa) << '"';
+}
+
+// v3 plugin rows only
+static void write_plugin(std::ostringstream &os, const ResultRow &row) {
+  if (row.scratch_bytes)
+    os << ",\"scratch_bytes\":" << row.scratch_bytes;
+  if (!row.caps.empty())
+    os << ",\"caps\":\"" << esc_json(row.caps) << '"';
+  auto object = [&](const char *key, const std::vector<std::pair<std::string, double>> &kv,
+                    bool whole) {
+    if (kv.empty()) return;
+    os << ",\"" << key << "\":{";
+    for (std::size_t i = 0; i < kv.size(); ++i) {
+      os << (i ? "," : "") << '"' << esc_json(kv[i].first) << "\":";
+      // Counters are usually whole numbers: no trailing ".000"
+      if (whole && kv[i].second == std::floor(kv[i].second) && std::abs(kv[i].second) < 1e15)
+        os << static_cast<long long>(kv[i].second);
+      else
+        os << kv[i].second;
+    }
+    os << '}';
+  };
+  object("phases_ms", row.phase_ms, false);
+  object("counters", row.counters, true);
+}
+
+// Isolated runs: rows that timed out or crashed carry no timings
+static void write_status(std::ostringstream &os, const ResultRow &row) {
+  os << ",\"status\":\"" << esc_json(row.status) << '"';
+  if (!row.error.empty())
+    os << ",\"error\":\"" << esc_json(row.error) << '"';
+}
+
+// RFC 4180 quoting, only where the field needs it
+static std::string esc_csv(const std::string &s) {
+  if (s.find_first_of(",\"\r\n") == std::string::npos) return s;
+  std::string o = "\"";
+  for (char c : s) {
+    if (c == '"') o += '"';
+    o += c;
+  }
+  return o + '"';
+}
+
 std::string to_csv(const RunResult &r, bool with_header, bool include_speedup) {
+  // Isolated runs add status/error columns so timed-out or crashed rows stay
+  // visible; other runs only have ok rows and keep the plain schema
+  const bool with_status = std::any_of(r.meta.begin(), r.meta.end(), [](const auto &kv) {
+    return kv.first == "isolated" && kv.second == "yes";
+  });
   std::ostringstream os;
   if (with_header) {
     os << "algo,N,dist,median_ms,mean_ms,min_ms,max_ms,stddev_ms";
     if (include_speedup)
       os << ",speedup_vs_baseline";
+    if (with_status)
+      os << ",status,error";
     os << '\n';
   }
   os.setf(std::ios::fixed);
   os << std::setprecision(3);
   for (const auto &row : r.rows) {
+    if (row.status != "ok" && !with_status)
+      continue;
     os << row.algo << ',' << row.N << ',' << row.dist << ','
        << row.stats.median_ms << ',' << row.stats.mean_ms << ','
        << row.stats.min_ms << ',' << row.stats.max_ms << ','
        << row.stats.stddev_ms;
     if (include_speedup)
       os << ',' << row.speedup_vs_baseline;
+    if (with_status)
+      os << ',' << esc_csv(row.status) << ',' << esc_csv(row.error);
     os << '\n';
   }
   return os.str();
@@ -69,9 +142,17 @@ std::string to_json(const RunResult &r, bool include_speedup, bool pretty) {
     os << "\"mean_ms\":" << row.stats.mean_ms << ",";
     os << "\"min_ms\":" << row.stats.min_ms << ",";
     os << "\"max_ms\":" << row.stats.max_ms << ",";
-    os << "\"stddev_ms\":" << row.stats.stddev_ms;
+    os << "\"stddev_ms\":" << row.stats.stddev_ms << ",";
+    os << "\"reset_ms\":" << row.reset_ms;
     if (include_speedup)
       os << ",\"speedup_vs_baseline\":" << row.speedup_vs_baseline;
+    os << ",\"peak_extra_bytes\":" << row.peak_extra_bytes;
+    os << ",\"alloc_count\":" << row.alloc_count;
+    os << ",\"minor_faults\":" << row.minor_faults;
+    write_isa(os, row);
+    write_plugin(os, row);
+    write_status(os, row);
+    write_meta(os, r);
     os << "}";
     if (i + 1 != r.rows.size())
       os << ",";
@@ -93,9 +174,17 @@ std::string to_jsonl(const RunResult &r, bool include_speedup) {
     os << "\"mean_ms\":" << row.stats.mean_ms << ",";
     os << "\"min_ms\":" << row.stats.min_ms << ",";
     os << "\"max_ms\":" << row.stats.max_ms << ",";
-    os << "\"stddev_ms\":" << row.stats.stddev_ms;
+    os << "\"stddev_ms\":" << row.stats.stddev_ms << ",";
+    os << "\"reset_ms\":" << row.reset_ms;
     if (include_speedup)
       os << ",\"speedup_vs_baseline\":" << row.speedup_vs_baseline;
+    os << ",\"peak_extra_bytes\":" << row.peak_extra_bytes;
+    os << ",\"alloc_count\":" << row.alloc_count;
+    os << ",\"minor_faults\":" << row.minor_faults;
+    write_isa(os, row);
+    write_plugin(os, row);
+    write_status(os, row);
+    write_meta(os, r);
     os << "}" << '\n';
   }
   return os.str();
@@ -0,0 +1,414 @@
+// sortbench core: input data generation (private to the core library)
+// Counter-based: element i of every distribution is a pure function of
+// (seed, i), so chunks fill in parallel and the output is identical at any
+// thread count. Bump kGeneratorVersion (core.hpp) whenever that mapping changes.
+// sortbench_kernels.cpp includes this file again once per instruction-set
+// level with SB_GEN_NS set (see sortbench_algos.hpp); the guard below only
+// covers the default sortbench::gen.
+
+#if defined(SB_GEN_NS) || !defined(SORTBENCH_GEN_HPP)
+#ifndef SB_GEN_NS
+#define SORTBENCH_GEN_HPP
+#define SB_GEN_NS gen
+#endif
+
+#include "sortbench/core.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace sortbench::SB_GEN_NS {
+
+// SplitMix64 output function
+inline std::uint64_t mix64(std::uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// 64-bit hash of an element's bytes (numeric bit pattern or string contents)
+template <class T> std::uint64_t hash_value(const T &x) {
+  if constexpr (std::is_same_v<T, std::string>) {
+    std::uint64_t h = 0xcbf29ce484222325ULL; // FNV-1a, then mixed
+    for (unsigned char c : x) h = (h ^ c) * 0x100000001b3ULL;
+    return mix64(h);
+  } else {
+    static_assert(sizeof(T) <= sizeof(std::uint64_t));
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &x, sizeof(T));
+    return mix64(bits);
+  }
+}
+
+// One random stream: draw(i) is SplitMix64 evaluated at state key + (i+1)*gamma,
+// i.e. the i-th output of a SplitMix64 sequence seeded with `key`.
+class Stream {
+public:
+  Stream(std::uint64_t seed, std::uint64_t id)
+      : key_(id ? mix64(seed ^ (id * 0xD6E8FEB86659FD93ULL)) : seed) {}
+
+  std::uint64_t bits(std::uint64_t i) const {
+    return mix64(key_ + (i + 1) * 0x9E3779B97F4A7C15ULL);
+  }
+  // Uniform in [0, 1) with the full mantissa of F
+  template <class F = double> F unit(std::uint64_t i) const {
+    if constexpr (std::is_same_v<F, float>)
+      return static_cast<float>(bits(i) >> 40) * 0x1.0p-24f;
+    else
+      return static_cast<F>(bits(i) >> 11) * static_cast<F>(0x1.0p-53);
+  }
+  // Uniform in [0, bound) (multiply-shift, no modulo)
+  std::uint64_t below(std::uint64_t i, std::uint64_t bound) const {
+    return static_cast<std::uint64_t>(
+        (static_cast<unsigned __int128>(bits(i)) * bound) >> 64);
+  }
+
+private:
+  std::uint64_t key_;
+};
+
+constexpr std::size_t kParallelMin = std::size_t{1} << 15; // below: stay serial
+constexpr std::size_t kCancelBlock = std::size_t{1} << 14;  // indices per cancel check
+
+// f(i) for every i in [0, n); each index is independent of the others.
+// Runs in parallel once n reaches `min_parallel`. With `cancel`, the range
+// is walked in blocks and the remaining blocks are skipped once it is set.
+template <class F>
+void for_each_index(std::size_t n, F &&f, std::size_t min_parallel = kParallelMin,
+                    const std::atomic<bool> *cancel = nullptr) {
+  if (cancel) {
+    const std::size_t blocks = (n + kCancelBlock - 1) / kCancelBlock;
+    auto block = [&](std::size_t b) {
+      if (cancel->load(std::memory_order_relaxed)) return;
+      const std::size_t end = std::min(n, (b + 1) * kCancelBlock);
+      for (std::size_t i = b * kCancelBlock; i < end; ++i) f(i);
+    };
+#ifdef _OPENMP
+    if (n >= min_parallel && blocks > 1 && omp_get_max_threads() > 1) {
+      const auto m = static_cast<std::ptrdiff_t>(blocks);
+#pragma omp parallel for schedule(static)
+      for (std::ptrdiff_t b = 0; b < m; ++b) block(static_cast<std::size_t>(b));
+      return;
+    }
+#endif
+    for (std::size_t b = 0; b < blocks; ++b) block(b);
+    return;
+  }
+#ifdef _OPENMP
+  if (n >= min_parallel && n > 1 && omp_get_max_threads() > 1) {
+    const auto m = static_cast<std::ptrdiff_t>(n);
+#pragma omp parallel for schedule(static)
+    for (std::ptrdiff_t i = 0; i < m; ++i) f(static_cast<std::size_t>(i));
+    return;
+  }
+#else
+  (void)min_parallel;
+#endif
+  for (std::size_t i = 0; i < n; ++i) f(i);
+}
+
+// Sort [0, n) in fixed-length chunks, chunks in parallel
+template <class T> void sort_chunks(std::vector<T> &v, std::size_t len) {
+  const std::size_t n = v.size();
+  for_each_index(
+      (n + len - 1) / len,
+      [&](std::size_t c) {
+        std::sort(v.begin() + static_cast<std::ptrdiff_t>(c * len),
+                  v.begin() + static_cast<std::ptrdiff_t>(std::min(n, (c + 1) * len)));
+      },
+      kParallelMin / len + 1);
+}
+
+// Walker/Vose alias table: O(1) sampling from K discrete weights
+class AliasTable {
+public:
+  explicit AliasTable(const std::vector<double> &w) : prob_(w.size()), alias_(w.size()) {
+    const std::size_t k = w.size();
+    double sum = 0.0;
+    for (double x : w) sum += x;
+    std::vector<double> p(k);
+    std::vector<std::uint32_t> small, large;
+    for (std::size_t i = 0; i < k; ++i) {
+      p[i] = w[i] * static_cast<double>(k) / sum;
+      (p[i] < 1.0 ? small : large).push_back(static_cast<std::uint32_t>(i));
+    }
+    while (!small.empty() && !large.empty()) {
+      std::uint32_t s = small.back(), l = large.back();
+      small.pop_back();
+      prob_[s] = p[s];
+      alias_[s] = l;
+      p[l] += p[s] - 1.0;
+      if (p[l] < 1.0) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    for (std::uint32_t i : large) prob_[i] = 1.0;
+    for (std::uint32_t i : small) prob_[i] = 1.0; // rounding leftovers
+  }
+  std::size_t size() const { return prob_.size(); }
+  // `column` uniform in [0, size()), `u` uniform in [0, 1)
+  std::size_t sample(std::uint64_t column, double u) const {
+    return u < prob_[column] ? column : alias_[column];
+  }
+
+private:
+  std::vector<double> prob_;
+  std::vector<std::uint32_t> alias_;
+};
+
+// Zipf(s) weights over ranks 1..k
+inline AliasTable zipf_table(int k, double s) {
+  std::vector<double> w(static_cast<std::size_t>(std::max(1, k)));
+  for (std::size_t r = 0; r < w.size(); ++r)
+    w[r] = std::pow(static_cast<double>(r + 1), -s);
+  return AliasTable(w);
+}
+
+// Run boundaries with Pareto(alpha) lengths >= kMinRun, capped at n.
+// Serial, but only O(number of runs).
+constexpr std::size_t kMinRun = 16;
+inline std::vector<std::size_t> heavy_tail_runs(std::size_t n, double alpha,
+                                                std::uint64_t seed) {
+  const Stream s(seed, 4);
+  std::vector<std::size_t> starts;
+  for (std::size_t pos = 0, k = 0; pos < n; ++k) {
+    starts.push_back(pos);
+    const double len = static_cast<double>(kMinRun) * std::pow(1.0 - s.unit(k), -1.0 / alpha);
+    const double left = static_cast<double>(n - pos);
+    pos += len >= left ? n - pos : std::max<std::size_t>(1, static_cast<std::size_t>(len));
+  }
+  starts.push_back(n);
+  return starts;
+}
+
+// Swap `pct`% of n positions pairwise. Serial: later swaps see earlier ones.
+template <class T> void partial_shuffle(std::vector<T> &v, int pct, std::uint64_t seed) {
+  const std::size_t n = v.size();
+  if (n < 2) return;
+  const std::size_t swaps = (n * static_cast<std::size_t>(std::clamp(pct, 0, 100))) / 100;
+  const Stream s(seed, 3);
+  for (std::size_t k = 0; k < swaps; ++k)
+    std::swap(v[s.below(2 * k, n)], v[s.below(2 * k + 1, n)]);
+}
+
+template <class T>
+std::vector<T> make_data(std::size_t n, Dist dist, std::uint64_t seed,
+                         int partial_pct, int dups_k, const CoreConfig &cfg) {
+  std::vector<T> v(n);
+  // Element fills stop early on cancellation; the caller discards the result
+  auto fill = [&](std::size_t count, auto &&f) {
+    for_each_index(count, f, kParallelMin, cfg.cancel);
+  };
+  const Stream s0(seed, 0);
+  if constexpr (std::is_same_v<T, std::string>) {
+    // Random lowercase words of 1..16 chars; sorted/reverse order them
+    const Stream s1(seed, 1), s2(seed, 2);
+    fill(n, [&](std::size_t i) {
+      const auto len = static_cast<std::size_t>(1 + s0.below(i, 16));
+      std::string w(len, 'a');
+      std::uint64_t x = s1.bits(i);
+      for (std::size_t j = 0; j < len; ++j) {
+        if (j == 8) x = s2.bits(i);
+        w[j] = static_cast<char>('a' + x % 26);
+        x /= 26;
+      }
+      v[i] = std::move(w);
+    });
+    if (dist == Dist::reverse) {
+      std::sort(v.begin(), v.end());
+      std::reverse(v.begin(), v.end());
+    } else if (dist == Dist::sorted) {
+      std::sort(v.begin(), v.end());
+    }
+    return v;
+  } else {
+    using U = std::make_unsigned_t<std::conditional_t<std::is_integral_v<T>, T, int>>;
+    auto uniform = [&](std::size_t i) -> T {
+      if constexpr (std::is_integral_v<T>)
+        return static_cast<T>(static_cast<U>(s0.bits(i)));
+      else
+        return s0.unit<T>(i);
+    };
+
+    switch (dist) {
+    case Dist::reverse:
+      fill(n, [&](std::size_t i) { v[i] = static_cast<T>(n - 1 - i); });
+      return v;
+    case Dist::sorted:
+      fill(n, [&](std::size_t i) { v[i] = static_cast<T>(i); });
+      return v;
+    case Dist::dups: {
+      const auto k = static_cast<std::uint64_t>(std::max(1, dups_k));
+      fill(n, [&](std::size_t i) { v[i] = static_cast<T>(s0.below(i, k)); });
+      return v;
+    }
+    case Dist::saw: {
+      const std::size_t period = std::max<std::size_t>(std::min<std::size_t>(n ? n : 1, 1024), 1);
+      fill(n, [&](std::size_t i) { v[i] = static_cast<T>(i % period); });
+      return v;
+    }
+    case Dist::runs: {
+      // Random values arranged into sorted runs of fixed length
+      const std::size_t run_len = std::max<std::size_t>(1, std::min<std::size_t>(n ? n : 1, 2048));
+      fill(n, [&](std::size_t i) { v[i] = uniform(i); });
+      sort_chunks(v, run_len);
+      return v;
+    }
+    case Dist::gauss: {
+      // Box-Muller on two independent streams
+      const Stream s1(seed, 1);
+      auto normal = [&](std::size_t i) {
+        const double u1 = 1.0 - s0.unit(i); // (0, 1]
+        const double u2 = s1.unit(i);
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+      };
+      if constexpr (std::is_integral_v<T>) {
+        using Lim = std::numeric_limits<T>;
+        const double minv = static_cast<double>(Lim::min());
+        // Largest double that still converts to T without overflow
+        const double maxv = std::nextafter(static_cast<double>(Lim::max()), 0.0);
+        const double mean = std::is_signed_v<T> ? 0.0 : (maxv / 2.0);
+        const double stddev = (maxv - (std::is_signed_v<T> ? minv : 0.0)) / 8.0;
+        fill(n, [&](std::size_t i) {
+          v[i] = static_cast<T>(std::clamp(mean + stddev * normal(i), minv, maxv));
+        });
+      } else {
+        fill(n, [&](std::size_t i) { v[i] = static_cast<T>(normal(i)); });
+      }
+      return v;
+    }
+    case Dist::exp: {
+      auto expo = [&](std::size_t i) { return -std::log1p(-s0.unit(i)); };
+      if constexpr (std::is_integral_v<T>) {
+        const double maxv =
+            std::nextafter(static_cast<double>(std::numeric_limits<T>::max()), 0.0);
+        fill(n, [&](std::size_t i) {
+          v[i] = static_cast<T>(std::min((maxv / 8.0) * expo(i), maxv));
+        });
+      } else {
+        fill(n, [&](std::size_t i) { v[i] = static_cast<T>(expo(i)); });
+      }
+      return v;
+    }
+    case Dist::zipf: {
+      // Rank 0 is the most frequent of dup_values values, skew cfg.zipf_s
+      const AliasTable table = zipf_table(dups_k, cfg.zipf_s > 0.0 ? cfg.zipf_s : 1.2);
+      const Stream s1(seed, 1);
+      fill(n, [&](std::size_t i) {
+        v[i] = static_cast<T>(table.sample(s0.below(i, table.size()), s1.unit(i)));
+      });
+      return v;
+    }
+    case Dist::organpipe:
+      // 0, 1, ..., n/2, ..., 1, 0
+      fill(n, [&](std::size_t i) {
+        v[i] = static_cast<T>(i < n / 2 ? i : n - 1 - i);
+      });
+      return v;
+    case Dist::staggered: {
+      // Block b, offset j holds j * blocks + b: each block ascends with a
+      // large stride and consecutive blocks are shifted by one
+      const std::size_t block = static_cast<std::size_t>(std::max(1, cfg.stagger_block));
+      const std::size_t blocks = (n + block - 1) / block;
+      fill(n, [&](std::size_t i) {
+        v[i] = static_cast<T>((i % block) * blocks + i / block);
+      });
+      return v;
+    }
+    case Dist::runs_ht: {
+      // Sorted runs with heavy-tailed (Pareto) lengths
+      const auto starts = heavy_tail_runs(n, cfg.runs_alpha > 0.0 ? cfg.runs_alpha : 1.5, seed);
+      fill(n, [&](std::size_t i) { v[i] = uniform(i); });
+      for_each_index(
+          starts.size() - 1,
+          [&](std::size_t r) {
+            std::sort(v.begin() + static_cast<std::ptrdiff_t>(starts[r]),
+                      v.begin() + static_cast<std::ptrdiff_t>(starts[r + 1]));
+          },
+          kParallelMin / kMinRun);
+      return v;
+    }
+    case Dist::sorted_tail: {
+      // 0..head-1 ascending, then tail_pct% random values from the same range
+      const std::size_t tail = n * static_cast<std::size_t>(std::clamp(cfg.tail_pct, 0, 100)) / 100;
+      const std::size_t head = n - tail;
+      fill(n, [&](std::size_t i) {
+        v[i] = static_cast<T>(i < head ? i : s0.below(i, n));
+      });
+      return v;
+    }
+    case Dist::k_sorted: {
+      // Key i + r, r in [0, k]: every element's sorted rank is within k of i
+      const auto k = static_cast<std::uint64_t>(std::max(0, cfg.displace_k));
+      fill(n, [&](std::size_t i) { v[i] = static_cast<T>(i + s0.below(i, k + 1)); });
+      return v;
+    }
+    case Dist::clustered: {
+      // Gaussian clusters around cfg.clusters uniform centres
+      const auto c = static_cast<std::uint64_t>(std::max(1, cfg.clusters));
+      const Stream s1(seed, 1), s2(seed, 2), centres(seed, 5);
+      double lo = 0.0, hi = 1.0;
+      if constexpr (std::is_integral_v<T>) {
+        lo = static_cast<double>(std::numeric_limits<T>::min());
+        hi = std::nextafter(static_cast<double>(std::numeric_limits<T>::max()), 0.0);
+      }
+      const double sigma = (hi - lo) / (32.0 * static_cast<double>(c));
+      fill(n, [&](std::size_t i) {
+        const std::uint64_t k = s0.below(i, c);
+        const double centre = lo + (hi - lo) * centres.unit(k);
+        const double u1 = 1.0 - s1.unit(i), u2 = s2.unit(i);
+        const double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+        v[i] = static_cast<T>(std::clamp(centre + sigma * z, lo, hi));
+      });
+      return v;
+    }
+    case Dist::block_shuffled: {
+      // 0..n-1 cut into shuffle_block-long sorted blocks, blocks in random order
+      const std::size_t block = static_cast<std::size_t>(std::max(1, cfg.shuffle_block));
+      const std::size_t blocks = (n + block - 1) / block;
+      std::vector<std::size_t> order(blocks), start(blocks + 1, 0);
+      for (std::size_t b = 0; b < blocks; ++b) order[b] = b;
+      for (std::size_t b = blocks; b > 1; --b) // Fisher-Yates, O(blocks)
+        std::swap(order[b - 1], order[s0.below(b, b)]);
+      for (std::size_t k = 0; k < blocks; ++k)
+        start[k + 1] = start[k] + std::min(block, n - order[k] * block);
+      for_each_index(
+          blocks,
+          [&](std::size_t k) {
+            const std::size_t first = order[k] * block;
+            for (std::size_t j = 0; j < start[k + 1] - start[k]; ++j)
+              v[start[k] + j] = static_cast<T>(first + j);
+          },
+          kParallelMin / block + 1);
+      return v;
+    }
+    case Dist::partial:
+      // Sorted input with partial_pct% of positions swapped at random
+      fill(n, [&](std::size_t i) { v[i] = static_cast<T>(i); });
+      partial_shuffle(v, partial_pct, seed);
+      return v;
+    case Dist::random:
+    default:
+      fill(n, [&](std::size_t i) { v[i] = uniform(i); });
+      return v;
+    }
+  }
+}
+
+} // namespace sortbench::SB_GEN_NS
+
+#undef SB_GEN_NS
+#endif
@@ -0,0 +1,69 @@
+// sortbench core: out-of-process plugin host (private)
+// Plugins given as CoreConfig::isolated_plugin_paths are loaded by a
+// sortbench-plugin-host process instead of the benchmark itself, so a crash
+// in one cannot take the caller down. The core talks to it over a
+// SOCK_SEQPACKET socket. Each sort request carries the run's work buffer, a
+// shared memfd, as a descriptor. The host maps it, sorts in place and times
+// only the sort, so neither the IPC nor the mapping enters the measurement.
+// Allocation and page-fault counters are taken around the same call.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace sortbench::host {
+
+inline constexpr std::uint32_t kVersion = 2;
+inline constexpr int kSocketFd = 3; // the host's end of the socket
+inline constexpr std::size_t kMaxAlgos = 64;
+inline constexpr std::size_t kMaxMetrics = 16;
+
+enum class Op : std::uint32_t {
+  list = 1, // algorithms for `type` -> ListReply
+  sort = 2, // sort `n` elements in the attached memfd -> SortReply
+};
+
+struct Request {
+  std::uint32_t version = kVersion;
+  Op op = Op::list;
+  std::uint64_t seq = 0;  // echoed in the reply
+  std::int32_t type = 0;  // ElemType
+  std::uint32_t algo = 0; // index into the list for `type`
+  std::uint64_t n = 0;
+  std::int32_t threads = 0;
+  char cpus[128] = {};    // format_cpu_list ("" = inherit)
+};
+
+struct ListReply {
+  std::uint64_t seq = 0;
+  std::int32_t ok = 0;
+  std::uint32_t count = 0;
+  char error[256] = {};
+  struct Entry {
+    char name[64];
+    std::uint32_t caps; // SORTBENCH_CAP_* bits
+  } algos[kMaxAlgos] = {};
+};
+
+struct SortReply {
+  std::uint64_t seq = 0;
+  std::int32_t ok = 0;
+  double ms = 0.0;                // the sort alone, measured in the host
+  std::uint64_t peak_extra_bytes = 0; // alloc::Stats of the same call
+  std::uint64_t alloc_count = 0;
+  std::uint64_t minor_faults = 0;
+  char error[256] = {};
+  std::uint32_t metric_count = 0; // v3 sink reports of this call
+  struct Metric {
+    char name[48];
+    std::uint8_t phase; // else a counter
+    double value;
+  } metrics[kMaxMetrics] = {};
+};
+
+// Host main loop: serves requests on `sock` for the plugin at `path` until
+// the core closes its end. Returns the process exit code.
+int serve(int sock, const std::string &path);
+
+} // namespace sortbench::host
@@ -0,0 +1,146 @@
+// sortbench core: benchmark input loaded from a file
+
+#include "sortbench_input.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+namespace sortbench::input {
+
+namespace {
+
+constexpr std::size_t kChunk = std::size_t{1} << 20;
+
+std::uint64_t hash_chunk(const unsigned char *p, std::size_t len, std::uint64_t c) {
+  std::uint64_t h = gen::mix64(c ^ (len * 0x9E3779B97F4A7C15ULL));
+  std::size_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    std::uint64_t w;
+    std::memcpy(&w, p + i, 8);
+    h = gen::mix64(h ^ w) + 0x9E3779B97F4A7C15ULL;
+  }
+  if (i < len) {
+    std::uint64_t w = 0;
+    std::memcpy(&w, p + i, len - i);
+    h = gen::mix64(h ^ w) + 0x9E3779B97F4A7C15ULL;
+  }
+  return h;
+}
+
+} // namespace
+
+std::uint64_t content_hash(const void *data, std::size_t bytes) {
+  const auto *p = static_cast<const unsigned char *>(data);
+  const std::size_t chunks = (bytes + kChunk - 1) / kChunk;
+  std::vector<std::uint64_t> part(chunks);
+  gen::for_each_index(
+      chunks,
+      [&](std::size_t c) {
+        part[c] = hash_chunk(p + c * kChunk, std::min(kChunk, bytes - c * kChunk), c);
+      },
+      2);
+  std::uint64_t h = gen::mix64(bytes);
+  for (std::uint64_t v : part) h = gen::mix64(h ^ v);
+  return h;
+}
+
+std::vector<std::string> split_lines(const char *data, std::size_t bytes) {
+  // Chunk starts sit just past a '\n', so every record lies in one chunk
+  std::vector<std::size_t> start{0};
+  while (true) {
+    std::size_t from = std::max(start.size() * kChunk, start.back());
+    if (from >= bytes) break;
+    const void *nl = std::memchr(data + from, '\n', bytes - from);
+    if (!nl) break;
+    std::size_t s = static_cast<std::size_t>(static_cast<const char *>(nl) - data) + 1;
+    if (s >= bytes) break;
+    start.push_back(s);
+  }
+  const std::size_t chunks = start.size();
+  auto end_of = [&](std::size_t c) { return c + 1 < chunks ? start[c + 1] : bytes; };
+  auto for_records = [&](std::size_t c, auto &&f) {
+    std::size_t b = start[c];
+    const std::size_t e = end_of(c);
+    while (b < e) {
+      const void *nl = std::memchr(data + b, '\n', e - b);
+      std::size_t stop = nl ? static_cast<std::size_t>(static_cast<const char *>(nl) - data) : e;
+      std::size_t len = stop - b;
+      if (len && data[b + len - 1] == '\r') --len;
+      f(data + b, len);
+      b = stop + 1;
+    }
+  };
+
+  std::vector<std::size_t> first(chunks + 1, 0);
+  gen::for_each_index(
+      chunks,
+      [&](std::size_t c) {
+        std::size_t k = 0;
+        for_records(c, [&](const char *, std::size_t) { ++k; });
+        first[c + 1] = k;
+      },
+      2);
+  for (std::size_t c = 0; c < chunks; ++c) first[c + 1] += first[c];
+
+  std::vector<std::string> lines(first[chunks]);
+  gen::for_each_index(
+      chunks,
+      [&](std::size_t c) {
+        std::size_t k = first[c];
+        for_records(c, [&](const char *p, std::size_t len) { lines[k++].assign(p, len); });
+      },
+      2);
+  return lines;
+}
+
+std::vector<std::size_t> sample_indices(std::size_t count, std::size_t k,
+                                        std::uint64_t seed) {
+  // Selection sampling (Knuth's Algorithm S): one pass, order preserved
+  std::vector<std::size_t> out;
+  out.reserve(k);
+  const gen::Stream s(seed, 5);
+  for (std::size_t i = 0; i < count && out.size() < k; ++i)
+    if (s.below(i, count - i) < k - out.size())
+      out.push_back(i);
+  return out;
+}
+
+sys::Region map_input(const std::string &path, Meta &meta) {
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec)
+    throw std::runtime_error("input " + path + ": " + ec.message());
+  if (size == 0)
+    throw std::runtime_error("input " + path + " is empty");
+  sys::Region r = sys::map_file(path, 0, static_cast<std::size_t>(size), /*populate=*/true);
+  char hex[17];
+  std::snprintf(hex, sizeof(hex), "%016llx",
+                static_cast<unsigned long long>(content_hash(r.ptr, r.bytes)));
+  meta.emplace_back("input", path);
+  meta.emplace_back("input_hash", hex);
+  return r;
+}
+
+std::pair<std::size_t, std::size_t> window(const CoreConfig &cfg, std::size_t count,
+                                           Meta &meta) {
+  if (cfg.input_offset > count)
+    throw std::runtime_error("input_offset " + std::to_string(cfg.input_offset) +
+                             " exceeds the " + std::to_string(count) +
+                             " records in the input");
+  const std::size_t avail = count - cfg.input_offset;
+  const std::size_t n = cfg.N ? cfg.N : avail;
+  if (n > avail)
+    throw std::runtime_error("input has " + std::to_string(avail) +
+                             " records after the offset, N=" + std::to_string(n) +
+                             " requested");
+  meta.emplace_back("input_records", std::to_string(count));
+  if (cfg.input_offset)
+    meta.emplace_back("input_offset", std::to_string(cfg.input_offset));
+  if (cfg.input_sample && n < avail)
+    meta.emplace_back("input_sampled", "yes");
+  return {cfg.input_offset, n};
+}
+
+} // namespace sortbench::input
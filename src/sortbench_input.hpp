@@ -0,0 +1,101 @@
+// sortbench core: benchmark input loaded from a file (private)
+// Numeric types read raw little-endian arrays (mapped, zero-copy when the
+// whole window is used as-is); `str` reads newline-delimited text parsed in
+// parallel. The file's content hash goes into the run metadata.
+
+#pragma once
+
+#include "sortbench/core.hpp"
+#include "sortbench_buffer.hpp"
+#include "sortbench_gen.hpp"
+#include "sortbench_sys.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sortbench::input {
+
+using Meta = std::vector<std::pair<std::string, std::string>>;
+
+// "sbh64": 1MB chunks hashed in parallel, then combined in file order, so
+// the value does not depend on the thread count
+std::uint64_t content_hash(const void *data, std::size_t bytes);
+
+// Records of newline-delimited text ("\r\n" accepted); a trailing newline
+// does not add an empty record
+std::vector<std::string> split_lines(const char *data, std::size_t bytes);
+
+// k distinct indices of [0, count), ascending, chosen by `seed`
+std::vector<std::size_t> sample_indices(std::size_t count, std::size_t k,
+                                        std::uint64_t seed);
+
+// Map `path` whole (MAP_PRIVATE | MAP_POPULATE) and record path/hash;
+// throws on a missing or empty file
+sys::Region map_input(const std::string &path, Meta &meta);
+
+// [first, first + n) of `count` records per input_offset / N (0 = all);
+// records the window in `meta`, throws when the file is too short
+std::pair<std::size_t, std::size_t> window(const CoreConfig &cfg, std::size_t count,
+                                           Meta &meta);
+
+template <class T>
+detail::Buffer<T> load(const CoreConfig &cfg, std::uint64_t seed, Meta &meta) {
+  sys::Region file = map_input(cfg.input_path, meta);
+  const auto *bytes = static_cast<const char *>(file.ptr);
+  const std::size_t size = file.bytes;
+
+  if constexpr (std::is_same_v<T, std::string>) {
+    std::vector<std::string> lines = split_lines(bytes, size);
+    sys::unmap_region(file);
+    const auto [first, n] = window(cfg, lines.size(), meta);
+    std::vector<std::string> v;
+    v.reserve(n);
+    if (cfg.input_sample) {
+      for (std::size_t i : sample_indices(lines.size() - first, n, seed))
+        v.push_back(std::move(lines[first + i]));
+    } else {
+      for (std::size_t i = 0; i < n; ++i) v.push_back(std::move(lines[first + i]));
+    }
+    return detail::Buffer<T>(std::move(v), cfg.buffers);
+  } else {
+    if constexpr (std::endian::native != std::endian::little)
+      throw std::runtime_error("binary --input requires a little-endian host");
+    if (size % sizeof(T) != 0) {
+      sys::unmap_region(file);
+      throw std::runtime_error("input size " + std::to_string(size) +
+                               " is not a multiple of the element size " +
+                               std::to_string(sizeof(T)));
+    }
+    const std::size_t count = size / sizeof(T);
+    std::pair<std::size_t, std::size_t> w;
+    try {
+      w = window(cfg, count, meta);
+    } catch (...) {
+      sys::unmap_region(file);
+      throw;
+    }
+    const auto [first, n] = w;
+    const T *src = reinterpret_cast<const T *>(bytes) + first;
+    if (cfg.input_sample) {
+      const auto idx = sample_indices(count - first, n, seed);
+      std::vector<T> v(n);
+      gen::for_each_index(n, [&](std::size_t j) { v[j] = src[idx[j]]; });
+      sys::unmap_region(file);
+      return detail::Buffer<T>(std::move(v), cfg.buffers);
+    }
+    if (cfg.buffers == BufferMode::standard)
+      return detail::Buffer<T>(std::move(file), n, first * sizeof(T)); // zero-copy
+    detail::Buffer<T> placed(n, cfg.buffers);
+    std::copy(src, src + n, placed.span().begin());
+    sys::unmap_region(file);
+    return placed;
+  }
+}
+
+} // namespace sortbench::input
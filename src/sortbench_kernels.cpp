@@ -0,0 +1,81 @@
+// sortbench core: built-in kernels per instruction-set level
+// Where the levels are compiled (SB_KERNELS_X86: x86-64 with GCC) the
+// Makefile strips -march from this file, so the TU default (and every
+// standard library template it instantiates) stays at the baseline. The
+// levels are raised with `#pragma GCC target` around our own code only;
+// -ffp-contract=off keeps generated floats identical at every level.
+// Elsewhere the single level keeps the build's own flags.
+
+#include "sortbench_kernels.hpp"
+// The defaults first: they pull in the standard headers outside any target
+// region, so only our own code below is compiled per level
+#include "sortbench_algos.hpp"
+#include "sortbench_gen.hpp"
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define SB_KERNELS_X86 1
+#else
+#define SB_KERNELS_X86 0
+#endif
+
+#if SB_KERNELS_X86
+#pragma GCC push_options
+#pragma GCC target("arch=x86-64")
+#endif
+#define SB_KERNEL_LEVEL baseline
+#include "sortbench_kernels_level.hpp"
+#if SB_KERNELS_X86
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("arch=x86-64-v3")
+#define SB_KERNEL_LEVEL avx2
+#include "sortbench_kernels_level.hpp"
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("arch=x86-64-v4")
+#define SB_KERNEL_LEVEL avx512
+#include "sortbench_kernels_level.hpp"
+#pragma GCC pop_options
+#endif
+
+namespace sortbench::kernels {
+
+IsaLevel active_level() {
+  IsaLevel level = host_isa_level();
+  if (const char *cap = std::getenv("SORTBENCH_ISA"); cap && *cap) {
+    const auto l = parse_isa_level(cap);
+    if (!l)
+      throw std::runtime_error(std::string("invalid SORTBENCH_ISA (baseline|avx2|avx512): ") + cap);
+    if (*l < level) level = *l;
+  }
+  return level;
+}
+
+template <class T> const Set<T> &get(IsaLevel level) {
+  static const Set<T> base = baseline::make_set<T>(IsaLevel::baseline);
+#if SB_KERNELS_X86
+  static const Set<T> v3 = avx2::make_set<T>(IsaLevel::avx2);
+  static const Set<T> v4 = avx512::make_set<T>(IsaLevel::avx512);
+  if (level == IsaLevel::avx512) return v4;
+  if (level == IsaLevel::avx2) return v3;
+#else
+  (void)level;
+#endif
+  return base;
+}
+
+template const Set<int> &get<int>(IsaLevel);
+template const Set<unsigned> &get<unsigned>(IsaLevel);
+template const Set<long long> &get<long long>(IsaLevel);
+template const Set<unsigned long long> &get<unsigned long long>(IsaLevel);
+template const Set<float> &get<float>(IsaLevel);
+template const Set<double> &get<double>(IsaLevel);
+
+} // namespace sortbench::kernels
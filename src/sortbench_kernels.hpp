@@ -0,0 +1,39 @@
+// sortbench core: built-in kernels per instruction-set level (private)
+// sortbench_kernels.cpp compiles the built-in sorts (sortbench_algos.hpp)
+// and the generator (sortbench_gen.hpp) once per IsaLevel, so a library
+// built without -march still runs AVX2/AVX-512 code where the CPU has it.
+// Each run picks one level: the highest the CPU supports, capped by
+// $SORTBENCH_ISA (baseline|avx2|avx512).
+
+#pragma once
+
+#include "sortbench/core.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace sortbench::kernels {
+
+template <class T> struct Sort {
+  const char *name;
+  void (*run)(std::span<T>);
+};
+
+template <class T> struct Set {
+  IsaLevel isa = IsaLevel::baseline; // the level these were compiled for
+  std::vector<Sort<T>> sorts;        // in registry order
+  std::vector<T> (*make_data)(std::size_t n, Dist dist, std::uint64_t seed, int partial_pct,
+                              int dups_k, const CoreConfig &cfg) = nullptr;
+};
+
+// Level for a run: host_isa_level() capped by $SORTBENCH_ISA. Throws
+// std::runtime_error on an unknown $SORTBENCH_ISA value.
+IsaLevel active_level();
+
+// Kernels for numeric T at `level`, or at the highest compiled level below
+// it (only baseline exists off x86-64 or without GCC target pragmas)
+template <class T> const Set<T> &get(IsaLevel level);
+
+} // namespace sortbench::kernels
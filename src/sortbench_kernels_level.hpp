@@ -0,0 +1,39 @@
+// sortbench core: one instruction-set level of the built-in kernels (private)
+// Included by sortbench_kernels.cpp once per level, with SB_KERNEL_LEVEL
+// naming it and the matching `#pragma GCC target` in effect. Everything
+// defined here, template instantiations included, is compiled for that
+// target and lives in sortbench::kernels::<level>, so no code is shared
+// between levels. No include guard for that reason.
+
+#define SB_ALGOS_NS kernels::SB_KERNEL_LEVEL::algos
+#include "sortbench_algos.hpp"
+#define SB_GEN_NS kernels::SB_KERNEL_LEVEL::gen
+#include "sortbench_gen.hpp"
+
+namespace sortbench::kernels::SB_KERNEL_LEVEL {
+
+// Same names and order as the built-ins in build_registry_t
+template <class T> Set<T> make_set(IsaLevel isa) {
+  Set<T> s;
+  s.isa = isa;
+  s.sorts = {
+      {"heap_sort", &algos::heap_sort<T>},
+      {"merge_sort_opt", &algos::merge_sort_opt<T>},
+      {"insertion_sort", &algos::insertion_sort_full<T>},
+      {"selection_sort", &algos::selection_sort<T>},
+      {"bubble_sort", &algos::bubble_sort<T>},
+      {"comb_sort", &algos::comb_sort<T>},
+      {"shell_sort", &algos::shell_sort<T>},
+      {"timsort", &algos::timsort<T>},
+      {"quicksort_hybrid", &algos::quicksort_hybrid<T>},
+      {"quicksort_3way", &algos::quicksort_3way<T>},
+  };
+  if constexpr (std::is_integral_v<T>)
+    s.sorts.push_back({"radix_sort_lsd", &algos::radix_sort_lsd<T>});
+  s.make_data = &gen::make_data<T>;
+  return s;
+}
+
+} // namespace sortbench::kernels::SB_KERNEL_LEVEL
+
+#undef SB_KERNEL_LEVEL
@@ -0,0 +1,103 @@
+// sortbench core: restoring the work buffer before each run (private)
+// `copy` writes the input over the work buffer with std::copy. `parallel`
+// splits it across the OpenMP workers with non-temporal stores, each worker
+// rewriting the pages it faulted in under first_touch placement. `snapshot`
+// maps a fresh pre-faulted copy-on-write view of the sealed input's memfd
+// over the work buffer, so the kernel does the copy.
+// Every mode runs outside the timed region and its cost is reported on its own.
+
+#pragma once
+
+#include "sortbench/core.hpp"
+#include "sortbench_buffer.hpp"
+#include "sortbench_sys.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <span>
+#include <stdexcept>
+
+namespace sortbench::reset {
+
+template <class T> class Engine {
+public:
+  // `work` is replaced by a snapshot view when that mode is chosen, unless it
+  // is `shared` with another process (a plugin host) and must stay in place.
+  // Snapshot views map `input`'s own memfd (see Buffer::sealed), which must
+  // outlive the engine; an unsealed input leaves only the copying modes.
+  Engine(const detail::Buffer<T> &input, detail::Buffer<T> &work, ResetMode mode,
+         Placement placement, bool shared = false)
+      : original_(input.span()), work_(work) {
+    if constexpr (detail::Buffer<T>::kMappable) {
+      const std::size_t bytes = original_.size() * sizeof(T);
+      if (mode == ResetMode::snapshot) {
+        if (shared)
+          throw std::runtime_error("snapshot reset cannot be used with isolated plugins");
+        // A view's pages are faulted in by the calling thread alone
+        if (placement != Placement::local)
+          throw std::runtime_error("snapshot reset requires local placement");
+        if (!input.snapshot()) throw std::runtime_error("snapshot reset requires a sealed input");
+        adopt(input.snapshot());
+      } else if (mode == ResetMode::parallel) {
+        mode_ = ResetMode::parallel;
+      } else if (mode == ResetMode::automatic && bytes >= kResetAutoMinBytes) {
+        // No fixed crossover: copy bandwidth and page allocation costs vary
+        // too much by kernel and machine, so time one of each and keep the
+        // cheapest
+        (void)(*this)(); // settle the work pages
+        double best = (*this)();
+        mode_ = ResetMode::parallel;
+        if (const double t = (*this)(); t < best)
+          best = t;
+        else
+          mode_ = ResetMode::copy;
+        if (const sys::Snapshot *snap = input.snapshot();
+            snap && placement == Placement::local && !shared) {
+          try {
+            sys::Region view = snap->map();
+            const auto t0 = std::chrono::steady_clock::now();
+            snap->remap(view);
+            const std::chrono::duration<double, std::milli> remap_ms =
+                std::chrono::steady_clock::now() - t0;
+            sys::unmap_region(view);
+            if (remap_ms.count() < best) adopt(snap);
+          } catch (const std::exception &) {
+            // mapping failed: keep the copy
+          }
+        }
+      }
+    }
+  }
+
+  // Restore the work buffer to the input; returns the time taken in ms
+  double operator()() {
+    const auto t0 = std::chrono::steady_clock::now();
+    if (mode_ == ResetMode::snapshot)
+      snap_->remap(view_);
+    else if (mode_ == ResetMode::parallel)
+      sys::stream_copy(work_.span().data(), original_.data(), original_.size() * sizeof(T));
+    else
+      std::copy(original_.begin(), original_.end(), work_.span().begin());
+    const std::chrono::duration<double, std::milli> d = std::chrono::steady_clock::now() - t0;
+    return d.count();
+  }
+
+  ResetMode mode() const { return mode_; }
+
+private:
+  void adopt(const sys::Snapshot *snap) {
+    view_ = snap->map();
+    snap_ = snap;
+    work_ = detail::Buffer<T>(view_, original_.size());
+    mode_ = ResetMode::snapshot;
+  }
+
+  std::span<const T> original_;
+  detail::Buffer<T> &work_;
+  ResetMode mode_ = ResetMode::copy;
+  const sys::Snapshot *snap_ = nullptr; // owned by the input
+  sys::Region view_; // owned by work_
+};
+
+} // namespace sortbench::reset
@@ -0,0 +1,820 @@
+// sortbench core: OS-level helpers (affinity, governor, clock spin-up, mmap)
+
+#include "sortbench_sys.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char **environ;
+#define SB_SYS_LINUX 1
+#else
+#define SB_SYS_LINUX 0
+#endif
+
+#if defined(__has_include)
+#if __has_include(<tbb/task_scheduler_observer.h>) && __has_include(<tbb/task_arena.h>)
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+#define SB_SYS_HAS_TBB 1
+#else
+#define SB_SYS_HAS_TBB 0
+#endif
+#else
+#define SB_SYS_HAS_TBB 0
+#endif
+
+namespace sortbench::sys {
+
+std::vector<int> current_affinity() {
+  std::vector<int> out;
+#if SB_SYS_LINUX
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) return out;
+  for (int c = 0; c < CPU_SETSIZE; ++c)
+    if (CPU_ISSET(c, &set)) out.push_back(c);
+#endif
+  return out;
+}
+
+bool set_thread_affinity(const std::vector<int> &cpus) {
+#if SB_SYS_LINUX
+  if (cpus.empty()) return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int c : cpus)
+    if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  (void)cpus;
+  return false;
+#endif
+}
+
+std::string cpu_governor(const std::vector<int> &cpus) {
+  std::string result;
+  for (int c : cpus) {
+    std::ifstream f("/sys/devices/system/cpu/cpu" + std::to_string(c) +
+                    "/cpufreq/scaling_governor");
+    std::string g;
+    if (!f || !std::getline(f, g) || g.empty()) return "unknown";
+    if (result.empty()) result = g;
+    else if (result != g) return "mixed";
+  }
+  return result.empty() ? "unknown" : result;
+}
+
+// Fixed dependent-chain workload; its duration tracks the core clock.
+static double spin_sample_ms() {
+  auto t0 = std::chrono::steady_clock::now();
+  std::uint64_t x = 0x9E3779B97F4A7C15ULL;
+  for (int i = 0; i < 1'000'000; ++i) {
+    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    x ^= x >> 29;
+  }
+  volatile std::uint64_t sink = x;
+  (void)sink;
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+static bool spin_until_stable(std::chrono::steady_clock::time_point deadline) {
+  constexpr int kWindow = 5;        // consecutive samples that must agree
+  constexpr double kTolerance = 0.02;
+  std::vector<double> win;
+  while (std::chrono::steady_clock::now() < deadline) {
+    win.push_back(spin_sample_ms());
+    if (win.size() > kWindow) win.erase(win.begin());
+    if (win.size() == kWindow) {
+      auto mm = std::minmax_element(win.begin(), win.end());
+      if (*mm.first > 0.0 && (*mm.second / *mm.first - 1.0) <= kTolerance)
+        return true;
+    }
+  }
+  return false;
+}
+
+SpinUpResult spin_up(int threads, double max_ms) {
+  SpinUpResult r;
+  auto t0 = std::chrono::steady_clock::now();
+  auto deadline = t0 + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                           std::chrono::duration<double, std::milli>(max_ms));
+  bool stable = true;
+#ifdef _OPENMP
+  int nt = threads > 0 ? threads : omp_get_max_threads();
+#pragma omp parallel num_threads(nt) reduction(&& : stable)
+  stable = spin_until_stable(deadline);
+#else
+  (void)threads;
+  stable = spin_until_stable(deadline);
+#endif
+  r.stable = stable;
+  r.elapsed_ms = std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - t0).count();
+  return r;
+}
+
+#if SB_SYS_LINUX
+static constexpr std::size_t kHugePage = std::size_t{2} << 20;
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+static constexpr int kMpolInterleave = 3; // MPOL_INTERLEAVE (linux/mempolicy.h)
+static constexpr int kMpolLocal = 4;      // MPOL_LOCAL
+
+static void bind_local(void *p, std::size_t len) {
+#ifdef SYS_mbind
+  // Best effort: without libnuma, fall back to first-touch on failure
+  (void)syscall(SYS_mbind, p, len, kMpolLocal, nullptr, 0UL, 0U);
+#else
+  (void)p;
+  (void)len;
+#endif
+}
+
+static void bind_interleave(void *p, std::size_t len) {
+#ifdef SYS_mbind
+  std::vector<int> nodes;
+  std::ifstream in("/sys/devices/system/node/online");
+  std::string list;
+  try {
+    if (in >> list) nodes = parse_cpu_list(list); // same "0-1,3" syntax
+  } catch (const std::exception &) {
+  }
+  if (nodes.size() < 2) return; // nothing to spread over
+  constexpr std::size_t kBits = 8 * sizeof(unsigned long);
+  std::vector<unsigned long> mask(static_cast<std::size_t>(nodes.back()) / kBits + 1, 0UL);
+  for (int n : nodes)
+    mask[static_cast<std::size_t>(n) / kBits] |= 1UL << (static_cast<std::size_t>(n) % kBits);
+  (void)syscall(SYS_mbind, p, len, kMpolInterleave, mask.data(),
+                static_cast<unsigned long>(mask.size() * kBits + 1), 0U);
+#else
+  (void)p;
+  (void)len;
+#endif
+}
+#endif
+
+// Run f(begin, end) on each OpenMP worker for its contiguous, page-aligned
+// share of [0, len); the static split matches the pinned worker order
+template <class F> static void for_each_share(std::size_t len, F &&f) {
+  constexpr std::size_t kPage = 4096;
+#ifdef _OPENMP
+  if (len >= 64 * kPage && omp_get_max_threads() > 1) {
+#pragma omp parallel
+    {
+      const auto t = static_cast<std::size_t>(omp_get_thread_num());
+      const auto nt = static_cast<std::size_t>(omp_get_num_threads());
+      const std::size_t b = t == 0 ? 0 : len / nt * t / kPage * kPage;
+      const std::size_t e = t + 1 == nt ? len : len / nt * (t + 1) / kPage * kPage;
+      if (b < e) f(b, e);
+    }
+    return;
+  }
+#endif
+  f(std::size_t{0}, len);
+}
+
+#if SB_SYS_LINUX
+static void populate(void *p, std::size_t len) {
+  if (madvise(p, len, MADV_POPULATE_WRITE) == 0) return;
+  const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  auto *c = static_cast<volatile char *>(p);
+  for (std::size_t off = 0; off < len; off += page) c[off] = 0;
+}
+#endif
+
+Region map_region(std::size_t bytes, bool huge, bool prefault, Placement placement) {
+  Region r;
+#if SB_SYS_LINUX
+  if (bytes == 0) bytes = 1;
+  const int prot = PROT_READ | PROT_WRITE;
+  const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  if (huge) {
+    std::size_t len = (bytes + kHugePage - 1) & ~(kHugePage - 1);
+#ifdef MAP_HUGETLB
+    void *p = mmap(nullptr, len, prot, flags | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+      r.ptr = p;
+      r.bytes = len;
+      r.backing = "hugetlb";
+    }
+#endif
+    if (!r.ptr) {
+      // Over-map and trim so the region starts on a 2MB boundary for THP
+      std::size_t span = len + kHugePage;
+      void *raw = mmap(nullptr, span, prot, flags, -1, 0);
+      if (raw == MAP_FAILED)
+        throw std::runtime_error(std::string("mmap failed: ") + std::strerror(errno));
+      auto base = reinterpret_cast<std::uintptr_t>(raw);
+      auto aligned = (base + kHugePage - 1) & ~(std::uintptr_t)(kHugePage - 1);
+      if (aligned > base) munmap(raw, aligned - base);
+      std::size_t tail = (base + span) - (aligned + len);
+      if (tail) munmap(reinterpret_cast<void *>(aligned + len), tail);
+      r.ptr = reinterpret_cast<void *>(aligned);
+      r.bytes = len;
+      r.backing = madvise(r.ptr, len, MADV_HUGEPAGE) == 0 ? "thp" : "4k";
+    }
+  } else {
+    void *p = mmap(nullptr, bytes, prot, flags, -1, 0);
+    if (p == MAP_FAILED)
+      throw std::runtime_error(std::string("mmap failed: ") + std::strerror(errno));
+    r.ptr = p;
+    r.bytes = bytes;
+    r.backing = "4k";
+  }
+  if (placement == Placement::first_touch) {
+    // Default policy: each page lands on the node of the worker writing it
+    const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto *c = static_cast<volatile char *>(r.ptr);
+    for_each_share(r.bytes, [&](std::size_t b, std::size_t e) {
+      for (std::size_t off = b; off < e; off += page) c[off] = 0;
+    });
+    return r;
+  }
+  if (placement == Placement::interleave)
+    bind_interleave(r.ptr, r.bytes);
+  else
+    bind_local(r.ptr, r.bytes);
+  if (prefault) populate(r.ptr, r.bytes);
+#else
+  (void)bytes;
+  (void)huge;
+  (void)prefault;
+  (void)placement;
+  throw std::runtime_error("page-backed buffers require Linux");
+#endif
+  return r;
+}
+
+void unmap_region(Region &r) {
+#if SB_SYS_LINUX
+  if (r.ptr) munmap(r.ptr, r.bytes);
+#endif
+  r = Region{};
+}
+
+#if SB_SYS_LINUX
+// memfd of max(bytes, 1) bytes holding [src, src + bytes), sealed read-only
+static int sealed_memfd(const void *src, std::size_t bytes) {
+  const std::size_t len = bytes ? bytes : 1;
+  int fd = memfd_create("sortbench-input", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (fd < 0)
+    throw std::runtime_error(std::string("memfd_create failed: ") + std::strerror(errno));
+  auto fail = [&](const char *what) {
+    int e = errno;
+    close(fd);
+    throw std::runtime_error(std::string(what) + " failed: " + std::strerror(e));
+  };
+  if (ftruncate(fd, static_cast<off_t>(len)) != 0) fail("ftruncate");
+  void *w = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (w == MAP_FAILED) fail("mmap");
+  if (bytes) std::memcpy(w, src, bytes);
+  munmap(w, len); // F_SEAL_WRITE requires no writable shared mapping
+  if (fcntl(fd, F_ADD_SEALS, F_SEAL_WRITE | F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0)
+    fail("memfd seal");
+  return fd;
+}
+
+// Break copy-on-write on every page of a private view without changing it
+static void populate_private(void *p, std::size_t len) {
+  if (madvise(p, len, MADV_POPULATE_WRITE) == 0) return;
+  const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  auto *c = static_cast<volatile char *>(p);
+  for (std::size_t off = 0; off < len; off += page) c[off] = c[off];
+}
+#endif
+
+Snapshot::Snapshot(const void *src, std::size_t bytes) : bytes_(bytes ? bytes : 1) {
+#if SB_SYS_LINUX
+  fd_ = sealed_memfd(src, bytes);
+#else
+  (void)src;
+  throw std::runtime_error("sealed inputs (isolation, snapshot reset) require Linux");
+#endif
+}
+
+Region Snapshot::read_only() const {
+  Region r;
+#if SB_SYS_LINUX
+  void *p = mmap(nullptr, bytes_, PROT_READ, MAP_SHARED | MAP_POPULATE, fd_, 0);
+  if (p == MAP_FAILED)
+    throw std::runtime_error(std::string("mmap failed: ") + std::strerror(errno));
+  r.ptr = p;
+  r.bytes = bytes_;
+  r.backing = "memfd";
+#endif
+  return r;
+}
+
+Snapshot::~Snapshot() {
+#if SB_SYS_LINUX
+  if (fd_ >= 0) close(fd_);
+#endif
+}
+
+Region Snapshot::map() const {
+  Region r;
+#if SB_SYS_LINUX
+  void *p = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd_, 0);
+  if (p == MAP_FAILED)
+    throw std::runtime_error(std::string("mmap failed: ") + std::strerror(errno));
+  populate_private(p, bytes_);
+  r.ptr = p;
+  r.bytes = bytes_;
+  r.backing = "snapshot";
+#endif
+  return r;
+}
+
+void Snapshot::remap(const Region &view) const {
+#if SB_SYS_LINUX
+  // MAP_FIXED replaces the old pages atomically, so the address stays valid
+  void *p = mmap(view.ptr, bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd_, 0);
+  if (p == MAP_FAILED)
+    throw std::runtime_error(std::string("mmap failed: ") + std::strerror(errno));
+  populate_private(p, bytes_);
+#else
+  (void)view;
+#endif
+}
+
+Region map_file(const std::string &path, std::size_t offset, std::size_t bytes,
+                bool populate) {
+  Region r;
+#if SB_SYS_LINUX
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    throw std::runtime_error("open " + path + ": " + std::strerror(errno));
+  const std::size_t len = bytes ? bytes : 1;
+  void *p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | (populate ? MAP_POPULATE : 0), fd,
+                 static_cast<off_t>(offset));
+  int e = errno;
+  close(fd); // the mapping keeps the file alive
+  if (p == MAP_FAILED)
+    throw std::runtime_error("mmap " + path + ": " + std::strerror(e));
+  r.ptr = p;
+  r.bytes = len;
+  r.backing = "file";
+#else
+  (void)path;
+  (void)offset;
+  (void)bytes;
+  (void)populate;
+  throw std::runtime_error("file mapping requires Linux");
+#endif
+  return r;
+}
+
+// Single-threaded non-temporal copy: the destination bypasses the cache, so
+// no read-for-ownership of the old contents and no eviction of the input
+static void stream_copy_range(char *d, const char *s, std::size_t n) {
+#if defined(__SSE2__)
+  const std::size_t head =
+      std::min(n, (16 - reinterpret_cast<std::uintptr_t>(d) % 16) % 16);
+  std::memcpy(d, s, head);
+  d += head;
+  s += head;
+  n -= head;
+  for (; n >= 64; n -= 64, d += 64, s += 64) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 16));
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 32));
+    const __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 48));
+    _mm_stream_si128(reinterpret_cast<__m128i *>(d), a);
+    _mm_stream_si128(reinterpret_cast<__m128i *>(d + 16), b);
+    _mm_stream_si128(reinterpret_cast<__m128i *>(d + 32), c);
+    _mm_stream_si128(reinterpret_cast<__m128i *>(d + 48), e);
+  }
+  std::memcpy(d, s, n);
+  _mm_sfence();
+#else
+  std::memcpy(d, s, n);
+#endif
+}
+
+void stream_copy(void *dst, const void *src, std::size_t bytes) {
+  auto *d = static_cast<char *>(dst);
+  const auto *s = static_cast<const char *>(src);
+  for_each_share(bytes, [&](std::size_t b, std::size_t e) {
+    stream_copy_range(d + b, s + b, e - b);
+  });
+}
+
+Region map_shared(std::size_t bytes) {
+  Region r;
+#if SB_SYS_LINUX
+  const std::size_t len = bytes ? bytes : 1;
+  void *p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED)
+    throw std::runtime_error(std::string("mmap failed: ") + std::strerror(errno));
+  r.ptr = p;
+  r.bytes = len;
+  r.backing = "shared";
+#else
+  (void)bytes;
+  throw std::runtime_error("isolated execution requires Linux");
+#endif
+  return r;
+}
+
+Region map_memfd(std::size_t bytes, int *fd_out) {
+  Region r;
+#if SB_SYS_LINUX
+  const std::size_t len = bytes ? bytes : 1;
+  int fd = memfd_create("sortbench-work", MFD_CLOEXEC);
+  if (fd < 0)
+    throw std::runtime_error(std::string("memfd_create failed: ") + std::strerror(errno));
+  if (ftruncate(fd, static_cast<off_t>(len)) != 0) {
+    int e = errno;
+    close(fd);
+    throw std::runtime_error(std::string("ftruncate failed: ") + std::strerror(e));
+  }
+  r = map_fd(fd, len);
+  *fd_out = fd;
+#else
+  (void)bytes;
+  (void)fd_out;
+  throw std::runtime_error("plugin hosts require Linux");
+#endif
+  return r;
+}
+
+Region map_fd(int fd, std::size_t bytes) {
+  Region r;
+#if SB_SYS_LINUX
+  const std::size_t len = bytes ? bytes : 1;
+  void *p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+  if (p == MAP_FAILED)
+    throw std::runtime_error(std::string("mmap failed: ") + std::strerror(errno));
+  r.ptr = p;
+  r.bytes = len;
+  r.backing = "memfd";
+#else
+  (void)fd;
+  (void)bytes;
+  throw std::runtime_error("plugin hosts require Linux");
+#endif
+  return r;
+}
+
+Spawned spawn_connected(const std::string &exe, const std::vector<std::string> &args) {
+  Spawned p;
+#if SB_SYS_LINUX
+  int sv[2];
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) != 0)
+    throw std::runtime_error(std::string("socketpair failed: ") + std::strerror(errno));
+  std::vector<char *> argv;
+  argv.push_back(const_cast<char *>(exe.c_str()));
+  for (const auto &a : args) argv.push_back(const_cast<char *>(a.c_str()));
+  argv.push_back(nullptr);
+  // posix_spawn rather than fork: safe from multi-threaded hosts (Go, TBB)
+  posix_spawn_file_actions_t fa;
+  posix_spawn_file_actions_init(&fa);
+  posix_spawn_file_actions_adddup2(&fa, sv[1], 3); // clears close-on-exec
+  pid_t pid = -1;
+  const int rc = exe.find('/') == std::string::npos
+                     ? posix_spawnp(&pid, exe.c_str(), &fa, nullptr, argv.data(), environ)
+                     : posix_spawn(&pid, exe.c_str(), &fa, nullptr, argv.data(), environ);
+  posix_spawn_file_actions_destroy(&fa);
+  close(sv[1]);
+  if (rc != 0) {
+    close(sv[0]);
+    throw std::runtime_error("cannot start '" + exe + "': " + std::strerror(rc));
+  }
+  p.pid = pid;
+  p.sock = sv[0];
+#else
+  (void)exe;
+  (void)args;
+  throw std::runtime_error("plugin hosts require Linux");
+#endif
+  return p;
+}
+
+std::string reap(Spawned &p, int grace_ms) {
+  std::string how;
+#if SB_SYS_LINUX
+  if (p.sock >= 0) close(p.sock); // the host exits on EOF
+  if (p.pid > 0) {
+    int status = 0;
+    pid_t got = 0;
+    for (int waited = 0; (got = waitpid(p.pid, &status, WNOHANG)) == 0 && waited < grace_ms;
+         waited += 5)
+      usleep(5000);
+    if (got == 0) {
+      kill(p.pid, SIGKILL);
+      while ((got = waitpid(p.pid, &status, 0)) < 0 && errno == EINTR) {
+      }
+    }
+    if (got > 0)
+      how = WIFSIGNALED(status) ? std::string(strsignal(WTERMSIG(status)))
+                                : "exit code " + std::to_string(WEXITSTATUS(status));
+  }
+#else
+  (void)grace_ms;
+#endif
+  p = Spawned{};
+  return how;
+}
+
+std::string self_exe_dir() {
+#if SB_SYS_LINUX
+  char buf[4096];
+  const ssize_t n = readlink("/proc/self/exe", buf, sizeof(buf) - 1);
+  if (n <= 0) return {};
+  std::string path(buf, static_cast<std::size_t>(n));
+  const auto slash = path.rfind('/');
+  return slash == std::string::npos ? std::string() : path.substr(0, slash);
+#else
+  return {};
+#endif
+}
+
+bool send_msg(int sock, const void *buf, std::size_t len, int fd) {
+#if SB_SYS_LINUX
+  struct iovec iov {const_cast<void *>(buf), len};
+  struct msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  alignas(struct cmsghdr) char ctl[CMSG_SPACE(sizeof(int))];
+  if (fd >= 0) {
+    msg.msg_control = ctl;
+    msg.msg_controllen = sizeof(ctl);
+    struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(c), &fd, sizeof(int));
+  }
+  ssize_t n;
+  while ((n = sendmsg(sock, &msg, MSG_NOSIGNAL)) < 0 && errno == EINTR) {
+  }
+  return n == static_cast<ssize_t>(len);
+#else
+  (void)sock;
+  (void)buf;
+  (void)len;
+  (void)fd;
+  return false;
+#endif
+}
+
+long recv_msg(int sock, void *buf, std::size_t cap, int *fd_out) {
+  if (fd_out) *fd_out = -1;
+#if SB_SYS_LINUX
+  struct iovec iov {buf, cap};
+  struct msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  alignas(struct cmsghdr) char ctl[CMSG_SPACE(sizeof(int))];
+  msg.msg_control = ctl;
+  msg.msg_controllen = sizeof(ctl);
+  ssize_t n;
+  while ((n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC)) < 0 && errno == EINTR) {
+  }
+  for (struct cmsghdr *c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c))
+    if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS) {
+      int fd;
+      std::memcpy(&fd, CMSG_DATA(c), sizeof(int));
+      if (fd_out) *fd_out = fd;
+      else close(fd);
+    }
+  return static_cast<long>(n);
+#else
+  (void)sock;
+  (void)buf;
+  (void)cap;
+  return -1;
+#endif
+}
+
+ChildResult run_in_child(const std::function<int()> &body, int timeout_ms,
+                         const std::atomic<bool> *cancel) {
+  ChildResult res;
+#if SB_SYS_LINUX
+#ifdef _OPENMP
+  omp_pause_resource_all(omp_pause_hard); // worker threads do not survive fork
+#endif
+  std::fflush(nullptr); // don't let the child inherit half-written stdio buffers
+  int pfd[2];
+  if (pipe2(pfd, O_CLOEXEC) != 0)
+    throw std::runtime_error(std::string("pipe failed: ") + std::strerror(errno));
+  pid_t pid = fork();
+  if (pid < 0) {
+    int e = errno;
+    close(pfd[0]);
+    close(pfd[1]);
+    throw std::runtime_error(std::string("fork failed: ") + std::strerror(e));
+  }
+  if (pid == 0) {
+    close(pfd[0]);
+    int rc = 125;
+    try {
+      rc = body();
+    } catch (...) {
+    }
+    _exit(rc); // skip atexit handlers and stdio flushing inherited from the parent
+  }
+  close(pfd[1]);
+
+  // The read end reports EOF once the child exits, however it exits
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  constexpr int kCancelPollMs = 50;
+  bool timed_out = false, canceled = false;
+  for (;;) {
+    int wait_ms = -1;
+    if (timeout_ms > 0) {
+      auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline - std::chrono::steady_clock::now()).count();
+      if (left <= 0) {
+        timed_out = true;
+        break;
+      }
+      wait_ms = static_cast<int>(left);
+    }
+    if (cancel) {
+      if (cancel->load(std::memory_order_relaxed)) {
+        canceled = true;
+        break;
+      }
+      wait_ms = wait_ms < 0 ? kCancelPollMs : std::min(wait_ms, kCancelPollMs);
+    }
+    struct pollfd p {pfd[0], POLLIN, 0};
+    int n = poll(&p, 1, wait_ms);
+    if (n < 0 && errno == EINTR) continue;
+    if (n != 0) break; // EOF/HUP (or poll error: fall through to waitpid)
+  }
+  close(pfd[0]);
+  if (timed_out || canceled) kill(pid, SIGKILL);
+  int status = 0;
+  while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+  }
+  if (timed_out) {
+    res.kind = ChildResult::Kind::timed_out;
+    res.detail = "exceeded " + std::to_string(timeout_ms) + " ms";
+  } else if (canceled) {
+    res.kind = ChildResult::Kind::canceled;
+    res.detail = "canceled";
+  } else if (WIFSIGNALED(status)) {
+    res.kind = ChildResult::Kind::signaled;
+    res.code = WTERMSIG(status);
+    res.detail = strsignal(res.code);
+  } else {
+    res.kind = ChildResult::Kind::exited;
+    res.code = WIFEXITED(status) ? WEXITSTATUS(status) : 0;
+    res.detail = "exit code " + std::to_string(res.code);
+  }
+#else
+  (void)body;
+  (void)timeout_ms;
+  (void)cancel;
+  throw std::runtime_error("isolated execution requires Linux");
+#endif
+  return res;
+}
+
+#if SB_SYS_HAS_TBB
+// Pins the workers of one arena as they join it and restores them on leave.
+class TbbPinObserver : public tbb::task_scheduler_observer {
+public:
+  TbbPinObserver(tbb::task_arena &arena, std::vector<int> cpus, std::vector<int> restore)
+      : tbb::task_scheduler_observer(arena), cpus_(std::move(cpus)),
+        restore_(std::move(restore)) {
+    observe(true);
+  }
+  ~TbbPinObserver() override { observe(false); }
+  void on_scheduler_entry(bool) override {
+    int idx = tbb::this_task_arena::current_thread_index();
+    if (idx < 0) idx = 0;
+    set_thread_affinity({cpus_[static_cast<std::size_t>(idx) % cpus_.size()]});
+  }
+  void on_scheduler_exit(bool) override {
+    if (!restore_.empty()) set_thread_affinity(restore_);
+  }
+
+private:
+  std::vector<int> cpus_;
+  std::vector<int> restore_;
+};
+#endif
+
+struct PinScope::Impl {
+  std::vector<int> cpus;
+  std::vector<int> saved;
+  int threads = 0;
+
+  void pin_omp_workers(bool restore) {
+#ifdef _OPENMP
+    int nt = threads > 0 ? threads : omp_get_max_threads();
+#pragma omp parallel num_threads(nt)
+    {
+      if (restore) {
+        set_thread_affinity(saved);
+      } else {
+        auto t = static_cast<std::size_t>(omp_get_thread_num());
+        set_thread_affinity({cpus[t % cpus.size()]});
+      }
+    }
+#else
+    (void)restore;
+#endif
+  }
+};
+
+PinScope::PinScope(const std::vector<int> &cpus, int threads) {
+  if (cpus.empty()) return;
+  impl_ = std::make_unique<Impl>();
+  impl_->cpus = cpus;
+  impl_->saved = current_affinity();
+  impl_->threads = threads;
+  impl_->pin_omp_workers(false);
+  set_thread_affinity({cpus.front()});
+}
+
+PinScope::~PinScope() {
+  if (!impl_) return;
+  if (!impl_->saved.empty()) {
+    impl_->pin_omp_workers(true);
+    set_thread_affinity(impl_->saved);
+  }
+}
+
+struct ThreadScope::Impl {
+  int saved_omp_threads = 0;
+#if SB_SYS_HAS_TBB
+  std::unique_ptr<tbb::task_arena> arena;
+  std::unique_ptr<TbbPinObserver> tbb_obs;
+#endif
+  std::optional<PinScope> pin;
+};
+
+ThreadScope::ThreadScope(const std::vector<int> &cpus, int threads)
+    : impl_(std::make_unique<Impl>()) {
+#ifdef _OPENMP
+  impl_->saved_omp_threads = omp_get_max_threads();
+  if (threads > 0) omp_set_num_threads(threads);
+#endif
+#if SB_SYS_HAS_TBB
+  // More slots than the machine's default concurrency only draws a warning
+  const int tbb_max = tbb::this_task_arena::max_concurrency();
+  impl_->arena = std::make_unique<tbb::task_arena>(threads > 0 ? std::min(threads, tbb_max)
+                                                               : tbb_max);
+#endif
+  if (cpus.empty()) return;
+  const std::vector<int> saved = current_affinity();
+  impl_->pin.emplace(cpus, threads);
+#if SB_SYS_HAS_TBB
+  impl_->tbb_obs = std::make_unique<TbbPinObserver>(*impl_->arena, cpus, saved);
+#endif
+}
+
+ThreadScope::~ThreadScope() {
+#if SB_SYS_HAS_TBB
+  impl_->tbb_obs.reset();
+  impl_->arena.reset();
+#endif
+  impl_->pin.reset();
+#ifdef _OPENMP
+  omp_set_num_threads(impl_->saved_omp_threads);
+#endif
+}
+
+void ThreadScope::execute(const std::function<void()> &f) {
+#if SB_SYS_HAS_TBB
+  impl_->arena->execute(f);
+#else
+  f();
+#endif
+}
+
+} // namespace sortbench::sys
@@ -0,0 +1,161 @@
+// sortbench core: OS-level helpers (private to the core library)
+// CPU affinity, frequency governor, clock spin-up and page-backed buffers
+// used to make timings less noisy. Linux-specific pieces degrade to no-ops elsewhere.
+
+#pragma once
+
+#include "sortbench/core.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sortbench::sys {
+
+// CPUs the calling thread may currently run on (empty if unknown)
+std::vector<int> current_affinity();
+
+// Restrict the calling thread to `cpus`; returns false if the OS refused
+bool set_thread_affinity(const std::vector<int> &cpus);
+
+// scaling_governor of the given CPUs ("performance", "mixed", "unknown", ...)
+std::string cpu_governor(const std::vector<int> &cpus);
+
+// Busy-loop on every pinned worker until a fixed workload's duration is stable
+// (consecutive samples within tolerance) or `max_ms` elapses.
+struct SpinUpResult {
+  double elapsed_ms = 0.0;
+  bool stable = false;
+};
+SpinUpResult spin_up(int threads, double max_ms = 2000.0);
+
+// Anonymous page-backed memory for large benchmark buffers. Always at least
+// page (so 64-byte) aligned; NUMA placement follows `placement`.
+struct Region {
+  void *ptr = nullptr;
+  std::size_t bytes = 0;  // mapped length
+  std::string backing;    // "hugetlb", "thp" or "4k"
+};
+// huge: try MAP_HUGETLB, else 2MB-aligned THP (MADV_HUGEPAGE).
+// prefault: populate every page up front so the sort never takes a fault
+// (first_touch placement always populates, from the OpenMP workers).
+// Throws std::runtime_error when the mapping fails.
+Region map_region(std::size_t bytes, bool huge, bool prefault,
+                  Placement placement = Placement::local);
+void unmap_region(Region &r);
+
+// Sealed memfd holding a copy of [src, src + bytes). read_only() maps it
+// shared and read-only (backing "memfd"): forked children share those pages
+// without copying and cannot modify them. map() makes a private
+// (copy-on-write) writable view, pre-faulted so the copy happens in the
+// kernel up front; remap() discards a view's writes by mapping a fresh one
+// over it at the same address. Throws std::runtime_error on failure.
+class Snapshot {
+public:
+  Snapshot(const void *src, std::size_t bytes);
+  ~Snapshot();
+  Snapshot(const Snapshot &) = delete;
+  Snapshot &operator=(const Snapshot &) = delete;
+
+  Region read_only() const; // backing "memfd"
+  Region map() const;       // backing "snapshot"
+  void remap(const Region &view) const;
+
+private:
+  int fd_ = -1;
+  std::size_t bytes_ = 0;
+};
+
+// Private (copy-on-write) mapping of [offset, offset + bytes) of a file,
+// backing "file". `offset` must be page aligned; populate pre-faults it.
+Region map_file(const std::string &path, std::size_t offset, std::size_t bytes,
+                bool populate);
+
+// Copy with non-temporal stores where available, split across the OpenMP
+// workers in the same per-thread shares first_touch placement faults in, so
+// each worker rewrites its own pages.
+void stream_copy(void *dst, const void *src, std::size_t bytes);
+
+// Zeroed MAP_SHARED memory; writes made by a forked child are visible here
+Region map_shared(std::size_t bytes);
+
+// Zeroed, pre-faulted MAP_SHARED memfd (backing "memfd") that can be handed
+// to another process: *fd_out receives its descriptor (close-on-exec), owned
+// by the caller. The mapping stays valid after the descriptor is closed.
+Region map_memfd(std::size_t bytes, int *fd_out);
+// Maps `bytes` of a received memfd read-write and pre-faulted (plugin host)
+Region map_fd(int fd, std::size_t bytes);
+
+// A helper process started with posix_spawn and connected through a
+// SOCK_SEQPACKET socket it sees as descriptor 3 (the plugin host)
+struct Spawned {
+  int pid = -1;
+  int sock = -1;
+};
+// Throws std::runtime_error when the process cannot be started
+Spawned spawn_connected(const std::string &exe, const std::vector<std::string> &args);
+// Closes the socket and waits up to grace_ms for an exit, then SIGKILLs.
+// Returns a description of how it ended ("exit code 0", "Segmentation fault").
+std::string reap(Spawned &p, int grace_ms);
+// Directory of the running executable ("" if unknown)
+std::string self_exe_dir();
+// One datagram, optionally carrying a descriptor (SCM_RIGHTS). Never raises
+// SIGPIPE; returns false when the peer is gone.
+bool send_msg(int sock, const void *buf, std::size_t len, int fd = -1);
+// Returns the datagram length, 0 when the peer closed, -1 on error. A
+// received descriptor lands in *fd_out (else -1).
+long recv_msg(int sock, void *buf, std::size_t cap, int *fd_out = nullptr);
+
+struct ChildResult {
+  enum class Kind { exited, signaled, timed_out, canceled } kind = Kind::exited;
+  int code = 0;       // exit status or signal number
+  std::string detail; // human-readable form ("exit code 3", "Segmentation fault", ...)
+};
+// Fork, run `body` in the child and _exit with its return value (an escaping
+// exception exits with 125). The parent waits up to `timeout_ms` (0 = no
+// limit) and SIGKILLs the child on expiry, or once `cancel` is set. The
+// OpenMP thread pool is released before forking so the child can start a
+// fresh one. No other thread may be at work meanwhile (the core's isolated
+// runs have the process to themselves), or the child can inherit its locks.
+ChildResult run_in_child(const std::function<int()> &body, int timeout_ms,
+                         const std::atomic<bool> *cancel = nullptr);
+
+// RAII pinning: pins the calling thread to cpus[0] and the workers of its
+// OpenMP pool (worker t to cpus[t % n]). Restores the previous masks on
+// destruction. Empty `cpus` leaves everything untouched.
+class PinScope {
+public:
+  PinScope(const std::vector<int> &cpus, int threads);
+  ~PinScope();
+  PinScope(const PinScope &) = delete;
+  PinScope &operator=(const PinScope &) = delete;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+// Thread limits and pinning for one run, without process-wide state, so
+// concurrent runs on different threads keep their own settings. The OpenMP
+// thread count is set for the calling thread only and restored on
+// destruction. TBB work started inside execute() runs in a task_arena of
+// `threads` slots (0 = default) owned by the scope. With `cpus`, PinScope
+// applies and the arena's workers are pinned by slot as they join.
+class ThreadScope {
+public:
+  ThreadScope(const std::vector<int> &cpus, int threads);
+  ~ThreadScope();
+  ThreadScope(const ThreadScope &) = delete;
+  ThreadScope &operator=(const ThreadScope &) = delete;
+  // Runs f on the calling thread inside the run's arena
+  void execute(const std::function<void()> &f);
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace sortbench::sys
@@ -0,0 +1,68 @@
+// sortbench core: reference-free verification (private)
+// A sorted output is correct iff it is ordered and holds the same multiset
+// as the input. Both checks are parallel scans; the multiset is compared by
+// an order-independent fingerprint (two sums of per-element hashes mod 2^64),
+// so no sorted reference copy is needed.
+
+#pragma once
+
+#include "sortbench_gen.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace sortbench::verify {
+
+struct Fingerprint {
+  std::uint64_t a = 0, b = 0;
+  bool operator==(const Fingerprint &) const = default;
+};
+
+inline std::size_t chunks_for(std::size_t n) {
+  return std::clamp<std::size_t>(n / 65536, 1, 256);
+}
+
+template <class T> Fingerprint fingerprint(std::span<const T> v) {
+  const std::size_t n = v.size(), chunks = chunks_for(n);
+  std::vector<Fingerprint> part(chunks);
+  gen::for_each_index(
+      chunks,
+      [&](std::size_t c) {
+        Fingerprint f;
+        for (std::size_t i = n * c / chunks, e = n * (c + 1) / chunks; i < e; ++i) {
+          const std::uint64_t h = gen::hash_value(v[i]);
+          f.a += h;
+          f.b += gen::mix64(h ^ 0xA0761D6478BD642FULL);
+        }
+        part[c] = f;
+      },
+      2);
+  Fingerprint all;
+  for (const auto &f : part) {
+    all.a += f.a;
+    all.b += f.b;
+  }
+  return all;
+}
+
+template <class T> bool sorted(std::span<const T> v) {
+  const std::size_t n = v.size(), chunks = chunks_for(n);
+  std::vector<char> ok(chunks, 1);
+  gen::for_each_index(
+      chunks,
+      [&](std::size_t c) {
+        const std::size_t b = std::max<std::size_t>(n * c / chunks, 1);
+        for (std::size_t i = b, e = n * (c + 1) / chunks; i < e; ++i)
+          if (v[i] < v[i - 1]) {
+            ok[c] = 0;
+            return;
+          }
+      },
+      2);
+  return std::all_of(ok.begin(), ok.end(), [](char x) { return x != 0; });
+}
+
+} // namespace sortbench::verify
@@ -1,13 +1,31 @@
 // Minimal core tests for sortbench
 #include "sortbench/core.hpp"
+#include "../src/sortbench_adversary.hpp" // private: killer-input oracle
+#include "../src/sortbench_analyze.hpp" // private: input profile
+#include "../src/sortbench_gen.hpp" // private: generator determinism
+#include "../src/sortbench_input.hpp" // private: line splitting, sampling
+#include "../src/sortbench_verify.hpp" // private: fingerprint verification
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <numeric>
 #include <string>
+#include <thread>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace sortbench;
 
 static void require(bool cond, const char* msg) {
@@ -64,6 +82,7 @@ static void test_to_json_csv() {
   auto res = run_benchmark(cfg);
   auto csv = to_csv(res, true, false);
   require(csv.find("algo,N,dist,median_ms") != std::string::npos, "csv header present");
+  require(csv.find("status") == std::string::npos, "plain csv has no status columns");
   auto js = to_json(res, false, true);
   require(js.find("\"algo\"") != std::string::npos, "json has fields");
   auto jl = to_jsonl(res, false);
@@ -140,6 +159,910 @@ int main() {
       auto r2 = run_benchmark(cfg);
       require(!r2.rows.empty(), "partial dist rows");
     }
+    // CPU list parsing + pinned run records cpuset/governor metadata
+    {
+      auto cpus = parse_cpu_list("3,0-2,2");
+      require(cpus == std::vector<int>({0, 1, 2, 3}), "parse_cpu_list ranges");
+      require(format_cpu_list({0, 1, 2, 5, 7, 8}) == "0-2,5,7-8", "format_cpu_list");
+      bool threw = false;
+      try { parse_cpu_list("4-1"); } catch (const std::exception&) { threw = true; }
+      require(threw, "parse_cpu_list rejects reversed range");
+
+      CoreConfig cfg;
+      cfg.N = 256;
+      cfg.repeats = 1;
+      cfg.algos = {"std_sort"};
+      auto base = run_benchmark(cfg);
+      std::string first;
+      for (const auto& kv : base.meta) if (kv.first == "cpuset") first = kv.second;
+      require(!first.empty(), "cpuset meta present");
+      cfg.cpus = {parse_cpu_list(first.substr(0, first.find_first_of(",-"))).front()};
+      auto res = run_benchmark(cfg);
+      bool pinned = false, gov = false;
+      for (const auto& kv : res.meta) {
+        if (kv.first == "pinned") pinned = (kv.second == "yes");
+        if (kv.first == "governor") gov = !kv.second.empty();
+      }
+      require(pinned && gov, "pinned run records meta");
+      require(to_jsonl(res).find("\"meta\":{") != std::string::npos, "jsonl has meta");
+    }
+    // Interleaved schedules keep registry row order and per-algo stats
+    {
+      require(parse_schedule("rr") == Schedule::round_robin, "parse_schedule alias");
+      require(!parse_schedule("bogus").has_value(), "parse_schedule rejects");
+      for (Schedule sc : {Schedule::round_robin, Schedule::shuffled}) {
+        CoreConfig cfg;
+        cfg.N = 2000;
+        cfg.repeats = 3;
+        cfg.warmup = 1;
+        cfg.assert_sorted = true;
+        cfg.algos = {"std_sort", "heap_sort", "timsort"};
+        cfg.schedule = sc;
+        auto res = run_benchmark(cfg);
+        require(res.rows.size() == 3, "interleaved rows");
+        require(res.rows[0].algo == "std_sort" && res.rows[1].algo == "heap_sort",
+                "interleaved keeps registry order");
+        for (const auto& row : res.rows)
+          require(row.stats.min_ms <= row.stats.median_ms &&
+                      row.stats.median_ms <= row.stats.max_ms,
+                  "interleaved stats ordered");
+      }
+    }
+    // Memory accounting: merge_sort_opt allocates an N-sized tmp, heap_sort none
+    {
+      CoreConfig cfg;
+      cfg.N = 1 << 16;
+      cfg.repeats = 2;
+      cfg.algos = {"heap_sort", "merge_sort_opt"};
+      auto res = run_benchmark(cfg);
+      require(res.rows.size() == 2, "memory rows");
+      for (const auto& row : res.rows) {
+        if (row.algo == "heap_sort")
+          require(row.alloc_count == 0 && row.peak_extra_bytes == 0, "heap_sort allocates nothing");
+        if (row.algo == "merge_sort_opt")
+          require(row.alloc_count >= 1 && row.peak_extra_bytes >= cfg.N * sizeof(int),
+                  "merge_sort_opt peak >= N ints");
+      }
+      require(to_json(res).find("\"peak_extra_bytes\":") != std::string::npos, "json has memory fields");
+    }
+    // Page-backed buffers: huge/prefault sort correctly; strings stay on the heap
+    {
+      require(parse_buffer_mode("default") == BufferMode::standard, "parse_buffer_mode default");
+      require(!parse_buffer_mode("tmpfs").has_value(), "parse_buffer_mode rejects");
+      auto meta_of = [](const RunResult& r, const std::string& k) {
+        for (const auto& kv : r.meta) if (kv.first == k) return kv.second;
+        return std::string();
+      };
+      for (BufferMode bm : {BufferMode::huge, BufferMode::prefault}) {
+        CoreConfig cfg;
+        cfg.N = 50000;
+        cfg.type = ElemType::f64;
+        cfg.repeats = 2;
+        cfg.verify = true;
+        cfg.assert_sorted = true;
+        cfg.algos = {"std_sort", "merge_sort_opt"};
+        cfg.buffers = bm;
+        auto res = run_benchmark(cfg);
+        require(res.rows.size() == 2, "buffer mode rows");
+        require(meta_of(res, "buffers") == std::string(buffer_mode_name(bm)), "buffers meta");
+        auto backing = meta_of(res, "buffer_backing");
+        require(backing == "4k" || backing == "thp" || backing == "hugetlb", "mapped backing");
+      }
+      CoreConfig cfg;
+      cfg.N = 256;
+      cfg.type = ElemType::str;
+      cfg.repeats = 1;
+      cfg.algos = {"std_sort"};
+      cfg.buffers = BufferMode::huge;
+      require(meta_of(run_benchmark(cfg), "buffer_backing") == "heap", "strings stay on heap");
+    }
+    // Session: registries and generated inputs are reused across runs
+    {
+      auto meta_of = [](const RunResult& r, const std::string& k) {
+        for (const auto& kv : r.meta) if (kv.first == k) return kv.second;
+        return std::string();
+      };
+      Session session;
+      require(session.list_algorithms(ElemType::i32) == list_algorithms(ElemType::i32),
+              "session lists the built-ins");
+      CoreConfig cfg;
+      cfg.N = 20000;
+      cfg.dist = Dist::zipf;
+      cfg.repeats = 1;
+      cfg.verify = true;
+      cfg.algos = {"std_sort"};
+      auto first = session.run(cfg);
+      require(meta_of(first, "session_dataset") == "miss", "session first run generates");
+      auto again = session.run(cfg);
+      require(meta_of(again, "session_dataset") == "hit", "session reuses the input");
+      require(meta_of(again, "generator") == meta_of(first, "generator"), "hit keeps input meta");
+      cfg.seed = 7;
+      require(meta_of(session.run(cfg), "session_dataset") == "miss", "new seed is a new input");
+      session.invalidate_datasets();
+      session.invalidate_plugins();
+      require(meta_of(session.run(cfg), "session_dataset") == "miss", "invalidate drops inputs");
+      cfg.isolate = true; // the kept input is replaced by its sealed memfd
+      auto iso = session.run(cfg);
+      require(iso.rows.size() == 1 && iso.rows[0].status == "ok", "isolated run from session input");
+      require(meta_of(session.run(cfg), "session_dataset") == "hit", "sealing keeps the input");
+      cfg.isolate = false; // snapshot views map the same sealed input
+      cfg.reset = ResetMode::snapshot;
+      auto snap = session.run(cfg);
+      require(meta_of(snap, "session_dataset") == "hit" && snap.rows[0].status == "ok",
+              "snapshot reset from the sealed session input");
+      cfg.reset = ResetMode::automatic;
+      require(session.run(cfg).rows[0].status == "ok", "sealed input serves copy resets");
+      Session tiny(1024); // over budget: used for the run, never kept
+      cfg.isolate = false;
+      tiny.run(cfg);
+      require(meta_of(tiny.run(cfg), "session_dataset") == "miss", "session budget");
+      require(meta_of(run_benchmark(cfg), "session_dataset").empty(), "plain runs keep nothing");
+    }
+    // Observer: progress hooks in order, one on_row per result row
+    {
+      struct Recorder : Observer {
+        std::vector<std::string> events;
+        std::vector<ResultRow> rows;
+        int repeats = 0;
+        void on_start(const std::vector<std::string>& names) override {
+          events.push_back("start:" + std::to_string(names.size()));
+        }
+        void on_input(const RunResult& r, double ms) override {
+          require(r.rows.empty() && r.N == 3000 && ms >= 0.0, "on_input carries the header");
+          events.push_back("input");
+        }
+        void on_repeat(const std::string&, int, double ms) override {
+          require(ms >= 0.0, "repeat time");
+          ++repeats;
+        }
+        void on_row(const ResultRow& row) override { rows.push_back(row); }
+      };
+      CoreConfig cfg;
+      cfg.N = 3000;
+      cfg.repeats = 3;
+      cfg.algos = {"std_sort", "heap_sort"};
+      cfg.baseline = std::string("std_sort");
+      for (Schedule s : {Schedule::sequential, Schedule::round_robin}) {
+        cfg.schedule = s;
+        Recorder rec;
+        auto res = run_benchmark(cfg, &rec);
+        require((rec.events == std::vector<std::string>{"start:2", "input"}), "start before input");
+        require(rec.repeats == 6, "one on_repeat per timed run");
+        require(rec.rows.size() == res.rows.size(), "one on_row per row");
+        for (std::size_t i = 0; i < res.rows.size(); ++i)
+          require(rec.rows[i].algo == res.rows[i].algo &&
+                      rec.rows[i].stats.median_ms == res.rows[i].stats.median_ms,
+                  "streamed rows match the result");
+      }
+      cfg.schedule = Schedule::sequential;
+      cfg.isolate = true;
+      Recorder rec;
+      Session session;
+      auto res = session.run(cfg, &rec);
+      require(rec.repeats == 6 && rec.rows.size() == res.rows.size(), "isolated runs observed");
+    }
+    // Concurrent runs: thread limits and arenas are per run, and the
+    // calling thread's OpenMP limit is restored afterwards
+    {
+#ifdef _OPENMP
+      const int omp_before = omp_get_max_threads();
+#endif
+      Session session;
+      std::vector<std::string> failures(4);
+      std::vector<RunResult> results(4);
+      std::vector<std::thread> workers;
+      for (int t = 0; t < 4; ++t)
+        workers.emplace_back([&, t] {
+          try {
+            CoreConfig cfg;
+            cfg.N = 50000;
+            cfg.repeats = 2;
+            cfg.threads = 1 + t % 2;
+            cfg.verify = true;
+            cfg.algos = {"std_sort", "std_sort_par", "gnu_parallel_sort"};
+            results[static_cast<std::size_t>(t)] = session.run(cfg);
+          } catch (const std::exception& e) {
+            failures[static_cast<std::size_t>(t)] = e.what();
+          }
+        });
+      for (auto& w : workers) w.join();
+      for (std::size_t t = 0; t < 4; ++t) {
+        require(failures[t].empty(), "concurrent run failed");
+        require(results[t].rows.size() == 3, "concurrent run rows");
+      }
+      CoreConfig one;
+      one.N = 1000;
+      one.threads = 1;
+      one.algos = {"std_sort"};
+      run_benchmark(one);
+#ifdef _OPENMP
+      require(omp_get_max_threads() == omp_before, "OpenMP thread limit restored");
+#endif
+    }
+    // Isolated runs fork, so they and other runs in the process exclude each other
+    {
+      struct Hold : Observer {
+        std::atomic<bool> started{false}, release{false};
+        void on_start(const std::vector<std::string>&) override {
+          started = true;
+          while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      };
+      CoreConfig plain;
+      plain.N = 1000;
+      plain.repeats = 1;
+      plain.algos = {"std_sort"};
+      CoreConfig iso = plain;
+      iso.isolate = true;
+      for (bool hold_isolated : {false, true}) {
+        Hold hold;
+        bool held_ok = false;
+        std::thread held([&] {
+          try {
+            held_ok = run_benchmark(hold_isolated ? iso : plain, &hold).rows[0].status == "ok";
+          } catch (const std::exception&) {
+          }
+        });
+        while (!hold.started) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        bool threw = false;
+        try { (void)run_benchmark(hold_isolated ? plain : iso); } catch (const std::exception&) { threw = true; }
+        hold.release = true;
+        held.join();
+        require(threw && held_ok, hold_isolated ? "runs refused during an isolated run"
+                                                : "isolation refused during another run");
+      }
+      require(run_benchmark(iso).rows[0].status == "ok", "isolation once the others finished");
+    }
+    // Cancellation: finished rows are kept, the rest are "canceled"
+    {
+      std::atomic<bool> stop{true};
+      CoreConfig cfg;
+      cfg.N = 100000;
+      cfg.repeats = 2;
+      cfg.algos = {"std_sort", "heap_sort", "timsort"};
+      cfg.cancel = &stop;
+      Session session;
+      auto early = session.run(cfg);
+      require(early.canceled && early.rows.size() == 3, "canceled during generation");
+      for (const auto& row : early.rows) require(row.status == "canceled", "no row finished");
+      stop = false;
+      auto meta_of = [](const RunResult& r, const std::string& k) {
+        for (const auto& kv : r.meta) if (kv.first == k) return kv.second;
+        return std::string();
+      };
+      require(meta_of(session.run(cfg), "session_dataset") == "miss", "partial input not kept");
+      struct StopAfterFirst : Observer {
+        std::atomic<bool>* stop;
+        void on_row(const ResultRow&) override { stop->store(true); }
+      };
+      for (bool iso : {false, true}) {
+        stop = false;
+        cfg.isolate = iso;
+        StopAfterFirst obs;
+        obs.stop = &stop;
+        auto res = run_benchmark(cfg, &obs);
+        require(res.canceled && res.rows.size() == 3, "canceled between algorithms");
+        require(res.rows[0].status == "ok" && res.rows[0].stats.median_ms > 0.0, "first row kept");
+        require(res.rows[1].status == "canceled" && res.rows[2].status == "canceled" &&
+                    res.rows[1].stats.median_ms == 0.0,
+                "later rows canceled");
+      }
+    }
+    // Input reset: a snapshot view restores the input after every run
+    {
+      require(parse_reset_mode("cow") == ResetMode::snapshot, "parse_reset_mode cow");
+      require(!parse_reset_mode("zero").has_value(), "parse_reset_mode rejects");
+      auto meta_of = [](const RunResult& r, const std::string& k) {
+        for (const auto& kv : r.meta) if (kv.first == k) return kv.second;
+        return std::string();
+      };
+      CoreConfig cfg;
+      cfg.N = 50000;
+      cfg.type = ElemType::u64;
+      cfg.repeats = 3;
+      cfg.warmup = 1;
+      cfg.verify = true;
+      cfg.assert_sorted = true;
+      cfg.algos = {"std_sort", "heap_sort"};
+      cfg.reset = ResetMode::snapshot;
+      auto res = run_benchmark(cfg);
+      require(res.rows.size() == 2, "snapshot reset rows");
+      require(meta_of(res, "reset") == "snapshot", "reset meta snapshot");
+      require(meta_of(res, "buffer_backing") == "snapshot", "snapshot backs the work buffer");
+      for (const auto& row : res.rows) require(row.reset_ms > 0.0, "reset_ms reported");
+      require(to_json(res).find("\"reset_ms\":") != std::string::npos, "json has reset_ms");
+      cfg.isolate = true;
+      res = run_benchmark(cfg);
+      for (const auto& row : res.rows) require(row.status == "ok", "snapshot reset isolated");
+      cfg.isolate = false;
+      cfg.reset = ResetMode::automatic; // small inputs never try the snapshot
+      require(meta_of(run_benchmark(cfg), "reset") == "copy", "auto reset copies small inputs");
+      for (Placement pl : {Placement::interleave, Placement::first_touch}) {
+        cfg.reset = ResetMode::parallel;
+        cfg.placement = pl;
+        res = run_benchmark(cfg);
+        require(res.rows.size() == 2, "parallel reset rows");
+        require(meta_of(res, "reset") == "parallel", "reset meta parallel");
+        require(meta_of(res, "placement") == std::string(placement_name(pl)), "placement meta");
+      }
+      cfg.reset = ResetMode::snapshot; // views are faulted in by one thread
+      bool threw = false;
+      try { (void)run_benchmark(cfg); } catch (const std::exception&) { threw = true; }
+      require(threw, "snapshot rejects first_touch placement");
+      cfg.placement = Placement::local;
+      cfg.type = ElemType::str;
+      cfg.N = 256;
+      require(meta_of(run_benchmark(cfg), "reset") == "copy", "strings always copy");
+    }
+    // Counter-based generator: same data at any thread count, seed-sensitive
+    {
+#ifdef _OPENMP
+      const int saved_threads = omp_get_max_threads();
+#endif
+      const std::size_t n = gen::kParallelMin * 4 + 17;
+      for (Dist d : {Dist::random, Dist::runs, Dist::gauss, Dist::exp, Dist::dups, Dist::partial}) {
+        CoreConfig cfg;
+#ifdef _OPENMP
+        omp_set_num_threads(1);
+#endif
+        auto a = gen::make_data<std::int64_t>(n, d, 42, 10, 100, cfg);
+#ifdef _OPENMP
+        omp_set_num_threads(4);
+#endif
+        auto b = gen::make_data<std::int64_t>(n, d, 42, 10, 100, cfg);
+        require(a == b, "generator independent of thread count");
+        if (d == Dist::runs)
+          require(std::is_sorted(a.begin(), a.begin() + 2048), "runs chunk sorted");
+        require(a != gen::make_data<std::int64_t>(n, d, 43, 10, 100, cfg), "seed changes data");
+      }
+      auto s1 = gen::make_data<std::string>(n, Dist::random, 7, 10, 100, CoreConfig{});
+      require(s1 == gen::make_data<std::string>(n, Dist::random, 7, 10, 100, CoreConfig{}),
+              "string generator deterministic");
+#ifdef _OPENMP
+      omp_set_num_threads(saved_threads);
+#endif
+    }
+    // zipf/organpipe/staggered/runs_ht honour their parameters
+    {
+      const std::size_t n = 100000;
+      CoreConfig cfg;
+      cfg.dup_values = 50;
+      cfg.zipf_s = 1.5;
+      auto z = gen::make_data<int>(n, Dist::zipf, 1, 10, cfg.dup_values, cfg);
+      std::vector<std::size_t> freq(50);
+      for (int x : z) {
+        require(x >= 0 && x < 50, "zipf value in range");
+        ++freq[static_cast<std::size_t>(x)];
+      }
+      require(freq[0] > freq[1] && freq[1] > freq[9] && freq[9] > freq[49], "zipf skewed");
+      // P(rank 1) = 1 / H(50, 1.5) ~ 0.4; a flat CDF would give ~0.02
+      require(freq[0] > n / 3 && freq[0] < n / 2, "zipf uses zipf_s");
+
+      auto o = gen::make_data<int>(n, Dist::organpipe, 1, 10, 100, cfg);
+      require(std::is_sorted(o.begin(), o.begin() + n / 2) &&
+                  std::is_sorted(o.rbegin(), o.rbegin() + n / 2),
+              "organpipe rises then falls");
+
+      cfg.stagger_block = 64;
+      auto st = gen::make_data<int>(64 * 500, Dist::staggered, 1, 10, 100, cfg);
+      require(st[1] - st[0] == 500 && st[64] == 1, "staggered uses stagger_block");
+      std::sort(st.begin(), st.end());
+      for (std::size_t i = 0; i < st.size(); ++i)
+        require(st[i] == static_cast<int>(i), "staggered is a permutation");
+
+      auto descents = [](const std::vector<int>& v) {
+        std::size_t d = 0;
+        for (std::size_t i = 1; i < v.size(); ++i) d += v[i] < v[i - 1];
+        return d;
+      };
+      cfg.runs_alpha = 3.0;
+      std::size_t short_runs = descents(gen::make_data<int>(n, Dist::runs_ht, 1, 10, 100, cfg));
+      cfg.runs_alpha = 0.8;
+      std::size_t long_runs = descents(gen::make_data<int>(n, Dist::runs_ht, 1, 10, 100, cfg));
+      require(short_runs > 0 && long_runs < short_runs, "runs_ht uses runs_alpha");
+    }
+    // Production-like shapes: sorted head + tail, bounded displacement,
+    // clusters, shuffled sorted blocks
+    {
+      const std::size_t n = 50000;
+      CoreConfig cfg;
+      auto tail = gen::make_data<int>(n, Dist::sorted_tail, 1, 10, 100, cfg);
+      require(std::is_sorted(tail.begin(), tail.begin() + 45000) &&
+                  !std::is_sorted(tail.begin() + 45000, tail.end()),
+              "sorted_tail keeps a sorted head");
+      cfg.displace_k = 8;
+      auto near = gen::make_data<int>(n, Dist::k_sorted, 1, 10, 100, cfg);
+      std::vector<std::size_t> pos(n);
+      std::iota(pos.begin(), pos.end(), 0);
+      std::stable_sort(pos.begin(), pos.end(), [&](std::size_t x, std::size_t y) { return near[x] < near[y]; });
+      std::size_t worst = 0;
+      for (std::size_t r = 0; r < n; ++r) worst = std::max(worst, r > pos[r] ? r - pos[r] : pos[r] - r);
+      require(worst > 0 && worst <= 8, "k_sorted displacement bounded by k");
+      cfg.clusters = 4;
+      auto cl = gen::make_data<double>(n, Dist::clustered, 1, 10, 100, cfg);
+      std::vector<int> bins(64, 0);
+      for (double x : cl) bins[static_cast<std::size_t>(std::min(x, 0.999) * 64)]++;
+      require(std::count(bins.begin(), bins.end(), 0) > 32, "clustered concentrates values");
+      cfg.shuffle_block = 1000;
+      auto blk = gen::make_data<int>(n, Dist::block_shuffled, 1, 10, 100, cfg);
+      for (std::size_t b = 0; b < n; b += 1000)
+        require(std::is_sorted(blk.begin() + static_cast<std::ptrdiff_t>(b),
+                               blk.begin() + static_cast<std::ptrdiff_t>(b + 1000)), "blocks sorted");
+      require(!std::is_sorted(blk.begin(), blk.end()), "blocks shuffled");
+      std::sort(blk.begin(), blk.end());
+      for (std::size_t i = 0; i < n; ++i) require(blk[i] == static_cast<int>(i), "block_shuffled is a permutation");
+    }
+    // Fingerprint verification: permutation-invariant, catches a changed
+    // element, and the parallel scan sees descents across chunk boundaries
+    {
+      std::vector<std::uint64_t> v(300000);
+      for (std::size_t i = 0; i < v.size(); ++i) v[i] = gen::mix64(i) % 1000;
+      const auto fp = verify::fingerprint<std::uint64_t>(v);
+      auto w = v;
+      std::sort(w.begin(), w.end());
+      require(verify::fingerprint<std::uint64_t>(w) == fp, "fingerprint ignores order");
+      require(verify::sorted<std::uint64_t>(w), "parallel sorted scan");
+      w[150000] += 1;
+      require(!(verify::fingerprint<std::uint64_t>(w) == fp), "fingerprint sees a changed element");
+      w[150000] -= 1;
+      std::swap(w[65535], w[65536 * 2]);
+      require(!verify::sorted<std::uint64_t>(w), "descent found");
+      CoreConfig cfg;
+      cfg.N = 20000;
+      cfg.repeats = 1;
+      cfg.verify = true;
+      cfg.verify_mode = VerifyMode::fingerprint;
+      cfg.type = ElemType::str;
+      auto res = run_benchmark(cfg);
+      bool tagged = false;
+      for (const auto& kv : res.meta) tagged |= kv.first == "verify" && kv.second == "fingerprint";
+      require(tagged && !res.rows.empty(), "fingerprint verify run");
+    }
+    // Dataset cache: miss stores, hit maps identical data, LRU keeps the budget
+    {
+      namespace fs = std::filesystem;
+      const fs::path dir = fs::temp_directory_path() / "sortbench_cache_test";
+      fs::remove_all(dir);
+      auto state = [](const RunResult& r) {
+        for (const auto& kv : r.meta) if (kv.first == "dataset_cache") return kv.second;
+        return std::string();
+      };
+      CoreConfig cfg;
+      cfg.N = 30000;
+      cfg.type = ElemType::u64;
+      cfg.dist = Dist::zipf;
+      cfg.repeats = 1;
+      cfg.verify = true;
+      cfg.algos = {"std_sort"};
+      cfg.cache_dir = dir.string();
+      require(state(run_benchmark(cfg)) == "miss", "first run misses");
+      require(state(run_benchmark(cfg)) == "hit", "second run hits");
+      cfg.isolate = true;
+      require(state(run_benchmark(cfg)) == "hit", "isolated run hits");
+      cfg.isolate = false;
+      cfg.zipf_s = 2.0;
+      require(state(run_benchmark(cfg)) == "miss", "dist params are part of the key");
+      // Two ~240KB files with a 300KB budget: the older one is evicted
+      cfg.cache_max_bytes = 300000;
+      cfg.seed = 5;
+      run_benchmark(cfg);
+      std::size_t files = 0;
+      for (const auto& de : fs::directory_iterator(dir)) files += de.path().extension() == ".sbd";
+      require(files == 1, "LRU eviction keeps the budget");
+      fs::remove_all(dir);
+    }
+    // Isolated execution: a hung algorithm becomes a timeout row, the rest run
+    {
+      CoreConfig cfg;
+      cfg.N = 40000;
+      cfg.repeats = 2;
+      cfg.verify = true;
+      cfg.algos = {"std_sort", "bubble_sort", "gnu_parallel_sort", "std_sort_par"};
+      cfg.algo_timeout_ms = 200;
+      auto res = run_benchmark(cfg);
+      require(res.rows.size() == 4, "isolated rows");
+      for (const auto& row : res.rows) {
+        if (row.algo == "bubble_sort")
+          require(row.status == "timeout" && !row.error.empty(), "bubble_sort timed out");
+        else
+          require(row.status == "ok" && row.stats.median_ms > 0.0, "isolated row ok");
+      }
+      const std::string csv = to_csv(res);
+      require(csv.rfind("algo,N,dist,median_ms,mean_ms,min_ms,max_ms,stddev_ms,status,error\n", 0) == 0,
+              "isolated csv has status columns");
+      require(csv.find("bubble_sort,40000,random,0.000,0.000,0.000,0.000,0.000,timeout,exceeded 200 ms\n") !=
+                  std::string::npos,
+              "csv keeps the timed-out row");
+      require(csv.find(",ok,\n") != std::string::npos, "csv marks ok rows");
+      require(to_jsonl(res).find("\"status\":\"timeout\"") != std::string::npos, "jsonl has status");
+      cfg.schedule = Schedule::round_robin;
+      bool threw = false;
+      try { run_benchmark(cfg); } catch (const std::exception&) { threw = true; }
+      require(threw, "isolation rejects interleaved schedule");
+    }
+    // Adversarial input: the oracle drives a first-element-pivot quicksort
+    // quadratic, and the killer sequence replays through the core
+    {
+      std::function<void(std::span<adversary::Item>)> naive_qs =
+          [&](std::span<adversary::Item> v) {
+            if (v.size() < 2) return;
+            std::size_t store = 1;
+            for (std::size_t i = 1; i < v.size(); ++i)
+              if (v[i] < v[0]) std::swap(v[i], v[store++]);
+            std::swap(v[0], v[store - 1]);
+            naive_qs(v.first(store - 1));
+            naive_qs(v.subspan(store));
+          };
+      const std::size_t n = 1000;
+      auto killer = adversary::build(n, naive_qs);
+      require(killer.comparisons >= n * (n - 1) / 2, "naive quicksort driven quadratic");
+      auto sorted = killer.ranks;
+      std::sort(sorted.begin(), sorted.end());
+      for (std::size_t i = 0; i < n; ++i) require(sorted[i] == i, "killer ranks are a permutation");
+      CoreConfig cfg;
+      cfg.N = 3000;
+      cfg.dist = Dist::adversarial;
+      cfg.repeats = 1;
+      cfg.verify = true;
+      cfg.algos = {"quicksort_hybrid", "std_sort"};
+      auto res = run_benchmark(cfg);
+      require(res.rows.size() == 2 && res.dist == "adversarial", "adversarial run");
+      bool tagged = false;
+      for (const auto& kv : res.meta) tagged |= kv.first == "adversary" && kv.second == "quicksort_hybrid";
+      require(tagged, "adversary target in meta");
+      cfg.type = ElemType::str;
+      require(run_benchmark(cfg).rows.size() == 2, "adversarial strings");
+      cfg.adversary = "radix_sort_lsd";
+      bool threw = false;
+      try { run_benchmark(cfg); } catch (const std::exception&) { threw = true; }
+      require(threw, "non-comparison target rejected");
+    }
+    // Input profile: runs, inversion ratio and distinct count track the shape
+    {
+      auto prof = [](const std::vector<int>& v) {
+        std::map<std::string, double> m;
+        for (const auto& [k, x] : analyze::profile<int>(std::span<const int>(v))) m[k] = std::stod(x);
+        return m;
+      };
+      std::vector<int> v(200000);
+      std::iota(v.begin(), v.end(), 0);
+      auto up = prof(v);
+      require(up["input_runs"] == 1 && up["input_inversion_ratio"] == 0.0 &&
+                  up["input_sorted_prefix"] == 200000, "sorted profile");
+      std::reverse(v.begin(), v.end());
+      auto down = prof(v);
+      require(down["input_runs"] == 200000 && down["input_inversion_ratio"] == 1.0, "reversed profile");
+      require(std::abs(down["input_distinct"] - 200000) < 200000 * 0.03, "hll distinct");
+      for (std::size_t i = 0; i < v.size(); ++i) v[i] = static_cast<int>(i % 100);
+      auto saw = prof(v);
+      require(std::abs(saw["input_distinct"] - 100) < 3 && saw["input_runs"] == 2000, "dups profile");
+      require(std::abs(saw["input_entropy_bits"] - std::log2(100.0)) < 0.1, "sample entropy");
+      CoreConfig cfg;
+      cfg.N = 5000;
+      cfg.repeats = 1;
+      cfg.algos = {"std_sort"};
+      cfg.analyze = true;
+      bool found = false;
+      for (const auto& kv : run_benchmark(cfg).meta) found |= kv.first == "input_inversion_ratio";
+      require(found, "profile in meta");
+    }
+    // File input: binary arrays (whole, sliced, sampled) and text lines
+    {
+      namespace fs = std::filesystem;
+      const fs::path bin = fs::temp_directory_path() / "sortbench_input_test.bin";
+      const fs::path txt = fs::temp_directory_path() / "sortbench_input_test.txt";
+      std::vector<std::int64_t> keys(5000);
+      for (std::size_t i = 0; i < keys.size(); ++i)
+        keys[i] = static_cast<std::int64_t>(gen::mix64(i) >> 1);
+      { std::ofstream(bin, std::ios::binary).write(reinterpret_cast<const char*>(keys.data()),
+                                                    static_cast<std::streamsize>(keys.size() * 8)); }
+      { std::ofstream(txt, std::ios::binary) << "pear\r\napple\n\nfig\nkiwi\n"; }
+      auto meta = [](const RunResult& r, const char* k) {
+        for (const auto& kv : r.meta) if (kv.first == k) return kv.second;
+        return std::string();
+      };
+      CoreConfig cfg;
+      cfg.N = 0;
+      cfg.type = ElemType::i64;
+      cfg.repeats = 1;
+      cfg.verify = true;
+      cfg.algos = {"std_sort"};
+      cfg.input_path = bin.string();
+      auto whole = run_benchmark(cfg);
+      require(whole.N == 5000 && whole.dist == "file", "file input sets N");
+      require(meta(whole, "input_hash").size() == 16, "input hash recorded");
+      cfg.N = 1000;
+      cfg.input_offset = 4000;
+      require(run_benchmark(cfg).rows[0].N == 1000, "sliced input");
+      cfg.input_offset = 4500;
+      bool threw = false;
+      try { run_benchmark(cfg); } catch (const std::exception&) { threw = true; }
+      require(threw, "slice past the end rejected");
+      cfg.input_offset = 0;
+      cfg.input_sample = true;
+      require(meta(run_benchmark(cfg), "input_sampled") == "yes", "sampled input");
+      const auto idx = input::sample_indices(100, 10, 3);
+      require(idx.size() == 10 && std::is_sorted(idx.begin(), idx.end()) &&
+                  std::adjacent_find(idx.begin(), idx.end()) == idx.end(),
+              "sample is distinct and ordered");
+      cfg.type = ElemType::u32; // 40000 bytes: 10000 elements
+      cfg.N = 0;
+      cfg.input_sample = false;
+      require(run_benchmark(cfg).N == 10000, "element size follows type");
+      const std::string text = "pear\r\napple\n\nfig\nkiwi\n";
+      const auto lines = input::split_lines(text.data(), text.size());
+      require((lines == std::vector<std::string>{"pear", "apple", "", "fig", "kiwi"}),
+              "text lines split");
+      cfg.type = ElemType::str;
+      cfg.input_path = txt.string();
+      require(run_benchmark(cfg).N == 5, "text input");
+      fs::remove(bin);
+      fs::remove(txt);
+    }
+    // Plugin ABI v3: harness scratch and declared capabilities reach the row
+    {
+      const std::vector<std::string> plugins = {"plugins/v3_merge.so"};
+      const auto names = list_algorithms(ElemType::f64, plugins);
+      require(std::count(names.begin(), names.end(), "v3_merge_sort") == 1, "v3 plugin listed");
+      CoreConfig cfg;
+      cfg.N = 5000;
+      cfg.type = ElemType::f64;
+      cfg.repeats = 2;
+      cfg.verify = true;
+      cfg.plugin_paths = plugins;
+      cfg.algos = {"v3_merge_sort", "v3_std_sort"};
+      auto r = run_benchmark(cfg);
+      require(r.rows.size() == 2 && r.rows[0].status == "ok", "v3 plugin runs");
+      require(r.rows[0].scratch_bytes == cfg.N * sizeof(double), "v3 scratch sized by the plugin");
+      require(r.rows[0].caps == "stable,strings" && r.rows[1].caps == "in_place", "v3 caps");
+      require(r.rows[1].scratch_bytes == 0, "in-place plugin gets no scratch");
+      require(to_jsonl(r, false).find("\"scratch_bytes\":40000") != std::string::npos,
+              "scratch in JSONL");
+      // Phases and counters reported through the sink, also from isolated children
+      for (bool isolate : {false, true}) {
+        cfg.isolate = isolate;
+        const auto row = run_benchmark(cfg).rows[0];
+        require(row.phase_ms.size() == 2 && row.phase_ms[0].first == "runs" &&
+                    row.phase_ms[1].first == "merge",
+                "v3 phases reported");
+        require(row.counters.size() == 1 && row.counters[0].first == "merge_passes" &&
+                    row.counters[0].second == 8,
+                "v3 counter median"); // 5000 / 32-element runs: 8 passes
+      }
+      cfg.isolate = false;
+      require(r.rows[1].phase_ms.empty() && r.rows[1].counters.empty(), "silent plugin reports nothing");
+      // Strings go through views into an arena, numbers through key/index pairs
+      cfg.type = ElemType::str;
+      cfg.algos = {"v3_merge_sort"};
+      r = run_benchmark(cfg);
+      require(r.rows.size() == 1 && r.rows[0].status == "ok", "v3 string plugin runs verified");
+      require(r.rows[0].scratch_bytes == cfg.N * (sizeof(const char*) + sizeof(std::size_t)),
+              "string scratch sized per view");
+      for (ElemType t : {ElemType::i32, ElemType::u64, ElemType::f32, ElemType::f64}) {
+        cfg.type = t;
+        cfg.dist = Dist::gauss;
+        cfg.algos = {"v3_kv_radix"};
+        r = run_benchmark(cfg);
+        require(r.rows.size() == 1 && r.rows[0].status == "ok", "v3 key/index plugin runs verified");
+      }
+      // A first-revision array (smaller struct_size) is walked by its own stride
+      const std::vector<std::string> rev1 = {"tests/plugin_v3_rev1.so"};
+      const auto old_names = list_algorithms(ElemType::i32, rev1);
+      require(std::count(old_names.begin(), old_names.end(), "rev1_a") == 1 &&
+                  std::count(old_names.begin(), old_names.end(), "rev1_b") == 1,
+              "every revision-1 entry listed");
+      cfg.type = ElemType::i32;
+      cfg.dist = Dist::random;
+      cfg.plugin_paths = rev1;
+      cfg.algos = {"rev1_a", "rev1_b"};
+      r = run_benchmark(cfg);
+      require(r.rows.size() == 2 && r.rows[1].status == "ok", "revision-1 entries run verified");
+    }
+    // Out-of-process plugins: a sortbench-plugin-host sorts the shared work memfd
+    {
+      setenv("SORTBENCH_PLUGIN_HOST", "./sortbench-plugin-host", 1);
+      const std::vector<std::string> isolated = {"plugins/v3_merge.so"};
+      auto meta_of = [](const RunResult& r, const std::string& k) {
+        for (const auto& kv : r.meta) if (kv.first == k) return kv.second;
+        return std::string();
+      };
+      const auto names = list_algorithms(ElemType::u64, {}, isolated);
+      require(std::count(names.begin(), names.end(), "v3_kv_radix") == 1, "hosted plugin listed");
+      CoreConfig cfg;
+      cfg.N = 5000;
+      cfg.type = ElemType::u64;
+      cfg.repeats = 2;
+      cfg.verify = true;
+      cfg.assert_sorted = true;
+      cfg.isolated_plugin_paths = isolated;
+      cfg.algos = {"std_sort", "v3_merge_sort", "v3_kv_radix"};
+      for (bool isolate : {false, true}) {
+        cfg.isolate = isolate;
+        const auto r = run_benchmark(cfg);
+        require(r.rows.size() == 3, "hosted rows");
+        for (const auto& row : r.rows) require(row.status == "ok", "hosted plugin verified");
+        require(meta_of(r, "buffer_backing") == "memfd" && meta_of(r, "plugin_host") == "yes",
+                "hosted work buffer is a shared memfd");
+        require(r.rows[1].caps == "stable,strings" && r.rows[1].counters.size() == 1 &&
+                    r.rows[1].counters[0].second == 8,
+                "hosted sink reports");
+      }
+      {
+        // Allocation counters are taken in the host, around the call itself
+        CoreConfig alloc_cfg;
+        alloc_cfg.N = 100000;
+        alloc_cfg.repeats = 1;
+        alloc_cfg.verify = true;
+        alloc_cfg.isolated_plugin_paths = {"tests/plugin_hosted.so"};
+        alloc_cfg.algos = {"hosted_alloc"};
+        const auto r = run_benchmark(alloc_cfg);
+        require(r.rows.size() == 1 && r.rows[0].status == "ok", "hosted allocating plugin");
+        if (meta_of(r, "alloc_hooks") == "yes")
+          require(r.rows[0].alloc_count >= 1 &&
+                      r.rows[0].peak_extra_bytes >= alloc_cfg.N * sizeof(int),
+                  "hosted rows report the host's allocations");
+
+        // A crash takes down only the host: the run fails with its signal and
+        // the session's next run starts a fresh one
+        Session session;
+        alloc_cfg.N = 1000;
+        alloc_cfg.algos = {"hosted_crash"};
+        std::string why;
+        try { (void)session.run(alloc_cfg); } catch (const std::exception& e) { why = e.what(); }
+        require(why.find("plugin host for 'tests/plugin_hosted.so' exited") != std::string::npos &&
+                    why.find("Segmentation fault") != std::string::npos,
+                "hosted crash fails the run with the host's signal");
+        alloc_cfg.algos = {"hosted_alloc"};
+        require(session.run(alloc_cfg).rows[0].status == "ok", "fresh host after a crash");
+
+        // Under isolation only the row fails, and the host is replaced before
+        // the next algorithm: a crashed one and a hung one alike
+        alloc_cfg.isolate = true;
+        alloc_cfg.algo_timeout_ms = 500;
+        alloc_cfg.algos = {"hosted_crash", "hosted_alloc", "hosted_hang"};
+        for (int round = 0; round < 2; ++round) {
+          const auto iso = session.run(alloc_cfg);
+          require(iso.rows.size() == 3, "isolated hosted rows");
+          for (const auto& row : iso.rows) {
+            if (row.algo == "hosted_crash")
+              require(row.status == "failed" && row.error.find("exited") != std::string::npos,
+                      "isolated hosted crash fails its row");
+            else if (row.algo == "hosted_hang")
+              require(row.status == "timeout", "isolated hosted hang times out");
+            else
+              require(row.status == "ok", "host replaced between isolated rows");
+          }
+        }
+        alloc_cfg.isolate = false;
+        alloc_cfg.algo_timeout_ms = 0;
+        alloc_cfg.algos = {"hosted_alloc"};
+        require(session.run(alloc_cfg).rows[0].status == "ok", "fresh host after a hang");
+      }
+      cfg.isolate = false;
+      cfg.reset = ResetMode::snapshot;
+      bool threw = false;
+      try { (void)run_benchmark(cfg); } catch (const std::exception&) { threw = true; }
+      require(threw, "snapshot reset rejected for hosted plugins");
+      cfg.reset = ResetMode::automatic;
+      cfg.type = ElemType::str;
+      threw = false;
+      try { (void)run_benchmark(cfg); } catch (const std::exception&) { threw = true; }
+      require(threw, "hosted plugins reject strings");
+    }
+    // Plugin build cache: hit on unchanged sources, miss when an include changes
+    {
+      namespace fs = std::filesystem;
+      const fs::path dir = fs::temp_directory_path() / "sortbench_build_test";
+      fs::remove_all(dir);
+      fs::create_directories(dir);
+      const fs::path src = dir / "wrapped.cpp";
+      std::ofstream(dir / "extra.h") << "// v1\n";
+      std::ofstream(src) << "#include \"extra.h\"\n#include \""
+                         << fs::absolute("plugins/v3_merge.cpp").string() << "\"\n";
+      PluginBuildOptions b;
+      b.source = src.string();
+      b.cache_dir = (dir / "cache").string();
+      b.variants = {IsaLevel::baseline};
+      const auto first = build_plugin(b);
+      require(first.variants.size() == 1 && !first.variants[0].cached, "first build compiles");
+      require(first.isa == IsaLevel::baseline && first.path == first.variants[0].path,
+              "baseline variant chosen");
+      const auto again = build_plugin(b);
+      require(again.variants[0].cached && again.path == first.path, "second build is a cache hit");
+      const auto names = list_algorithms(ElemType::i32, {again.path});
+      require(std::count(names.begin(), names.end(), "v3_merge_sort") == 1, "cached plugin loads");
+      // Loaders pick the best member of a <base>-<isa>.so family for this CPU
+      require(resolve_plugin_variant(first.path) == first.path, "lone variant resolves to itself");
+      fs::create_directories(dir / "fam");
+      const fs::path fam = dir / "fam" / "lib.so";
+      require(resolve_plugin_variant(fam.string()) == fam.string(), "no family: path unchanged");
+      fs::copy_file(first.path, fam);
+      fs::copy_file(first.path, dir / "fam" / "lib-baseline.so");
+      fs::copy_file(first.path, dir / "fam" / "lib-avx512.so");
+      const bool v4 = host_isa_level() == IsaLevel::avx512;
+      const fs::path best = dir / "fam" / (v4 ? "lib-avx512.so" : "lib-baseline.so");
+      require(resolve_plugin_variant(fam.string()) == best.string(), "family resolves to host level");
+      require(resolve_plugin_variant((dir / "fam" / "lib-avx512.so").string()) == best.string(),
+              "member name resolves within its family");
+      fs::remove(dir / "fam" / "lib-baseline.so");
+      const auto fam_names = list_algorithms(ElemType::i32, {fam.string()});
+      require(std::count(fam_names.begin(), fam_names.end(), "v3_merge_sort") == (v4 ? 1 : 0),
+              "a family with no runnable level is not loaded");
+      if (!v4) {
+        bool threw = false;
+        try {
+          (void)resolve_plugin_variant(fam.string());
+        } catch (const std::runtime_error &) {
+          threw = true;
+        }
+        require(threw, "unrunnable family throws");
+      }
+      std::ofstream(dir / "extra.h") << "// v2\n";
+      const auto edited = build_plugin(b);
+      require(!edited.variants[0].cached && edited.path != first.path, "include edit rebuilds");
+      // Headers found through the flags' -I directories count too
+      fs::create_directories(dir / "inc");
+      std::ofstream(dir / "inc" / "flagged.h") << "// v1\n";
+      std::ofstream(src, std::ios::app) << "#include \"flagged.h\"\n";
+      b.cxxflags = "-O2 -std=c++20 -I " + (dir / "inc").string();
+      require(!build_plugin(b).variants[0].cached && build_plugin(b).variants[0].cached,
+              "build with an -I directory cached");
+      std::ofstream(dir / "inc" / "flagged.h") << "// v2\n";
+      require(!build_plugin(b).variants[0].cached, "edit under an -I directory rebuilds");
+      for (IsaLevel l : {IsaLevel::baseline, IsaLevel::avx2, IsaLevel::avx512})
+        require(parse_isa_level(isa_level_name(l)) == l, "isa level names round-trip");
+      require(!parse_isa_level("sse9"), "unknown isa level");
+      fs::remove_all(dir);
+    }
+    // Built-ins and generator per instruction-set level: rows record the
+    // level, $SORTBENCH_ISA caps it, and generated data is the same at each
+    {
+      namespace fs = std::filesystem;
+      const fs::path dir = fs::temp_directory_path() / "sortbench_isa_test";
+      fs::remove_all(dir);
+      auto meta_of = [](const RunResult& r, const std::string& k) {
+        for (const auto& kv : r.meta) if (kv.first == k) return kv.second;
+        return std::string();
+      };
+      auto read_file = [](const fs::path& p) {
+        std::ifstream in(p, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), {});
+      };
+      auto dump = [&](IsaLevel l, ElemType t, Dist d) {
+        setenv("SORTBENCH_ISA", std::string(isa_level_name(l)).c_str(), 1);
+        CoreConfig cfg;
+        cfg.N = 50000;
+        cfg.type = t;
+        cfg.dist = d;
+        cfg.repeats = 1;
+        cfg.verify = true;
+        cfg.algos = {"std_sort", "timsort", "quicksort_hybrid", "merge_sort_opt"};
+        if (t == ElemType::u64) cfg.algos.push_back("radix_sort_lsd");
+        cfg.cache_dir = (dir / isa_level_name(l)).string();
+        const auto r = run_benchmark(cfg);
+        const std::string want(isa_level_name(std::min(l, host_isa_level())));
+        require(meta_of(r, "isa") == want, "meta isa is the capped level");
+        for (const auto& row : r.rows)
+          require(row.isa == (row.algo == "std_sort" ? "" : want), "rows record the isa path");
+        for (const auto& e : fs::directory_iterator(cfg.cache_dir))
+          return read_file(e.path());
+        return std::string();
+      };
+      for (ElemType t : {ElemType::u64, ElemType::f64})
+        for (Dist d : {Dist::gauss, Dist::clustered, Dist::random}) {
+          const std::string base = dump(IsaLevel::baseline, t, d);
+          require(!base.empty(), "dataset dumped");
+          for (IsaLevel l : {IsaLevel::avx2, IsaLevel::avx512})
+            require(dump(l, t, d) == base, "generator output independent of isa level");
+          fs::remove_all(dir);
+        }
+      setenv("SORTBENCH_ISA", "sse9", 1);
+      bool threw = false;
+      try { (void)run_benchmark(CoreConfig{}); } catch (const std::exception&) { threw = true; }
+      require(threw, "invalid SORTBENCH_ISA rejected");
+      unsetenv("SORTBENCH_ISA");
+      fs::remove_all(dir);
+    }
   } catch (const std::exception& e) {
     std::cerr << "Unhandled exception: " << e.what() << "\n";
     return 2;
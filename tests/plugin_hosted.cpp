@@ -0,0 +1,44 @@
+// Test plugin for sortbench-plugin-host: "hosted_alloc" sorts through a heap
+// copy, so its allocation counters must come back from the host;
+// "hosted_crash" takes its host down and "hosted_hang" never returns.
+
+#include "../sortbench_plugin.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void alloc_sort(int* data, size_t n, const sortbench_ctx_v3*) {
+  std::vector<int> copy(data, data + n);
+  std::sort(copy.begin(), copy.end());
+  std::copy(copy.begin(), copy.end(), data);
+}
+
+void crash_sort(int*, size_t, const sortbench_ctx_v3*) { std::raise(SIGSEGV); }
+
+void hang_sort(int*, size_t, const sortbench_ctx_v3*) {
+  for (;;) std::this_thread::sleep_for(std::chrono::seconds(1));
+}
+
+const sortbench_algo_v3 k_algos[] = {
+    {sizeof(sortbench_algo_v3), "hosted_alloc", 0, nullptr, nullptr,
+     &alloc_sort, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+    {sizeof(sortbench_algo_v3), "hosted_crash", 0, nullptr, nullptr,
+     &crash_sort, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+    {sizeof(sortbench_algo_v3), "hosted_hang", 0, nullptr, nullptr,
+     &hang_sort, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+};
+
+} // namespace
+
+extern "C" int sortbench_get_algorithms_v3(const sortbench_algo_v3** out_algos, size_t* out_count) {
+  if (!out_algos || !out_count) return 0;
+  *out_algos = k_algos;
+  *out_count = sizeof(k_algos) / sizeof(k_algos[0]);
+  return 1;
+}
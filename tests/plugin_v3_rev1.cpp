@@ -0,0 +1,43 @@
+// Test plugin: a v3 array laid out by the first revision of
+// sortbench_algo_v3 (no run_str/run_kv), as built against the old header.
+// The loader must step through it by struct_size, not by its own sizeof.
+
+#include "../sortbench_plugin.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace {
+
+struct algo_v3_rev1 {
+  size_t struct_size;
+  const char* name;
+  unsigned int caps;
+  void* user;
+  size_t (*scratch_bytes)(size_t n, size_t elem_size, void* user);
+  sortbench_run_i32_v3_fn run_i32;
+  sortbench_run_u32_v3_fn run_u32;
+  sortbench_run_i64_v3_fn run_i64;
+  sortbench_run_u64_v3_fn run_u64;
+  sortbench_run_f32_v3_fn run_f32;
+  sortbench_run_f64_v3_fn run_f64;
+};
+static_assert(sizeof(algo_v3_rev1) < sizeof(sortbench_algo_v3));
+
+void sort_i32(int* data, size_t n, const sortbench_ctx_v3*) { std::sort(data, data + n); }
+
+const algo_v3_rev1 k_algos[] = {
+    {sizeof(algo_v3_rev1), "rev1_a", SORTBENCH_CAP_IN_PLACE, nullptr, nullptr,
+     &sort_i32, nullptr, nullptr, nullptr, nullptr, nullptr},
+    {sizeof(algo_v3_rev1), "rev1_b", SORTBENCH_CAP_IN_PLACE, nullptr, nullptr,
+     &sort_i32, nullptr, nullptr, nullptr, nullptr, nullptr},
+};
+
+} // namespace
+
+extern "C" int sortbench_get_algorithms_v3(const sortbench_algo_v3** out_algos, size_t* out_count) {
+  if (!out_algos || !out_count) return 0;
+  *out_algos = reinterpret_cast<const sortbench_algo_v3*>(k_algos);
+  *out_count = sizeof(k_algos) / sizeof(k_algos[0]);
+  return 1;
+}